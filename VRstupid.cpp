@@ -1,9 +1,15 @@
 ﻿#include "vr_desktop_render.h"
 #include "rlgl.h"
+#include "stereo_scene.h"
+#include "stereo_renderer.h"
+#include "async_logger.h"
+#include "raymath.h"
+#include <algorithm>
 // NO windows.h include here!
 
 VRDesktopRenderer::VRDesktopRenderer()
-    : textureInitialized(false), maxUpdateRate(1.0f / 60.0f) {
+    : textureInitialized(false), maxUpdateRate(1.0f / 60.0f), streamingUploads(true),
+      nativeWidth(0), nativeHeight(0), panelDownscale(1), panelFootprint{ 0.0f, 0.0f }, contentRevision(0) {
     lastUpdate = std::chrono::steady_clock::now();
 }
 
@@ -19,18 +25,56 @@ void VRDesktopRenderer::initialize() {
 
     ScreenCapture::setCaptureRate(60.0f);
     textureInitialized = false;
+    if (!inputInjector.IsRunning() && !inputInjector.Start(CreateSystemInputBackend())) {
+        VR_LOG_WARN(LogChannel::Main, "No input injection backend, panel clicks are ignored");
+    }
     lastUpdate = std::chrono::steady_clock::now();
 }
 
 void VRDesktopRenderer::cleanup() {
+    if (retiringStreamer) {
+        retiringStreamer->Unload();
+        retiringStreamer.reset();
+        textureInitialized = false;
+    }
+    if (streamer) {
+        // The streamer owns the texture when it is active
+        streamer->Unload();
+        streamer.reset();
+        textureInitialized = false;
+    }
     if (textureInitialized) {
         UnloadTexture(desktopTexture);
         textureInitialized = false;
     }
+    inputInjector.Stop();
     ScreenCapture::cleanup();
 }
 
 void VRDesktopRenderer::update() {
+    // Copies issued by the streamer complete on the GPU timeline, so it is pumped every frame
+    if (streamer && streamer->IsReady()) {
+        auto start = std::chrono::steady_clock::now();
+        if (streamer->Update()) {
+            contentRevision++;
+        }
+        if (streamer->HasContent() && (!textureInitialized || desktopTexture.id != streamer->GetTextureId())) {
+            // The new ring has a frame, so only now does the panel switch textures
+            if (retiringStreamer) {
+                retiringStreamer->Unload();
+                retiringStreamer.reset();
+            }
+            else if (textureInitialized) {
+                UnloadTexture(desktopTexture);   // loaded by the synchronous path
+            }
+            desktopTexture = { streamer->GetTextureId(), streamer->GetWidth(), streamer->GetHeight(),
+                streamer->GetMipmapCount(), PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            textureInitialized = true;
+            contentRevision++;
+        }
+        addStall(start);
+    }
+
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration<float>(now - lastUpdate).count();
 
@@ -40,27 +84,169 @@ void VRDesktopRenderer::update() {
 
     auto frameOpt = ScreenCapture::getLatestFrame();
     if (frameOpt.has_value()) {
-        const auto& frame = frameOpt.value();
+        auto& frame = frameOpt.value();
 
         if (frame.isValid && !frame.pixels.empty()) {
-            Image desktopImage = {
-                .data = const_cast<void*>(static_cast<const void*>(frame.pixels.data())),
-                .width = frame.width,
-                .height = frame.height,
-                .mipmaps = 1,
-                .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
-            };
-
-            if (textureInitialized) {
-                UpdateTexture(desktopTexture, desktopImage.data);
+            nativeWidth = frame.width * frame.downscale;
+            nativeHeight = frame.height * frame.downscale;
+            uploadStats.frames++;
+            if (!streamingUploads || !uploadStreaming(std::move(frame))) {
+                uploadSynchronous(frame);
             }
-            else {
-                desktopTexture = LoadTextureFromImage(desktopImage);
-                textureInitialized = true;
+            lastUpdate = now;
+        }
+    }
+}
+
+void VRDesktopRenderer::uploadSynchronous(const CapturedFrame& frame) {
+    auto start = std::chrono::steady_clock::now();
+    Image desktopImage = {
+        .data = const_cast<void*>(static_cast<const void*>(frame.pixels.data())),
+        .width = frame.width,
+        .height = frame.height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+    };
+
+    if (textureInitialized && (desktopTexture.width != frame.width || desktopTexture.height != frame.height)) {
+        UnloadTexture(desktopTexture);
+        textureInitialized = false;
+    }
+
+    // Fallback path: the whole chain is regenerated on the GPU after every upload
+    if (textureInitialized) {
+        UpdateTexture(desktopTexture, desktopImage.data);
+        GenTextureMipmaps(&desktopTexture);
+    }
+    else {
+        desktopTexture = LoadTextureFromImage(desktopImage);
+        GenTextureMipmaps(&desktopTexture);
+        SetTextureFilter(desktopTexture, TEXTURE_FILTER_TRILINEAR);
+        textureInitialized = true;
+    }
+    uploadStats.uploads++;
+    uploadStats.uploadedBytes += frame.pixels.size();
+    contentRevision++;
+    addStall(start);
+}
+
+bool VRDesktopRenderer::uploadStreaming(CapturedFrame&& frame) {
+    auto start = std::chrono::steady_clock::now();
+
+    if (!streamer || !streamer->IsReady() || streamer->LevelForFrame(frame.width, frame.height, frame.downscale) < 0) {
+        // First frame or desktop resolution change: a new ring sized for the full desktop.
+        // A capture downscale change never gets here; the streamer fills a smaller mip level
+        // of the same texture. Whatever is on the panel stays there until the new ring has
+        // content (see update()).
+        if (streamer && textureInitialized && desktopTexture.id == streamer->GetTextureId()) {
+            retiringStreamer = std::move(streamer);
+        }
+        else if (streamer) {
+            streamer->Unload();   // never reached the panel
+        }
+        streamer = std::make_unique<TextureStreamer>();
+        if (!streamer->Init(frame.width * frame.downscale, frame.height * frame.downscale)) {
+            streamer.reset();
+            if (retiringStreamer) {
+                // The synchronous path loads a texture of its own
+                retiringStreamer->Unload();
+                retiringStreamer.reset();
+                textureInitialized = false;
+                contentRevision++;
             }
+            streamingUploads = false;
+            return false;
+        }
+    }
 
-            lastUpdate = now;
+    streamer->Submit(std::move(frame));
+    addStall(start);
+    return true;
+}
+
+void VRDesktopRenderer::addStall(std::chrono::steady_clock::time_point start) {
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    uploadStats.stallMs += ms;
+    if (ms > uploadStats.maxStallMs) uploadStats.maxStallMs = ms;
+}
+
+DesktopUploadStats VRDesktopRenderer::takeUploadStats() {
+    DesktopUploadStats result = uploadStats;
+    result.streaming = streamer && streamer->IsReady();
+    if (result.streaming) {
+        TextureStreamer::Stats streamStats = streamer->TakeStats();
+        result.uploads = streamStats.uploaded;
+        result.unchanged = streamStats.unchanged;
+        result.dropped = streamStats.dropped;
+        result.uploadedBytes = streamStats.uploadedBytes;
+        result.workerMs = streamStats.fillMs;
+    }
+    result.downscale = panelDownscale;
+    uploadStats = DesktopUploadStats();
+    return result;
+}
+
+void VRDesktopRenderer::updatePanelFootprint(const StereoEye eyes[2], int targetWidth, int targetHeight,
+    Vector3 panelPosition, Vector3 panelSize) {
+    if (nativeWidth <= 0 || nativeHeight <= 0) {
+        return;
+    }
+
+    // Corners in the same order renderDesktopPanel uses: top-left, top-right, bottom-right, bottom-left
+    Vector3 corners[4] = {
+        {panelPosition.x - panelSize.x / 2, panelPosition.y + panelSize.y / 2, panelPosition.z},
+        {panelPosition.x + panelSize.x / 2, panelPosition.y + panelSize.y / 2, panelPosition.z},
+        {panelPosition.x + panelSize.x / 2, panelPosition.y - panelSize.y / 2, panelPosition.z},
+        {panelPosition.x - panelSize.x / 2, panelPosition.y - panelSize.y / 2, panelPosition.z}
+    };
+
+    // Longest projected edge in each direction, in eye viewport pixels, over both eyes
+    Vector2 footprint = { 0.0f, 0.0f };
+    bool behindEye = false;
+    for (int eye = 0; eye < 2; eye++) {
+        Matrix vp = StereoEyeViewProjection(eyes[eye].camera, targetWidth, targetHeight);
+        Vector2 projected[4];
+        for (int i = 0; i < 4; i++) {
+            const Vector3& c = corners[i];
+            float w = vp.m3 * c.x + vp.m7 * c.y + vp.m11 * c.z + vp.m15;
+            if (w < 0.01f) {
+                behindEye = true;
+                break;
+            }
+            float x = (vp.m0 * c.x + vp.m4 * c.y + vp.m8 * c.z + vp.m12) / w;
+            float y = (vp.m1 * c.x + vp.m5 * c.y + vp.m9 * c.z + vp.m13) / w;
+            projected[i] = { x * 0.5f * eyes[eye].viewportWidth, y * 0.5f * eyes[eye].viewportHeight };
         }
+        if (behindEye) {
+            break;
+        }
+        footprint.x = std::max({ footprint.x, Vector2Distance(projected[0], projected[1]), Vector2Distance(projected[3], projected[2]) });
+        footprint.y = std::max({ footprint.y, Vector2Distance(projected[0], projected[3]), Vector2Distance(projected[1], projected[2]) });
+    }
+    panelFootprint = footprint;
+
+    // Largest divisor that still gives at least one texel per covered pixel; mipmaps handle the rest.
+    // A panel crossing the eye plane has no meaningful footprint, so it gets full resolution.
+    const int kMaxDownscale = 4;
+    int downscale = 1;
+    if (!behindEye) {
+        while (downscale < kMaxDownscale) {
+            int next = downscale * 2;
+            // Stepping down needs 25% headroom over what stepping back up needs, so the size does not flap
+            float margin = next > panelDownscale ? 1.25f : 1.0f;
+            if (nativeWidth / next < footprint.x * margin || nativeHeight / next < footprint.y * margin) {
+                break;
+            }
+            downscale = next;
+        }
+    }
+
+    if (downscale != panelDownscale) {
+        VR_LOG_INFO(LogChannel::Frame, "Desktop panel covers {}x{} px, capturing at 1/{} ({}x{})",
+            static_cast<int>(footprint.x), static_cast<int>(footprint.y), downscale,
+            nativeWidth / downscale, nativeHeight / downscale);
+        panelDownscale = downscale;
+        ScreenCapture::setDownscale(downscale);
     }
 }
 
@@ -91,6 +277,23 @@ void VRDesktopRenderer::renderDesktopPanel(Vector3 panelPosition, Vector3 panelS
     rlSetTexture(0);
 }
 
+void VRDesktopRenderer::appendDesktopPanel(StereoSceneBatch& batch, Vector3 panelPosition, Vector3 panelSize) const {
+    if (!textureInitialized) {
+        batch.Cube(panelPosition, panelSize.x, panelSize.y, 0.1f, GRAY);
+        batch.CubeWires(panelPosition, panelSize.x, panelSize.y, 0.1f, RED);
+        return;
+    }
+
+    Vector3 corners[4] = {
+        {panelPosition.x - panelSize.x / 2, panelPosition.y + panelSize.y / 2, panelPosition.z},
+        {panelPosition.x + panelSize.x / 2, panelPosition.y + panelSize.y / 2, panelPosition.z},
+        {panelPosition.x + panelSize.x / 2, panelPosition.y - panelSize.y / 2, panelPosition.z},
+        {panelPosition.x - panelSize.x / 2, panelPosition.y - panelSize.y / 2, panelPosition.z}
+    };
+    const Vector2 uvs[4] = { {1.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f} };
+    batch.TexturedQuad(corners, uvs, desktopTexture.id);
+}
+
 void VRDesktopRenderer::setMaxUpdateRate(float fps) {
     maxUpdateRate = 1.0f / fps;
 }
@@ -103,27 +306,27 @@ size_t VRDesktopRenderer::getQueueSize() const {
     return ScreenCapture::getQueueSize();
 }
 
-// VR Mouse interaction implementations - call our wrapper functions
+// VR Mouse interaction implementations - queued for the injector thread
 void VRDesktopRenderer::sendLeftClick(int x, int y) {
-    SendVRLeftClick(x, y);
+    inputInjector.Click(InputButton::Left, x, y);
 }
 
 void VRDesktopRenderer::sendRightClick(int x, int y) {
-    SendVRRightClick(x, y);
+    inputInjector.Click(InputButton::Right, x, y);
 }
 
 void VRDesktopRenderer::sendMouseMove(int x, int y) {
-    SendVRMouseMove(x, y);
+    inputInjector.MoveTo(x, y);
 }
 
 void VRDesktopRenderer::sendMousePosition(int x, int y) {
-    SendVRMousePosition(x, y);
+    inputInjector.MoveTo(x, y);
 }
 
 void VRDesktopRenderer::sendMouseDown(int x, int y) {
-    SendVRMouseDown(x, y);
+    inputInjector.ButtonDown(InputButton::Left, x, y);
 }
 
 void VRDesktopRenderer::sendMouseUp(int x, int y) {
-    SendVRMouseUp(x, y);
+    inputInjector.ButtonUp(InputButton::Left, x, y);
 }
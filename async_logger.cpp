@@ -0,0 +1,163 @@
+#include "async_logger.h"
+#include "thread_topology.h"
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+const char* kChannelFiles[] = {
+    "debug.log",
+    "gyro_debug.log",
+    "hand_error.log",
+    "frame_error.log",
+    "vr_mouse_clicks.log",
+};
+static_assert(sizeof(kChannelFiles) / sizeof(kChannelFiles[0]) == static_cast<size_t>(LogChannel::Count),
+    "every log channel needs a file");
+
+const char* kLevelNames[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+
+constexpr auto kFlushInterval = std::chrono::milliseconds(10);
+
+template<typename T>
+void AppendNumber(std::string& out, T value) {
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    if (ec == std::errc()) {
+        out.append(buf, end);
+    }
+}
+
+} // namespace
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger() {
+    // Constructed first so it outlives the logger, whose thread unregisters on the way out
+    ThreadTopology::instance();
+    startNs_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+AsyncLogger::~AsyncLogger() {
+    stop();
+}
+
+void AsyncLogger::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) return;
+    worker_ = std::thread(&AsyncLogger::run, this);
+}
+
+void AsyncLogger::stop() {
+    if (!running_.exchange(false)) return;
+    wake_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void AsyncLogger::registerThread() {
+    threadRing();
+}
+
+LogRing& AsyncLogger::threadRing() {
+    thread_local std::shared_ptr<LogRing> ring;
+    if (!ring) {
+        ring = std::make_shared<LogRing>();
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.push_back(ring);
+    }
+    return *ring;
+}
+
+void AsyncLogger::run() {
+    ThreadTopology::Scope threadScope("logger");
+    std::string buffers[static_cast<size_t>(LogChannel::Count)];
+    for (auto& buffer : buffers) {
+        buffer.reserve(64 * 1024);
+    }
+    // Opened lazily on a channel's first record, so unused channels leave no file
+    std::ofstream files[static_cast<size_t>(LogChannel::Count)];
+
+    while (running_) {
+        drainOnce(buffers, files);
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait_for(lock, kFlushInterval, [this] { return !running_; });
+    }
+
+    // Producers may still have records in flight at shutdown
+    while (drainOnce(buffers, files) > 0) {
+    }
+}
+
+size_t AsyncLogger::drainOnce(std::string* buffers, std::ofstream* files) {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings = rings_;
+    }
+
+    size_t total = 0;
+    LogRecord record;
+    for (auto& ring : rings) {
+        while (ring->tryPop(record)) {
+            formatRecord(record, buffers[static_cast<size_t>(record.channel)]);
+            total++;
+        }
+        if (uint64_t dropped = ring->takeDropped()) {
+            std::string& out = buffers[static_cast<size_t>(LogChannel::Main)];
+            out += "[WARN] logger dropped ";
+            AppendNumber(out, dropped);
+            out += " records (ring full)\n";
+        }
+    }
+
+    // One write and flush per channel file per batch, so the files can be tailed
+    for (size_t i = 0; i < static_cast<size_t>(LogChannel::Count); i++) {
+        if (buffers[i].empty()) continue;
+        std::ofstream& file = files[i];
+        if (!file.is_open()) {
+            file.open(kChannelFiles[i], std::ios::app | std::ios::binary);
+        }
+        file.write(buffers[i].data(), static_cast<std::streamsize>(buffers[i].size()));
+        file.flush();
+        file.clear();  // a failed write (e.g. disk full) must not silence later batches
+        buffers[i].clear();
+    }
+    return total;
+}
+
+void AsyncLogger::formatRecord(const LogRecord& record, std::string& out) const {
+    double seconds = static_cast<double>(record.timestampNs - startNs_) / 1e9;
+    char stamp[32];
+    int n = snprintf(stamp, sizeof(stamp), "%.6f ", seconds);
+    if (n > 0) out.append(stamp, static_cast<size_t>(n));
+
+    out += '[';
+    out += kLevelNames[static_cast<size_t>(record.level)];
+    out += "] ";
+
+    uint8_t arg = 0;
+    for (const char* p = record.format; *p; p++) {
+        if (p[0] == '{' && p[1] == '}' && arg < record.argCount) {
+            const LogRecord::Value& value = record.values[arg];
+            switch (record.types[arg]) {
+            case LogRecord::ArgType::Int:   AppendNumber(out, value.i); break;
+            case LogRecord::ArgType::UInt:  AppendNumber(out, value.u); break;
+            case LogRecord::ArgType::Float: AppendNumber(out, value.f); break;
+            case LogRecord::ArgType::Text:  out.append(record.text + value.text.offset, value.text.length); break;
+            }
+            arg++;
+            p++;
+        }
+        else {
+            out += *p;
+        }
+    }
+    out += '\n';
+}
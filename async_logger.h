@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4
+};
+
+// Each channel is written to its own file by the background thread
+enum class LogChannel : uint8_t {
+    Main,       // debug.log
+    Gyro,       // gyro_debug.log
+    Hand,       // hand_error.log
+    Frame,      // frame_error.log
+    Mouse,      // vr_mouse_clicks.log
+    Count
+};
+
+// Levels below this are compiled out entirely (arguments are not even evaluated)
+#ifndef VR_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define VR_LOG_MIN_LEVEL 2
+#else
+#define VR_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+/**
+ * Fixed-size binary log record. The format string must be a string literal; it is
+ * stored as a pointer and expanded ("{}" per argument) on the logger thread.
+ * Text arguments are copied into the record and truncated to fit.
+ */
+struct LogRecord {
+    static constexpr size_t kMaxArgs = 6;
+    static constexpr size_t kTextSize = 48;
+
+    enum class ArgType : uint8_t { Int, UInt, Float, Text };
+
+    uint64_t timestampNs;
+    const char* format;
+    LogLevel level;
+    LogChannel channel;
+    uint8_t argCount;
+    uint8_t textUsed;
+    ArgType types[kMaxArgs];
+    union Value {
+        int64_t i;
+        uint64_t u;
+        double f;
+        struct { uint8_t offset; uint8_t length; } text;
+    } values[kMaxArgs];
+    char text[kTextSize];
+};
+
+/**
+ * Single-producer/single-consumer ring owned by one logging thread. Full rings drop
+ * records instead of blocking the producer.
+ */
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+    bool tryPush(const LogRecord& record) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t next = (head + 1) % kCapacity;
+        if (next == tail_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        records_[head] = record;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(LogRecord& record) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = records_[tail];
+        tail_.store((tail + 1) % kCapacity, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t takeDropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::array<LogRecord, kCapacity> records_;
+    std::atomic<size_t> head_{ 0 };
+    std::atomic<size_t> tail_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+};
+
+/**
+ * Asynchronous logger: producers copy a LogRecord into their thread's ring (no locks,
+ * no allocation after the thread's first record) and one background thread formats
+ * and appends them to the channel files in batches. The files are opened once and
+ * stay open for the life of that thread.
+ */
+class AsyncLogger {
+public:
+    static AsyncLogger& instance();
+
+    void start();
+    void stop();   // drains every ring and flushes
+
+    // Allocates the calling thread's ring up front so its first log call is cheap
+    void registerThread();
+
+    template<typename... Args>
+    void write(LogLevel level, LogChannel channel, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        LogRecord record;
+        record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        record.format = format;
+        record.level = level;
+        record.channel = channel;
+        record.argCount = 0;
+        record.textUsed = 0;
+        (encodeArg(record, args), ...);
+        threadRing().tryPush(record);
+    }
+
+private:
+    AsyncLogger();
+    ~AsyncLogger();
+
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    std::mutex ringsMutex_;
+    std::thread worker_;
+    std::atomic<bool> running_{ false };
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    uint64_t startNs_;
+
+    LogRing& threadRing();
+    void run();
+    size_t drainOnce(std::string* buffers, std::ofstream* files);
+    void formatRecord(const LogRecord& record, std::string& out) const;
+
+    template<typename T>
+    static void encodeArg(LogRecord& record, const T& value) {
+        uint8_t i = record.argCount++;
+        if constexpr (std::is_same_v<T, bool>) {
+            record.types[i] = LogRecord::ArgType::Int;
+            record.values[i].i = value ? 1 : 0;
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            record.types[i] = LogRecord::ArgType::Float;
+            record.values[i].f = static_cast<double>(value);
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            record.types[i] = LogRecord::ArgType::Int;
+            record.values[i].i = static_cast<int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            record.types[i] = LogRecord::ArgType::UInt;
+            record.values[i].u = static_cast<uint64_t>(value);
+        }
+        else {
+            encodeText(record, i, std::string_view(value));
+        }
+    }
+
+    static void encodeText(LogRecord& record, uint8_t i, std::string_view text) {
+        size_t room = LogRecord::kTextSize - record.textUsed;
+        size_t length = text.size() < room ? text.size() : room;
+        record.types[i] = LogRecord::ArgType::Text;
+        record.values[i].text.offset = record.textUsed;
+        record.values[i].text.length = static_cast<uint8_t>(length);
+        memcpy(record.text + record.textUsed, text.data(), length);
+        record.textUsed = static_cast<uint8_t>(record.textUsed + length);
+    }
+};
+
+#define VR_LOG(level, channel, ...)                                                      \
+    do {                                                                                 \
+        if constexpr (static_cast<int>(level) >= VR_LOG_MIN_LEVEL) {                     \
+            AsyncLogger::instance().write(level, channel, __VA_ARGS__);                  \
+        }                                                                                \
+    } while (0)
+
+#define VR_LOG_TRACE(channel, ...) VR_LOG(LogLevel::Trace, channel, __VA_ARGS__)
+#define VR_LOG_DEBUG(channel, ...) VR_LOG(LogLevel::Debug, channel, __VA_ARGS__)
+#define VR_LOG_INFO(channel, ...)  VR_LOG(LogLevel::Info, channel, __VA_ARGS__)
+#define VR_LOG_WARN(channel, ...)  VR_LOG(LogLevel::Warn, channel, __VA_ARGS__)
+#define VR_LOG_ERROR(channel, ...) VR_LOG(LogLevel::Error, channel, __VA_ARGS__)
@@ -0,0 +1,158 @@
+#include "control_channel.h"
+#include "async_logger.h"
+#include <charconv>
+#include <cstdio>
+
+namespace {
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Splits off the first whitespace-separated word
+std::string_view NextWord(std::string_view& text) {
+    text = Trim(text);
+    size_t end = 0;
+    while (end < text.size() && !IsSpace(text[end])) end++;
+    std::string_view word = text.substr(0, end);
+    text = Trim(text.substr(end));
+    return word;
+}
+
+template<typename T>
+bool ParseNumber(std::string_view text, T& value) {
+    auto [next, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && next == text.data() + text.size();
+}
+
+std::string FormatFloat(float value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%g", value);
+    return text;
+}
+
+} // namespace
+
+void ControlChannel::AddParameter(const std::string& name, const std::string& description, Getter get, Setter set) {
+    parameters.push_back({ name, description, std::move(get), std::move(set) });
+}
+
+void ControlChannel::AddInt(const std::string& name, const std::string& description, int minValue, int maxValue,
+    std::function<int()> get, std::function<void(int)> set) {
+    AddParameter(name, description + " [" + std::to_string(minValue) + ".." + std::to_string(maxValue) + "]",
+        [get] { return std::to_string(get()); },
+        [set, minValue, maxValue](std::string_view text) {
+            int value = 0;
+            if (!ParseNumber(text, value) || value < minValue || value > maxValue) return false;
+            set(value);
+            return true;
+        });
+}
+
+void ControlChannel::AddFloat(const std::string& name, const std::string& description, float minValue, float maxValue,
+    std::function<float()> get, std::function<void(float)> set) {
+    AddParameter(name, description + " [" + FormatFloat(minValue) + ".." + FormatFloat(maxValue) + "]",
+        [get] { return FormatFloat(get()); },
+        [set, minValue, maxValue](std::string_view text) {
+            float value = 0.0f;
+            if (!ParseNumber(text, value) || !(value >= minValue && value <= maxValue)) return false;
+            set(value);
+            return true;
+        });
+}
+
+void ControlChannel::Submit(std::string_view line) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queued.size() >= kMaxQueued) {
+        stats.dropped++;
+        return;
+    }
+    queued.emplace_back(line);
+}
+
+size_t ControlChannel::Poll(const ReplyHandler& reply) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queued.empty()) return 0;
+        running.swap(queued);
+    }
+    for (const auto& line : running) {
+        std::string result = Execute(line);
+        VR_LOG_INFO(LogChannel::Main, "Control: {} -> {}", line, result);
+        if (reply) {
+            reply(result);
+        }
+    }
+    size_t count = running.size();
+    running.clear();
+    return count;
+}
+
+std::string ControlChannel::Execute(std::string_view line) {
+    std::string_view rest = line;
+    std::string_view command = NextWord(rest);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.commands++;
+    }
+
+    std::string result;
+    bool ok = true;
+    if (command == "list") {
+        for (const auto& parameter : parameters) {
+            if (!result.empty()) result += '\n';
+            result += parameter.name + "=" + parameter.get() + "  # " + parameter.description;
+        }
+    }
+    else if (command == "get" || command == "set") {
+        std::string_view name = NextWord(rest);
+        Parameter* parameter = Find(name);
+        if (!parameter) {
+            ok = false;
+            result = "error unknown parameter " + std::string(name);
+        }
+        else if (command == "get") {
+            result = parameter->name + "=" + parameter->get();
+        }
+        else if (rest.empty() || !parameter->set(rest)) {
+            ok = false;
+            result = "error invalid value for " + parameter->name + ": " + parameter->description;
+        }
+        else {
+            result = "ok " + parameter->name + "=" + parameter->get();
+        }
+    }
+    else {
+        ok = false;
+        result = "error unknown command " + std::string(command) + " (list, get, set)";
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ok) {
+        stats.rejected++;
+    }
+    else if (command == "set") {
+        stats.changes++;
+    }
+    return result;
+}
+
+ControlChannel::Parameter* ControlChannel::Find(std::string_view name) {
+    for (auto& parameter : parameters) {
+        if (parameter.name == name) return &parameter;
+    }
+    return nullptr;
+}
+
+ControlChannel::Stats ControlChannel::TakeStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
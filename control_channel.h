@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Runtime tuning of named pipeline parameters. Command lines arrive on any
+ * thread (the gyro stdin stream carries them as '!' lines) and are only queued;
+ * Poll runs them on the thread that owns the pipeline, between two frames, so
+ * a setter hands its value to its stage at a frame boundary. Stages running on
+ * other threads take values through their own atomics.
+ *
+ * Commands, one per line:
+ *   list                   every parameter with its value and description
+ *   get <name>             current value
+ *   set <name> <value>     validates, applies and echoes the new value
+ */
+class ControlChannel {
+public:
+    using Getter = std::function<std::string()>;
+    // Returns false to reject the value; it is then left unchanged
+    using Setter = std::function<bool(std::string_view value)>;
+    using ReplyHandler = std::function<void(const std::string& reply)>;
+
+    static constexpr size_t kMaxQueued = 64;
+
+    struct Stats {
+        uint64_t commands = 0;
+        uint64_t changes = 0;
+        uint64_t rejected = 0;  // unknown command or parameter, or a value out of range
+        uint64_t dropped = 0;   // arrived while kMaxQueued commands were waiting
+    };
+
+    // Registration happens before commands can arrive, on the owning thread
+    void AddParameter(const std::string& name, const std::string& description, Getter get, Setter set);
+    // Integer and float parameters with an inclusive range
+    void AddInt(const std::string& name, const std::string& description, int minValue, int maxValue,
+        std::function<int()> get, std::function<void(int)> set);
+    void AddFloat(const std::string& name, const std::string& description, float minValue, float maxValue,
+        std::function<float()> get, std::function<void(float)> set);
+
+    // Any thread
+    void Submit(std::string_view line);
+
+    // Owning thread: runs every queued command; returns how many ran
+    size_t Poll(const ReplyHandler& reply);
+
+    Stats TakeStats();
+
+private:
+    struct Parameter {
+        std::string name;
+        std::string description;
+        Getter get;
+        Setter set;
+    };
+
+    std::vector<Parameter> parameters;
+    std::mutex mutex;
+    std::vector<std::string> queued;
+    std::vector<std::string> running;
+    Stats stats;
+
+    std::string Execute(std::string_view line);
+    Parameter* Find(std::string_view name);
+};
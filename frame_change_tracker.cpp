@@ -0,0 +1,54 @@
+#include "frame_change_tracker.h"
+#include "raymath.h"
+
+FrameChangeTracker::FrameChangeTracker() {
+    last = {};
+    valid = false;
+    enabled = true;
+    keepAlive = std::chrono::milliseconds(1000);
+    positionThreshold = 0.0001f;     // 0.1 mm
+    angleThreshold = 0.0002f;        // ~0.01 degrees, well under a pixel at 90 degrees fov
+    stats = Stats();
+}
+
+bool FrameChangeTracker::CameraMoved(const Camera3D& a, const Camera3D& b) const {
+    if (Vector3Distance(a.position, b.position) > positionThreshold) return true;
+    if (a.fovy != b.fovy) return true;
+
+    // Angle between the view directions, and between the up vectors for roll
+    Vector3 forwardA = Vector3Normalize(Vector3Subtract(a.target, a.position));
+    Vector3 forwardB = Vector3Normalize(Vector3Subtract(b.target, b.position));
+    if (Vector3Angle(forwardA, forwardB) > angleThreshold) return true;
+    return Vector3Angle(a.up, b.up) > angleThreshold;
+}
+
+FrameChangeTracker::Decision FrameChangeTracker::Evaluate(const Inputs& inputs, Clock::time_point now) {
+    bool changed = !enabled || !valid ||
+        inputs.handRevision != last.handRevision ||
+        inputs.desktopRevision != last.desktopRevision ||
+        inputs.panelRevision != last.panelRevision ||
+        CameraMoved(inputs.leftEye, last.leftEye) ||
+        CameraMoved(inputs.rightEye, last.rightEye);
+
+    if (changed) {
+        // Small drifts accumulate against the last rendered pose, so a slow turn still renders
+        last = inputs;
+        valid = true;
+        lastOutput = now;
+        stats.rendered++;
+        return Decision::Render;
+    }
+    if (keepAlive.count() > 0 && now - lastOutput >= keepAlive) {
+        lastOutput = now;
+        stats.keepAlives++;
+        return Decision::KeepAlive;
+    }
+    stats.skipped++;
+    return Decision::Skip;
+}
+
+FrameChangeTracker::Stats FrameChangeTracker::TakeStats() {
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "raylib.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Decides whether the main loop needs to render, read back and encode a new frame.
+ * Every frame input that can change the picture is summarised in Inputs; when none
+ * of them moved past the thresholds since the last frame that went out, the frame
+ * is skipped. A keep-alive interval bounds how long the stream can stay silent.
+ */
+class FrameChangeTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Inputs {
+        Camera3D leftEye;
+        Camera3D rightEye;
+        uint64_t handRevision;      // Player::GetHandRevision
+        uint64_t desktopRevision;   // VRDesktopRenderer::getContentRevision
+        uint64_t panelRevision;     // Player::GetPanelRevision
+    };
+
+    enum class Decision {
+        Render,      // something changed
+        KeepAlive,   // nothing changed, but the keep-alive interval ran out
+        Skip         // nothing changed
+    };
+
+    struct Stats {
+        uint64_t rendered = 0;
+        uint64_t keepAlives = 0;
+        uint64_t skipped = 0;
+    };
+
+    FrameChangeTracker();
+
+    Decision Evaluate(const Inputs& inputs, Clock::time_point now);
+    // Forces the next Evaluate to render, e.g. after the output was reset
+    void Invalidate() { valid = false; }
+
+    // Configuration
+    void SetEnabled(bool enabled) { this->enabled = enabled; }
+    bool IsEnabled() const { return enabled; }
+    void SetKeepAlive(std::chrono::milliseconds interval) { keepAlive = interval; }
+    std::chrono::milliseconds GetKeepAlive() const { return keepAlive; }
+    // Smallest camera movement (meters) and rotation (radians) that counts as a change
+    void SetPoseThresholds(float meters, float radians) { positionThreshold = meters; angleThreshold = radians; }
+
+    Stats TakeStats();
+
+private:
+    Inputs last;        // inputs of the last frame that was rendered
+    bool valid;
+    bool enabled;
+    Clock::time_point lastOutput;
+    std::chrono::milliseconds keepAlive;
+    float positionThreshold;
+    float angleThreshold;
+    Stats stats;
+
+    bool CameraMoved(const Camera3D& a, const Camera3D& b) const;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Header in front of every frame on stdout and on stream server sockets; layout matches
+// the Python consumer
+struct FrameHeader {
+    uint32_t magic = 0xDEADBEEF;
+    uint32_t timestamp_ms;
+    uint32_t frame_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixel_format;  // 0=RGBA, 1=RGB, 2=H264, 3=repeat previous frame (no payload),
+                            // 4=control reply (UTF-8 text, only sent in answer to a '!' command)
+};
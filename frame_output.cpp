@@ -0,0 +1,62 @@
+#include "frame_output.h"
+#include "frame_header.h"
+#include "async_logger.h"
+#include <chrono>
+
+uint32_t GetCurrentTimeMs() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<milliseconds>(high_resolution_clock::now().time_since_epoch()).count());
+}
+
+bool SendH264Frame(std::ostream& out, const std::vector<uint8_t>& frameData, int width, int height) {
+    try {
+        FrameHeader header;
+        header.timestamp_ms = GetCurrentTimeMs();
+        header.frame_size = static_cast<uint32_t>(frameData.size());
+        header.width = static_cast<uint32_t>(width);
+        header.height = static_cast<uint32_t>(height);
+        header.pixel_format = 2;  // H264 format
+
+        // Write header
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out.good()) return false;
+
+        // Write frame data
+        out.write(reinterpret_cast<const char*>(frameData.data()), frameData.size());
+        if (!out.good()) return false;
+
+        out.flush();
+        return out.good();
+    }
+    catch (const std::exception& e) {
+        VR_LOG_ERROR(LogChannel::Frame, "Error sending H.264 frame: {}", e.what());
+        return false;
+    }
+}
+
+bool SendRepeatMarker(std::ostream& out, int width, int height) {
+    FrameHeader header;
+    header.timestamp_ms = GetCurrentTimeMs();
+    header.frame_size = 0;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.pixel_format = 3;  // repeat previous frame
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.flush();
+    return out.good();
+}
+
+bool SendControlReply(std::ostream& out, const std::string& text) {
+    FrameHeader header;
+    header.timestamp_ms = GetCurrentTimeMs();
+    header.frame_size = static_cast<uint32_t>(text.size());
+    header.width = 0;
+    header.height = 0;
+    header.pixel_format = 4;  // control reply
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(text.data(), text.size());
+    out.flush();
+    return out.good();
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Writers for the FrameHeader records on stdout. They take the stream so the
+// same code can be pointed at a pipe or a file outside the main program.
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+uint32_t GetCurrentTimeMs();
+
+// Each writes one record and flushes; false once the stream has failed
+bool SendH264Frame(std::ostream& out, const std::vector<uint8_t>& frameData, int width, int height);
+bool SendRepeatMarker(std::ostream& out, int width, int height);
+bool SendControlReply(std::ostream& out, const std::string& text);
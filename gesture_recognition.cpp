@@ -1,59 +1,195 @@
 #include "gesture_recognition.h"
+#include "gesture_templates.h"
 #include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <raymath.h>
+#include <chrono>
+
+namespace {
+
+const int kFingerBase[HandFeatures::kFingers] = { 1, 5, 9, 13, 17 };
+const int kFingerTip[HandFeatures::kFingers] = { 4, 8, 12, 16, 20 };
+const float kMaxFingerLength = 0.09f; // Approximate max finger length
+const int kBatchHands = 8;              // hands measured per vector pass
+
+} // namespace
+
+void ComputeHandFeatures(const HandLandmarks& hand, HandFeatures& features) {
+    ComputeHandFeatures(std::span<const HandLandmarks>(&hand, 1), std::span<HandFeatures>(&features, 1));
+}
+
+void ComputeHandFeatures(std::span<const HandLandmarks> hands, std::span<HandFeatures> features) {
+    constexpr int fingers = HandFeatures::kFingers;
+    constexpr int maxLanes = kBatchHands * fingers;
+
+    for (size_t first = 0; first < hands.size(); first += kBatchHands) {
+        int count = static_cast<int>(std::min<size_t>(kBatchHands, hands.size() - first));
+        // Round up to whole 8-float vectors; padding lanes measure nothing
+        int lanes = (count * fingers + 7) & ~7;
+
+        // Gather every finger of every hand into structure-of-arrays; lane = hand * 5 + finger
+        alignas(32) float bx[maxLanes], by[maxLanes], bz[maxLanes];
+        alignas(32) float tx[maxLanes], ty[maxLanes], tz[maxLanes];
+        alignas(32) float wx[maxLanes], wy[maxLanes], wz[maxLanes];
+        alignas(32) float mask[maxLanes];
+        for (int i = 0; i < lanes; i++) {
+            int h = i / fingers;
+            int f = i % fingers;
+            if (h >= count) {
+                bx[i] = by[i] = bz[i] = tx[i] = ty[i] = tz[i] = wx[i] = wy[i] = wz[i] = mask[i] = 0.0f;
+                continue;
+            }
+            const HandLandmarks& hand = hands[first + h];
+            Vector3 base = hand.landmarks[kFingerBase[f]];
+            Vector3 tip = hand.landmarks[kFingerTip[f]];
+            Vector3 wrist = hand.landmarks[0];
+            bx[i] = base.x; by[i] = base.y; bz[i] = base.z;
+            tx[i] = tip.x; ty[i] = tip.y; tz[i] = tip.z;
+            wx[i] = wrist.x; wy[i] = wrist.y; wz[i] = wrist.z;
+            mask[i] = (hand.active[kFingerBase[f]] && hand.active[kFingerTip[f]]) ? 1.0f : 0.0f;
+        }
+
+        // Branch-free loops so the compiler emits one vector pass per quantity
+        alignas(32) float baseToTip[maxLanes], wristToTip[maxLanes], extension[maxLanes];
+        for (int i = 0; i < lanes; i++) {
+            float dx = tx[i] - bx[i], dy = ty[i] - by[i], dz = tz[i] - bz[i];
+            baseToTip[i] = sqrtf(dx * dx + dy * dy + dz * dz);
+        }
+        for (int i = 0; i < lanes; i++) {
+            float dx = tx[i] - wx[i], dy = ty[i] - wy[i], dz = tz[i] - wz[i];
+            wristToTip[i] = sqrtf(dx * dx + dy * dy + dz * dz);
+        }
+        for (int i = 0; i < lanes; i++) {
+            extension[i] = std::min(baseToTip[i] / kMaxFingerLength, 1.0f) * mask[i];
+        }
+
+        // Scatter back per hand and finish the scalar summaries
+        for (int h = 0; h < count; h++) {
+            const HandLandmarks& hand = hands[first + h];
+            HandFeatures& out = features[first + h];
+            const int lane = h * fingers;
+
+            float tipDistanceSum = 0.0f;
+            float extensionSum = 0.0f;
+            out.trackedTips = 0;
+            for (int i = 0; i < HandFeatures::kLanes; i++) {
+                bool finger = i < fingers;
+                out.baseToTip[i] = finger ? baseToTip[lane + i] : 0.0f;
+                out.wristToTip[i] = finger ? wristToTip[lane + i] : 0.0f;
+                out.extension[i] = finger ? extension[lane + i] : 0.0f;
+            }
+            for (int i = 0; i < fingers; i++) {
+                out.fingerActive[i] = mask[lane + i] != 0.0f;
+                out.tipActive[i] = hand.active[kFingerTip[i]];
+                if (out.tipActive[i]) {
+                    tipDistanceSum += out.wristToTip[i];
+                    out.trackedTips++;
+                }
+                extensionSum += out.extension[i];
+            }
+
+            out.wrist = hand.landmarks[0];
+            out.thumbTip = hand.landmarks[4];
+            out.indexTip = hand.landmarks[8];
+            out.thumbIndexDistance = Vector3Distance(out.thumbTip, out.indexTip);
+            out.avgTipToWrist = out.trackedTips > 0 ? tipDistanceSum / out.trackedTips : 0.0f;
+            out.openness = extensionSum / fingers;
+            out.valid = hand.active[0];
+        }
+    }
+}
+
+int GestureRecognizer::HandSlot(const HandLandmarks& hand) {
+    if (hand.handedness == "Left") return 0;
+    if (hand.handedness == "Right") return 1;
+    return 2;
+}
 
 GestureRecognizer::GestureRecognizer() {
-    gestureStartTime = 0.0f;
-    currentGesture = GestureType::NONE;
-    motionHistory.reserve(10);
+    swipeWindow = 0.3f;
+    swipeDistance = 0.15f;  // 15cm movement threshold
+    swipeMinSpeed = 0.4f;
+    grabWindow = 0.4f;
+    templateClassifier = nullptr;
 }
 
 GestureData GestureRecognizer::RecognizeGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return RecognizeGesture(hand, features);
+}
+
+GestureData GestureRecognizer::RecognizeGesture(const HandLandmarks& hand, const HandFeatures& features) {
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return RecognizeGesture(hand, features, now);
+}
+
+GestureData GestureRecognizer::RecognizeGesture(const HandLandmarks& hand, const HandFeatures& features, double timestamp) {
     GestureData result;
     result.type = GestureType::NONE;
     result.confidence = 0.0f;
-    result.position = hand.landmarks[0]; // Wrist position
+    result.position = features.wrist; // Wrist position
     result.direction = { 0, 0, 0 };
     result.duration = 0.0f;
     result.isActive = false;
 
-    if (!hand.active[0]) return result; // Hand not tracked
+    HandState& state = handStates[HandSlot(hand)];
+    if (!features.valid) { // Hand not tracked
+        state.currentGesture = GestureType::NONE;
+        return result;
+    }
+
+    // Motion gestures look at the history including this frame
+    state.motionHistory.Push(features.wrist, features.openness, timestamp);
 
     // Check static gestures (in order of priority)
-    if (IsPinchGesture(hand)) {
+    if (templateClassifier && templateClassifier->HasTemplates()) {
+        GestureData matched = templateClassifier->Classify(hand);
+        result.type = matched.type;
+        result.confidence = matched.confidence;
+    }
+    else if (IsPinchGesture(features)) {
         result.type = GestureType::PINCH;
         result.confidence = 0.9f;
     }
-    else if (IsIndexFingerExtended(hand)) {
+    else if (IsIndexFingerExtended(features)) {
         result.type = GestureType::POINT;
         result.confidence = 0.8f;
     }
-    else if (IsFistGesture(hand)) {
+    else if (IsFistGesture(features)) {
         result.type = GestureType::FIST;
         result.confidence = 0.8f;
     }
-    else if (IsOpenPalmGesture(hand)) {
+    else if (IsOpenPalmGesture(features)) {
         result.type = GestureType::OPEN_PALM;
         result.confidence = 0.7f;
     }
-    else if (IsPeaceSignGesture(hand)) {
+    else if (IsPeaceSignGesture(features)) {
         result.type = GestureType::PEACE_SIGN;
         result.confidence = 0.8f;
     }
-    else if (IsThumbsUpGesture(hand)) {
+    else if (IsThumbsUpGesture(features)) {
         result.type = GestureType::THUMBS_UP;
         result.confidence = 0.8f;
     }
-    else if (IsOKSignGesture(hand)) {
+    else if (IsOKSignGesture(features)) {
         result.type = GestureType::OK_SIGN;
         result.confidence = 0.8f;
     }
 
     // Check motion gestures
+    if (IsGrabGesture(state.motionHistory)) {
+        result.type = GestureType::GRAB;
+        result.confidence = 0.7f;
+    }
+    else if (IsReleaseGesture(state.motionHistory)) {
+        result.type = GestureType::RELEASE;
+        result.confidence = 0.7f;
+    }
+
     Vector3 swipeDirection;
-    if (IsSwipeGesture(hand, swipeDirection)) {
+    if (IsSwipeGesture(state.motionHistory, swipeDirection)) {
         if (swipeDirection.x > 0.5f) {
             result.type = GestureType::SWIPE_RIGHT;
         }
@@ -66,134 +202,159 @@ GestureData GestureRecognizer::RecognizeGesture(const HandLandmarks& hand) {
 
     result.isActive = (result.type != GestureType::NONE);
 
-    // Update motion history
-    UpdateMotionHistory(hand.landmarks[0]);
+    // Duration of the current gesture on this hand
+    if (result.type != state.currentGesture) {
+        state.currentGesture = result.type;
+        state.gestureStartTime = timestamp;
+    }
+    result.duration = static_cast<float>(timestamp - state.gestureStartTime);
 
     return result;
 }
 
-bool GestureRecognizer::IsIndexFingerExtended(const HandLandmarks& hand) {
-    if (!hand.active[5] || !hand.active[8]) return false;
+void GestureRecognizer::RecognizeGestures(std::span<const HandLandmarks> hands, std::span<GestureData> results, double timestamp) {
+    // Enough for both hands without touching the heap; more hands go in chunks
+    constexpr size_t kChunk = 4;
+    HandFeatures features[kChunk];
+    for (size_t first = 0; first < hands.size(); first += kChunk) {
+        size_t count = std::min(kChunk, hands.size() - first);
+        ComputeHandFeatures(hands.subspan(first, count), std::span<HandFeatures>(features, count));
+        RecognizeGestures(hands.subspan(first, count), std::span<const HandFeatures>(features, count),
+            results.subspan(first, count), timestamp);
+    }
+}
 
-    Vector3 mcp = hand.landmarks[5];   // Index MCP
-    Vector3 tip = hand.landmarks[8];   // Index tip
-    Vector3 wrist = hand.landmarks[0]; // Wrist
+void GestureRecognizer::RecognizeGestures(std::span<const HandLandmarks> hands, std::span<const HandFeatures> features,
+    std::span<GestureData> results, double timestamp) {
+    for (size_t i = 0; i < hands.size(); i++) {
+        results[i] = RecognizeGesture(hands[i], features[i], timestamp);
+    }
+}
 
-    // Check if index finger is extended
-    float indexLength = Vector3Distance(mcp, tip);
-    float wristToTip = Vector3Distance(wrist, tip);
+bool GestureRecognizer::IsIndexFingerExtended(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsIndexFingerExtended(features);
+}
 
-    // Index finger should be extended and other fingers relatively closed
-    bool indexExtended = indexLength > 0.07f && wristToTip > 0.12f;
+bool GestureRecognizer::IsPinchGesture(const HandLandmarks& hand, float threshold) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsPinchGesture(features, threshold);
+}
 
-    // Check if other fingers are more closed than index
-    float middleLength = Vector3Distance(hand.landmarks[9], hand.landmarks[12]);
-    float ringLength = Vector3Distance(hand.landmarks[13], hand.landmarks[16]);
+bool GestureRecognizer::IsFistGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsFistGesture(features);
+}
 
-    return indexExtended && (indexLength > middleLength * 1.2f) && (indexLength > ringLength * 1.2f);
+bool GestureRecognizer::IsOpenPalmGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsOpenPalmGesture(features);
 }
 
-bool GestureRecognizer::IsPinchGesture(const HandLandmarks& hand, float threshold) {
-    if (!hand.active[4] || !hand.active[8]) return false;
+bool GestureRecognizer::IsPeaceSignGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsPeaceSignGesture(features);
+}
 
-    Vector3 thumbTip = hand.landmarks[4];
-    Vector3 indexTip = hand.landmarks[8];
+bool GestureRecognizer::IsThumbsUpGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsThumbsUpGesture(features);
+}
 
-    float distance = Vector3Distance(thumbTip, indexTip);
-    return distance < threshold;
+bool GestureRecognizer::IsOKSignGesture(const HandLandmarks& hand) {
+    HandFeatures features;
+    ComputeHandFeatures(hand, features);
+    return IsOKSignGesture(features);
 }
 
-bool GestureRecognizer::IsFistGesture(const HandLandmarks& hand) {
-    // Check if all fingertips are close to palm
-    Vector3 palm = hand.landmarks[0]; // Wrist as palm reference
+bool GestureRecognizer::IsIndexFingerExtended(const HandFeatures& features) {
+    if (!features.fingerActive[1]) return false;
 
-    float avgDistance = 0.0f;
-    int fingerCount = 0;
+    // Index finger should be extended and other fingers relatively closed
+    float indexLength = features.baseToTip[1];
+    bool indexExtended = indexLength > 0.07f && features.wristToTip[1] > 0.12f;
 
-    // Check fingertips: thumb(4), index(8), middle(12), ring(16), pinky(20)
-    int fingertips[] = { 4, 8, 12, 16, 20 };
+    // Check if other fingers are more closed than index
+    float middleLength = features.baseToTip[2];
+    float ringLength = features.baseToTip[3];
 
-    for (int tip : fingertips) {
-        if (hand.active[tip]) {
-            avgDistance += Vector3Distance(palm, hand.landmarks[tip]);
-            fingerCount++;
-        }
-    }
+    return indexExtended && (indexLength > middleLength * 1.2f) && (indexLength > ringLength * 1.2f);
+}
 
-    if (fingerCount == 0) return false;
-    avgDistance /= fingerCount;
+bool GestureRecognizer::IsPinchGesture(const HandFeatures& features, float threshold) {
+    if (!features.tipActive[0] || !features.tipActive[1]) return false;
+    return features.thumbIndexDistance < threshold;
+}
 
-    return avgDistance < 0.08f; // All fingers close to palm
+bool GestureRecognizer::IsFistGesture(const HandFeatures& features) {
+    // Check if all fingertips are close to palm
+    if (features.trackedTips == 0) return false;
+    return features.avgTipToWrist < 0.08f; // All fingers close to palm
 }
 
-bool GestureRecognizer::IsOpenPalmGesture(const HandLandmarks& hand) {
+bool GestureRecognizer::IsOpenPalmGesture(const HandFeatures& features) {
     // Check if all fingers are extended
-    float openness = GetHandOpenness(hand);
-    return openness > 0.8f;
+    return features.openness > 0.8f;
 }
 
-bool GestureRecognizer::IsPeaceSignGesture(const HandLandmarks& hand) {
-    if (!hand.active[8] || !hand.active[12]) return false;
+bool GestureRecognizer::IsPeaceSignGesture(const HandFeatures& features) {
+    if (!features.tipActive[1] || !features.tipActive[2]) return false;
 
     // Index and middle fingers extended, others closed
-    float indexExt = GetFingerExtension(hand, 1); // Index finger
-    float middleExt = GetFingerExtension(hand, 2); // Middle finger
-    float ringExt = GetFingerExtension(hand, 3);   // Ring finger
-    float pinkyExt = GetFingerExtension(hand, 4);  // Pinky finger
-
-    return (indexExt > 0.7f) && (middleExt > 0.7f) && (ringExt < 0.4f) && (pinkyExt < 0.4f);
+    const float* ext = features.extension;
+    return (ext[1] > 0.7f) && (ext[2] > 0.7f) && (ext[3] < 0.4f) && (ext[4] < 0.4f);
 }
 
-bool GestureRecognizer::IsThumbsUpGesture(const HandLandmarks& hand) {
-    if (!hand.active[4]) return false;
+bool GestureRecognizer::IsThumbsUpGesture(const HandFeatures& features) {
+    if (!features.tipActive[0]) return false;
 
     // Thumb extended upward, other fingers closed
-    Vector3 thumbTip = hand.landmarks[4];
-    Vector3 wrist = hand.landmarks[0];
+    bool thumbUp = (features.thumbTip.y > features.wrist.y + 0.05f);
 
-    // Check if thumb is pointing up
-    bool thumbUp = (thumbTip.y > wrist.y + 0.05f);
-
-    // Check if other fingers are closed
-    float otherFingersOpenness = 0.0f;
-    for (int i = 1; i <= 4; i++) {
-        if (i != 0) { // Skip thumb
-            otherFingersOpenness += GetFingerExtension(hand, i);
-        }
-    }
-    otherFingersOpenness /= 4.0f;
+    const float* ext = features.extension;
+    float otherFingersOpenness = (ext[1] + ext[2] + ext[3] + ext[4]) / 4.0f;
 
     return thumbUp && (otherFingersOpenness < 0.3f);
 }
 
-bool GestureRecognizer::IsOKSignGesture(const HandLandmarks& hand) {
-    if (!hand.active[4] || !hand.active[8]) return false;
+bool GestureRecognizer::IsOKSignGesture(const HandFeatures& features) {
+    if (!features.tipActive[0] || !features.tipActive[1]) return false;
 
     // Thumb and index form circle, other fingers extended
-    Vector3 thumbTip = hand.landmarks[4];
-    Vector3 indexTip = hand.landmarks[8];
+    bool circleFormed = (features.thumbIndexDistance < 0.04f);
 
-    float distance = Vector3Distance(thumbTip, indexTip);
-    bool circleFormed = (distance < 0.04f);
+    const float* ext = features.extension;
+    return circleFormed && (ext[2] > 0.6f) && (ext[3] > 0.6f) && (ext[4] > 0.6f);
+}
 
-    // Check if other fingers are extended
-    float middleExt = GetFingerExtension(hand, 2);
-    float ringExt = GetFingerExtension(hand, 3);
-    float pinkyExt = GetFingerExtension(hand, 4);
+bool GestureRecognizer::IsSwipeGesture(const HandLandmarks& hand, Vector3& direction) {
+    return IsSwipeGesture(handStates[HandSlot(hand)].motionHistory, direction);
+}
 
-    return circleFormed && (middleExt > 0.6f) && (ringExt > 0.6f) && (pinkyExt > 0.6f);
+bool GestureRecognizer::IsGrabGesture(const HandLandmarks& hand) {
+    return IsGrabGesture(handStates[HandSlot(hand)].motionHistory);
 }
 
-bool GestureRecognizer::IsSwipeGesture(const HandLandmarks& hand, Vector3& direction) {
-    if (motionHistory.size() < 5) return false;
+bool GestureRecognizer::IsReleaseGesture(const HandLandmarks& hand) {
+    return IsReleaseGesture(handStates[HandSlot(hand)].motionHistory);
+}
 
-    Vector3 startPos = motionHistory[0];
-    Vector3 endPos = motionHistory.back();
+bool GestureRecognizer::IsSwipeGesture(const MotionHistory& motionHistory, Vector3& direction) const {
+    if (motionHistory.Size() < 3 || motionHistory.Span() < swipeWindow * 0.3f) return false;
 
-    Vector3 movement = Vector3Subtract(endPos, startPos);
+    // Net wrist travel over the swipe window, while the hand is still moving fast
+    const MotionSample& start = motionHistory.WindowStart(swipeWindow);
+    Vector3 movement = Vector3Subtract(motionHistory.Latest().position, start.position);
     float distance = Vector3Length(movement);
+    float speed = Vector3Length(motionHistory.GetVelocity());
 
-    if (distance > 0.15f) { // 15cm movement threshold
+    if (distance > swipeDistance && speed > swipeMinSpeed) {
         direction = Vector3Normalize(movement);
         return true;
     }
@@ -201,26 +362,47 @@ bool GestureRecognizer::IsSwipeGesture(const HandLandmarks& hand, Vector3& direc
     return false;
 }
 
+bool GestureRecognizer::IsGrabGesture(const MotionHistory& motionHistory) const {
+    // Fires on the frame the hand closes, if it was open at any point within the grab
+    // window; a single sample at the window edge is not enough to decide that
+    if (motionHistory.Size() < 2) return false;
+
+    const float closedThreshold = 0.35f;
+    const float openThreshold = 0.6f;
+    float now = motionHistory.Latest().openness;
+    float before = motionHistory.At(1).openness;
+    MotionHistory::OpennessRange range = motionHistory.GetOpennessRange(grabWindow);
+
+    return now < closedThreshold && before >= closedThreshold && range.max > openThreshold;
+}
+
+bool GestureRecognizer::IsReleaseGesture(const MotionHistory& motionHistory) const {
+    // Fires on the frame the hand opens, if it was closed at any point within the grab window
+    if (motionHistory.Size() < 2) return false;
+
+    const float closedThreshold = 0.35f;
+    const float openThreshold = 0.6f;
+    float now = motionHistory.Latest().openness;
+    float before = motionHistory.At(1).openness;
+    MotionHistory::OpennessRange range = motionHistory.GetOpennessRange(grabWindow);
+
+    return now > openThreshold && before <= openThreshold && range.min < closedThreshold;
+}
+
 float GestureRecognizer::GetFingerExtension(const HandLandmarks& hand, int fingerIndex) {
     // Finger landmark indices: thumb(1-4), index(5-8), middle(9-12), ring(13-16), pinky(17-20)
-    int baseIndices[] = { 1, 5, 9, 13, 17 };
-    int tipIndices[] = { 4, 8, 12, 16, 20 };
-
     if (fingerIndex < 0 || fingerIndex > 4) return 0.0f;
 
-    int baseIdx = baseIndices[fingerIndex];
-    int tipIdx = tipIndices[fingerIndex];
+    int baseIdx = kFingerBase[fingerIndex];
+    int tipIdx = kFingerTip[fingerIndex];
 
     if (!hand.active[baseIdx] || !hand.active[tipIdx]) return 0.0f;
 
     Vector3 base = hand.landmarks[baseIdx];
     Vector3 tip = hand.landmarks[tipIdx];
-    Vector3 wrist = hand.landmarks[0];
 
     float fingerLength = Vector3Distance(base, tip);
-    float maxLength = 0.09f; // Approximate max finger length
-
-    return Clamp(fingerLength / maxLength, 0.0f, 1.0f);
+    return Clamp(fingerLength / kMaxFingerLength, 0.0f, 1.0f);
 }
 
 float GestureRecognizer::GetHandOpenness(const HandLandmarks& hand) {
@@ -230,10 +412,3 @@ float GestureRecognizer::GetHandOpenness(const HandLandmarks& hand) {
     }
     return totalExtension / 5.0f;
 }
-
-void GestureRecognizer::UpdateMotionHistory(const Vector3& position) {
-    motionHistory.push_back(position);
-    if (motionHistory.size() > 10) {
-        motionHistory.erase(motionHistory.begin());
-    }
-}
@@ -2,7 +2,9 @@
 #define GESTURE_RECOGNITION_H
 
 #include "raylib.h"
+#include "motion_history.h"
 #include <vector>
+#include <span>
 #include <string>
 
 enum class GestureType {
@@ -36,12 +38,54 @@ struct HandLandmarks {
     float confidence;
 };
 
+// Per-hand measurements shared by every classifier, computed once per frame.
+// Finger arrays are indexed thumb..pinky and padded to 8 lanes so the distance
+// math runs as one vector pass over structure-of-arrays coordinates.
+struct alignas(32) HandFeatures {
+    static constexpr int kFingers = 5;
+    static constexpr int kLanes = 8;
+
+    float baseToTip[kLanes];    // finger base -> tip distance
+    float wristToTip[kLanes];   // wrist -> fingertip distance
+    float extension[kLanes];    // baseToTip / max finger length, 0 if base or tip untracked
+    bool fingerActive[kFingers];
+    bool tipActive[kFingers];
+
+    Vector3 wrist;
+    Vector3 thumbTip;
+    Vector3 indexTip;
+    float thumbIndexDistance;   // pinch / OK-sign distance
+    float avgTipToWrist;        // over tracked fingertips, 0 if none
+    int trackedTips;
+    float openness;             // mean extension of all five fingers
+    bool valid;                 // wrist tracked
+};
+
+void ComputeHandFeatures(const HandLandmarks& hand, HandFeatures& features);
+// Same measurements for several hands at once; the fingers of every hand share
+// one vector pass, so the cost per hand drops as hands are added
+void ComputeHandFeatures(std::span<const HandLandmarks> hands, std::span<HandFeatures> features);
+
+class GestureTemplateClassifier;
+
 class GestureRecognizer {
 public:
+    // Motion state is kept per hand slot: Left, Right, and one for unlabelled hands
+    static constexpr int kMaxHands = 3;
+    static int HandSlot(const HandLandmarks& hand);
+
     GestureRecognizer();
 
     // Core gesture recognition
     GestureData RecognizeGesture(const HandLandmarks& hand);
+    GestureData RecognizeGesture(const HandLandmarks& hand, const HandFeatures& features);
+    // timestamp in seconds; the overloads above use the steady clock
+    GestureData RecognizeGesture(const HandLandmarks& hand, const HandFeatures& features, double timestamp);
+
+    // Batched recognition of every tracked hand in one call; results[i] belongs to hands[i]
+    void RecognizeGestures(std::span<const HandLandmarks> hands, std::span<GestureData> results, double timestamp);
+    void RecognizeGestures(std::span<const HandLandmarks> hands, std::span<const HandFeatures> features,
+        std::span<GestureData> results, double timestamp);
 
     // Individual gesture checks
     bool IsIndexFingerExtended(const HandLandmarks& hand);
@@ -52,7 +96,16 @@ public:
     bool IsThumbsUpGesture(const HandLandmarks& hand);
     bool IsOKSignGesture(const HandLandmarks& hand);
 
-    // Motion-based gestures
+    // Same checks against precomputed features
+    bool IsIndexFingerExtended(const HandFeatures& features);
+    bool IsPinchGesture(const HandFeatures& features, float threshold = 0.03f);
+    bool IsFistGesture(const HandFeatures& features);
+    bool IsOpenPalmGesture(const HandFeatures& features);
+    bool IsPeaceSignGesture(const HandFeatures& features);
+    bool IsThumbsUpGesture(const HandFeatures& features);
+    bool IsOKSignGesture(const HandFeatures& features);
+
+    // Motion-based gestures, evaluated over time windows of the motion history
     bool IsSwipeGesture(const HandLandmarks& hand, Vector3& direction);
     bool IsGrabGesture(const HandLandmarks& hand);
     bool IsReleaseGesture(const HandLandmarks& hand);
@@ -61,15 +114,36 @@ public:
     float GetFingerExtension(const HandLandmarks& hand, int fingerIndex);
     Vector3 GetFingerDirection(const HandLandmarks& hand, int fingerIndex);
     float GetHandOpenness(const HandLandmarks& hand);
+    const MotionHistory& GetMotionHistory(int slot) const { return handStates[slot].motionHistory; }
+
+    // Motion gesture tuning; windows are capped at MotionHistory::kMaxWindow
+    void SetSwipeWindow(float seconds) { swipeWindow = seconds < MotionHistory::kMaxWindow ? seconds : MotionHistory::kMaxWindow; }
+    void SetSwipeDistance(float meters) { swipeDistance = meters; }
+    void SetSwipeMinSpeed(float metersPerSecond) { swipeMinSpeed = metersPerSecond; }
+    void SetGrabWindow(float seconds) { grabWindow = seconds < MotionHistory::kMaxWindow ? seconds : MotionHistory::kMaxWindow; }
+
+    // When set and loaded, static poses come from template matching instead of the
+    // hand-tuned thresholds; motion gestures are unaffected
+    void SetTemplateClassifier(const GestureTemplateClassifier* classifier) { templateClassifier = classifier; }
 
 private:
-    HandLandmarks previousHand;
-    std::vector<Vector3> motionHistory;
-    float gestureStartTime;
-    GestureType currentGesture;
+    struct HandState {
+        MotionHistory motionHistory;
+        GestureType currentGesture = GestureType::NONE;
+        double gestureStartTime = 0.0;
+    };
+
+    HandState handStates[kMaxHands];
+
+    float swipeWindow;
+    float swipeDistance;
+    float swipeMinSpeed;
+    float grabWindow;
+    const GestureTemplateClassifier* templateClassifier;
 
-    void UpdateMotionHistory(const Vector3& position);
-    float CalculateMotionDirection(Vector3& direction);
+    bool IsSwipeGesture(const MotionHistory& history, Vector3& direction) const;
+    bool IsGrabGesture(const MotionHistory& history) const;
+    bool IsReleaseGesture(const MotionHistory& history) const;
 };
 
 #endif // GESTURE_RECOGNITION_H
@@ -0,0 +1,239 @@
+#include "gesture_templates.h"
+#include "async_logger.h"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <raymath.h>
+
+namespace {
+
+const char* kGestureNames[] = {
+    "NONE", "POINT", "PINCH", "FIST", "OPEN_PALM", "PEACE_SIGN",
+    "THUMBS_UP", "OK_SIGN", "SWIPE_LEFT", "SWIPE_RIGHT", "GRAB", "RELEASE"
+};
+static_assert(sizeof(kGestureNames) / sizeof(kGestureNames[0]) == static_cast<size_t>(GestureType::RELEASE) + 1,
+    "every gesture needs a name");
+
+const int kMaxNeighbors = 8;
+const int kTemplateFileVersion = 1;
+
+} // namespace
+
+const char* GestureTypeName(GestureType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < sizeof(kGestureNames) / sizeof(kGestureNames[0]) ? kGestureNames[index] : "NONE";
+}
+
+bool ParseGestureType(const std::string& name, GestureType& type) {
+    for (size_t i = 0; i < sizeof(kGestureNames) / sizeof(kGestureNames[0]); i++) {
+        if (name == kGestureNames[i]) {
+            type = static_cast<GestureType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NormalizeHandLandmarks(const HandLandmarks& hand, GestureFeatureVector& out) {
+    memset(&out, 0, sizeof(out));
+    if (!hand.active[0] || !hand.active[9]) return false;
+
+    const Vector3 wrist = hand.landmarks[0];
+    float palmLength = Vector3Distance(wrist, hand.landmarks[9]);
+    if (palmLength < 1e-4f) return false;
+
+    float scale = 1.0f / palmLength;
+    // Mirror left hands so one template set covers both
+    float mirror = (hand.handedness == "Left") ? -1.0f : 1.0f;
+
+    for (int i = 0; i < GestureFeatureVector::kPoints; i++) {
+        int landmark = i + 1;
+        if (!hand.active[landmark]) continue;
+        Vector3 p = Vector3Subtract(hand.landmarks[landmark], wrist);
+        out.values[i * 3 + 0] = p.x * scale * mirror;
+        out.values[i * 3 + 1] = p.y * scale;
+        out.values[i * 3 + 2] = p.z * scale;
+        out.mask[i * 3 + 0] = 1.0f;
+        out.mask[i * 3 + 1] = 1.0f;
+        out.mask[i * 3 + 2] = 1.0f;
+        out.trackedDims += 3;
+    }
+    return out.trackedDims > 0;
+}
+
+GestureTemplateClassifier::GestureTemplateClassifier() {
+    neighbors = 3;
+    rejectDistance = 0.05f;
+}
+
+void GestureTemplateClassifier::Clear() {
+    rows.clear();
+    labels.clear();
+}
+
+void GestureTemplateClassifier::AddTemplate(GestureType type, const GestureFeatureVector& features) {
+    TemplateRow row;
+    for (int d = 0; d < GestureFeatureVector::kDims; d++) {
+        row.values[d] = features.values[d] * features.mask[d];
+    }
+    rows.push_back(row);
+    labels.push_back(type);
+}
+
+bool GestureTemplateClassifier::AddTemplate(GestureType type, const HandLandmarks& hand) {
+    GestureFeatureVector features;
+    if (!NormalizeHandLandmarks(hand, features)) return false;
+    AddTemplate(type, features);
+    return true;
+}
+
+bool GestureTemplateClassifier::LoadTemplates(const std::string& path) {
+    try {
+        std::ifstream file(path);
+        if (!file.is_open()) return false;
+
+        nlohmann::json root = nlohmann::json::parse(file);
+        if (root.value("version", 0) != kTemplateFileVersion ||
+            root.value("dims", 0) != GestureFeatureVector::kUsedDims) {
+            VR_LOG_ERROR(LogChannel::Hand, "Gesture template file has wrong version or size");
+            return false;
+        }
+
+        std::vector<TemplateRow> loadedRows;
+        std::vector<GestureType> loadedLabels;
+        for (const auto& entry : root["templates"]) {
+            GestureType type;
+            const auto& values = entry["features"];
+            if (!ParseGestureType(entry.value("gesture", ""), type) ||
+                values.size() != GestureFeatureVector::kUsedDims) {
+                continue;
+            }
+            TemplateRow row = {};
+            for (int d = 0; d < GestureFeatureVector::kUsedDims; d++) {
+                row.values[d] = values[d].get<float>();
+            }
+            loadedRows.push_back(row);
+            loadedLabels.push_back(type);
+        }
+
+        rows.swap(loadedRows);
+        labels.swap(loadedLabels);
+        return true;
+    }
+    catch (const std::exception& e) {
+        VR_LOG_ERROR(LogChannel::Hand, "Error loading gesture templates: {}", e.what());
+        return false;
+    }
+}
+
+bool GestureTemplateClassifier::SaveTemplates(const std::string& path) const {
+    nlohmann::json root;
+    root["version"] = kTemplateFileVersion;
+    root["dims"] = GestureFeatureVector::kUsedDims;
+    root["templates"] = nlohmann::json::array();
+    for (size_t i = 0; i < rows.size(); i++) {
+        nlohmann::json values = nlohmann::json::array();
+        for (int d = 0; d < GestureFeatureVector::kUsedDims; d++) {
+            values.push_back(rows[i].values[d]);
+        }
+        root["templates"].push_back({ { "gesture", GestureTypeName(labels[i]) }, { "features", values } });
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    file << root.dump();
+    return file.good();
+}
+
+float GestureTemplateClassifier::NearestDistance(const GestureFeatureVector& features, GestureType* type) const {
+    float best = std::numeric_limits<float>::max();
+    GestureType bestType = GestureType::NONE;
+    for (size_t t = 0; t < rows.size(); t++) {
+        const float* row = rows[t].values;
+        float sum = 0.0f;
+        for (int d = 0; d < GestureFeatureVector::kDims; d++) {
+            float diff = (row[d] - features.values[d]) * features.mask[d];
+            sum += diff * diff;
+        }
+        if (sum < best) {
+            best = sum;
+            bestType = labels[t];
+        }
+    }
+    if (type) *type = bestType;
+    return features.trackedDims > 0 ? best / features.trackedDims : best;
+}
+
+GestureData GestureTemplateClassifier::Classify(const HandLandmarks& hand) const {
+    GestureFeatureVector features;
+    if (!NormalizeHandLandmarks(hand, features)) {
+        GestureData result = {};
+        result.type = GestureType::NONE;
+        result.position = hand.landmarks[0];
+        return result;
+    }
+    GestureData result = Classify(features);
+    result.position = hand.landmarks[0];
+    return result;
+}
+
+GestureData GestureTemplateClassifier::Classify(const GestureFeatureVector& features) const {
+    GestureData result = {};
+    result.type = GestureType::NONE;
+    if (rows.empty() || features.trackedDims == 0) return result;
+
+    // Keep the k smallest squared distances in a small sorted array
+    int k = neighbors < kMaxNeighbors ? neighbors : kMaxNeighbors;
+    float nearest[kMaxNeighbors];
+    GestureType nearestType[kMaxNeighbors];
+    int found = 0;
+
+    for (size_t t = 0; t < rows.size(); t++) {
+        const float* row = rows[t].values;
+        // Masked squared distance; untracked query landmarks contribute nothing
+        float sum = 0.0f;
+        for (int d = 0; d < GestureFeatureVector::kDims; d++) {
+            float diff = (row[d] - features.values[d]) * features.mask[d];
+            sum += diff * diff;
+        }
+
+        if (found == k && sum >= nearest[k - 1]) continue;
+        int i = found < k ? found++ : k - 1;
+        while (i > 0 && nearest[i - 1] > sum) {
+            nearest[i] = nearest[i - 1];
+            nearestType[i] = nearestType[i - 1];
+            i--;
+        }
+        nearest[i] = sum;
+        nearestType[i] = labels[t];
+    }
+
+    float scale = 1.0f / features.trackedDims;
+    float bestDistance = nearest[0] * scale;
+    if (bestDistance > rejectDistance) return result;
+
+    // Inverse-distance weighted vote among the neighbours
+    float votes[kMaxNeighbors] = {};
+    float totalWeight = 0.0f;
+    for (int i = 0; i < found; i++) {
+        float weight = 1.0f / (nearest[i] * scale + 1e-4f);
+        votes[i] = 0.0f;
+        for (int j = 0; j < found; j++) {
+            if (nearestType[j] == nearestType[i]) votes[i] += 1.0f / (nearest[j] * scale + 1e-4f);
+        }
+        totalWeight += weight;
+    }
+
+    int winner = 0;
+    for (int i = 1; i < found; i++) {
+        if (votes[i] > votes[winner]) winner = i;
+    }
+
+    result.type = nearestType[winner];
+    // Agreement of the vote, scaled down as the match approaches the reject distance
+    result.confidence = (votes[winner] / totalWeight) * (1.0f - 0.5f * bestDistance / rejectDistance);
+    result.isActive = result.type != GestureType::NONE;
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef GESTURE_TEMPLATES_H
+#define GESTURE_TEMPLATES_H
+
+#include "gesture_recognition.h"
+#include <string>
+#include <vector>
+
+// Wrist-relative, scale-normalised landmark vector: landmarks 1..20 divided by the
+// wrist -> middle knuckle length, left hands mirrored onto right. Padded to a
+// multiple of 8 floats so the distance loop vectorises without a scalar tail.
+struct alignas(32) GestureFeatureVector {
+    static constexpr int kPoints = 20;
+    static constexpr int kUsedDims = kPoints * 3;
+    static constexpr int kDims = 64;
+
+    float values[kDims];
+    float mask[kDims];   // 1 for dimensions whose landmark is tracked, 0 otherwise
+    int trackedDims;
+};
+
+// Returns false if the hand cannot be normalised (wrist or middle knuckle untracked)
+bool NormalizeHandLandmarks(const HandLandmarks& hand, GestureFeatureVector& out);
+
+const char* GestureTypeName(GestureType type);
+bool ParseGestureType(const std::string& name, GestureType& type);
+
+/**
+ * Nearest-template classifier for static hand poses. Templates are recorded
+ * normalised poses; a hand is labelled by a distance-weighted vote of its k
+ * nearest templates and rejected as NONE if even the nearest one is too far.
+ */
+class GestureTemplateClassifier {
+public:
+    GestureTemplateClassifier();
+
+    bool LoadTemplates(const std::string& path);
+    bool SaveTemplates(const std::string& path) const;
+
+    void AddTemplate(GestureType type, const GestureFeatureVector& features);
+    bool AddTemplate(GestureType type, const HandLandmarks& hand);
+    void Clear();
+
+    size_t GetTemplateCount() const { return labels.size(); }
+    bool HasTemplates() const { return !labels.empty(); }
+
+    GestureData Classify(const HandLandmarks& hand) const;
+    GestureData Classify(const GestureFeatureVector& features) const;
+
+    // Mean squared distance per tracked dimension (normalised units) of the nearest template
+    float NearestDistance(const GestureFeatureVector& features, GestureType* type = nullptr) const;
+
+    void SetNeighbors(int k) { neighbors = k < 1 ? 1 : k; }
+    void SetRejectDistance(float distance) { rejectDistance = distance; }
+
+private:
+    struct alignas(32) TemplateRow {
+        float values[GestureFeatureVector::kDims];
+    };
+
+    std::vector<TemplateRow> rows;
+    std::vector<GestureType> labels;
+    int neighbors;
+    float rejectDistance;
+};
+
+#endif // GESTURE_TEMPLATES_H
@@ -0,0 +1,131 @@
+#include "gyro_parser.h"
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <algorithm>
+
+namespace {
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Finds "key" in the line and parses the number after the colon.
+// A missing key leaves value at 0, like json::value(key, 0.0f) did.
+bool ParseField(std::string_view line, std::string_view quotedKey, float& value) {
+    value = 0.0f;
+    size_t pos = line.find(quotedKey);
+    if (pos == std::string_view::npos) return true;
+
+    const char* p = line.data() + pos + quotedKey.size();
+    const char* end = line.data() + line.size();
+    while (p < end && IsSpace(*p)) p++;
+    if (p >= end || *p != ':') return false;
+    p++;
+    while (p < end && IsSpace(*p)) p++;
+
+    auto [next, ec] = std::from_chars(p, end, value);
+    return ec == std::errc() && next != p;
+}
+
+} // namespace
+
+GyroStreamParser::GyroStreamParser()
+    : start(0), length(0), recordCount(0), errorCount(0) {
+}
+
+void GyroStreamParser::Commit(size_t bytes) {
+    length = std::min(length + bytes, kBufferSize);
+}
+
+size_t GyroStreamParser::Feed(const char* data, size_t size) {
+    if (size > WriteCapacity()) {
+        Compact();
+    }
+    size_t n = std::min(size, WriteCapacity());
+    memcpy(WritePtr(), data, n);
+    length += n;
+    return n;
+}
+
+void GyroStreamParser::Compact() {
+    if (start == 0) return;
+    size_t remaining = length - start;
+    if (remaining > 0) {
+        memmove(buffer, buffer + start, remaining);
+    }
+    start = 0;
+    length = remaining;
+}
+
+GyroStreamParser::Result GyroStreamParser::Next(GyroRecord& out) {
+    if (start >= length) {
+        start = 0;
+        length = 0;
+        return Result::NeedMore;
+    }
+
+    const char* p = buffer + start;
+    size_t avail = length - start;
+
+    // Binary frame
+    uint32_t magic = kBinaryMagic;
+    if (avail < sizeof(uint32_t) && memcmp(p, &magic, avail) == 0) {
+        Compact();
+        return Result::NeedMore;
+    }
+    if (avail >= sizeof(uint32_t) && memcmp(p, &magic, sizeof(uint32_t)) == 0) {
+        if (avail < kBinaryRecordSize) {
+            Compact();
+            return Result::NeedMore;
+        }
+        memcpy(&out.alpha, p + 4, sizeof(float));
+        memcpy(&out.beta, p + 8, sizeof(float));
+        memcpy(&out.gamma, p + 12, sizeof(float));
+        start += kBinaryRecordSize;
+        recordCount++;
+        return Result::Record;
+    }
+
+    // JSON line
+    const char* newline = static_cast<const char*>(memchr(p, '\n', avail));
+    if (!newline) {
+        Compact();
+        if (length == kBufferSize) {
+            // A line longer than the whole buffer can't be valid gyro data
+            start = 0;
+            length = 0;
+            errorCount++;
+            return Result::Skipped;
+        }
+        return Result::NeedMore;
+    }
+
+    start = static_cast<size_t>(newline - buffer) + 1;
+
+    const char* end = newline;
+    while (p < end && IsSpace(*p)) p++;
+    while (end > p && IsSpace(end[-1])) end--;
+    if (p == end) return Result::Skipped;
+
+    if (*p == kCommandPrefix) {
+        command = std::string_view(p + 1, static_cast<size_t>(end - p - 1));
+        return Result::Command;
+    }
+
+    if (!ParseJsonLine(p, end, out)) {
+        errorCount++;
+        return Result::Skipped;
+    }
+    recordCount++;
+    return Result::Record;
+}
+
+bool GyroStreamParser::ParseJsonLine(const char* begin, const char* end, GyroRecord& out) {
+    std::string_view line(begin, static_cast<size_t>(end - begin));
+    if (line.empty() || line.front() != '{' || line.back() != '}') return false;
+
+    return ParseField(line, "\"alpha\"", out.alpha)
+        && ParseField(line, "\"beta\"", out.beta)
+        && ParseField(line, "\"gamma\"", out.gamma);
+}
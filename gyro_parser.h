@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// One device-orientation record as sent by the phone, in degrees
+struct GyroRecord {
+    float alpha;
+    float beta;
+    float gamma;
+};
+
+/**
+ * Streaming parser for the gyro stdin protocol. Never allocates.
+ *
+ * Two record formats may be interleaved on the same stream:
+ *  - JSON lines:   {"alpha":12.5,"beta":-3.0,"gamma":88.1}\n
+ *  - binary frame: uint32 magic 'GYRO' (little endian) followed by alpha, beta, gamma
+ *                  as little-endian float32 (16 bytes, no terminator)
+ * plus control command lines starting with '!' (e.g. "!set capture.fps 30\n"),
+ * which are handed out as they are for the control channel to interpret.
+ *
+ * Bytes are read straight into the internal buffer (WritePtr/Commit) and complete
+ * records are pulled out with Next(). Partial records stay buffered until the rest
+ * arrives.
+ */
+class GyroStreamParser {
+public:
+    static constexpr size_t kBufferSize = 4096;
+    static constexpr uint32_t kBinaryMagic = 0x4F525947;  // "GYRO"
+    static constexpr size_t kBinaryRecordSize = sizeof(uint32_t) + 3 * sizeof(float);
+    static constexpr char kCommandPrefix = '!';
+
+    enum class Result {
+        Record,     // out was filled
+        Skipped,    // blank or malformed record was consumed, call Next() again
+        Command,    // a control line was consumed, see GetCommand()
+        NeedMore    // no complete record is buffered
+    };
+
+    GyroStreamParser();
+
+    // Read destination for the next chunk of input
+    char* WritePtr() { return buffer + length; }
+    size_t WriteCapacity() const { return kBufferSize - length; }
+    void Commit(size_t bytes);
+
+    // Copies data into the buffer; returns how many bytes fit
+    size_t Feed(const char* data, size_t size);
+
+    Result Next(GyroRecord& out);
+
+    uint64_t GetRecordCount() const { return recordCount; }
+    uint64_t GetErrorCount() const { return errorCount; }
+    // The last Command line without its prefix; valid until the next Feed, Commit or Next
+    std::string_view GetCommand() const { return command; }
+
+    // Parses a single JSON object line (no newline). Missing keys default to 0.
+    static bool ParseJsonLine(const char* begin, const char* end, GyroRecord& out);
+
+private:
+    char buffer[kBufferSize];
+    size_t start;   // first unconsumed byte
+    size_t length;  // bytes in buffer
+    uint64_t recordCount;
+    uint64_t errorCount;
+    std::string_view command;
+
+    void Compact();
+};
@@ -0,0 +1,258 @@
+#include "gyro_shm.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace bip = boost::interprocess;
+
+namespace {
+
+// The mapping is shared with another process, so fields are accessed through
+// volatile with explicit fences rather than std::atomic objects.
+template<typename T>
+T LoadShared(const T& field) {
+    T value = *static_cast<const volatile T*>(&field);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return value;
+}
+
+template<typename T>
+void StoreShared(T& field, T value) {
+    std::atomic_thread_fence(std::memory_order_release);
+    *static_cast<volatile T*>(&field) = value;
+}
+
+int64_t SteadyNowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// -------- Reader --------
+
+GyroSharedReader::GyroSharedReader()
+    : header(nullptr), slots(nullptr), capacity(0), mappedSize(0), generation(0), lastWriteCount(0),
+    primed(false), clockOffsetUs(0), haveClockOffset(false), tornReads(0), staleSamples(0), producerResets(0) {
+}
+
+GyroSharedReader::~GyroSharedReader() {
+    Close();
+}
+
+bool GyroSharedReader::Open(const std::string& path) {
+    Close();
+    try {
+        if (!std::filesystem::exists(path) || std::filesystem::file_size(path) < sizeof(GyroShmHeader)) {
+            return false;
+        }
+
+        file = std::make_unique<bip::file_mapping>(path.c_str(), bip::read_only);
+        region = std::make_unique<bip::mapped_region>(*file, bip::read_only);
+
+        auto* mappedHeader = static_cast<const GyroShmHeader*>(region->get_address());
+        mappedSize = region->get_size();
+        if (LoadShared(mappedHeader->magic) != kGyroShmMagic || mappedHeader->version != kGyroShmVersion ||
+            mappedHeader->slotSize != sizeof(GyroShmSlot) || mappedHeader->capacity == 0 ||
+            mappedSize < sizeof(GyroShmHeader) + mappedHeader->capacity * sizeof(GyroShmSlot)) {
+            Close();
+            return false;
+        }
+
+        header = mappedHeader;
+        slots = reinterpret_cast<const GyroShmSlot*>(header + 1);
+        capacity = header->capacity;
+        copies.resize(capacity);
+        generation = LoadShared(header->generation);
+        // Nothing already in the ring is returned until the producer proves to be alive
+        // by writing again; see ReadNew
+        lastWriteCount = LoadShared(header->writeCount);
+        primed = false;
+        haveClockOffset = false;
+        return true;
+    }
+    catch (const std::exception&) {
+        Close();
+        return false;
+    }
+}
+
+void GyroSharedReader::Close() {
+    header = nullptr;
+    slots = nullptr;
+    capacity = 0;
+    mappedSize = 0;
+    region.reset();
+    file.reset();
+}
+
+bool GyroSharedReader::CheckProducer(uint64_t& written) {
+    if (LoadShared(header->magic) != kGyroShmMagic) return false;  // being reset
+
+    uint64_t currentGeneration = LoadShared(header->generation);
+    written = LoadShared(header->writeCount);
+    if (currentGeneration == generation && written >= lastWriteCount) return true;
+
+    // A new producer: its samples start again from slot 0 and its clock may differ
+    uint32_t newCapacity = LoadShared(header->capacity);
+    if (newCapacity == 0 || header->slotSize != sizeof(GyroShmSlot) ||
+        mappedSize < sizeof(GyroShmHeader) + static_cast<size_t>(newCapacity) * sizeof(GyroShmSlot)) {
+        Close();  // the owner reopens it, mapping the grown file
+        return false;
+    }
+    capacity = newCapacity;
+    copies.resize(capacity);
+    generation = currentGeneration;
+    lastWriteCount = 0;
+    primed = false;
+    haveClockOffset = false;
+    producerResets++;
+    return LoadShared(header->magic) == kGyroShmMagic;
+}
+
+bool GyroSharedReader::ReadSlot(uint64_t index, GyroShmSlot& copy) const {
+    const GyroShmSlot& slot = slots[index % capacity];
+
+    uint32_t before = LoadShared(slot.sequence);
+    if (before & 1u) return false;
+
+    copy.timestampUs = *static_cast<const volatile uint64_t*>(&slot.timestampUs);
+    copy.alpha = *static_cast<const volatile float*>(&slot.alpha);
+    copy.beta = *static_cast<const volatile float*>(&slot.beta);
+    copy.gamma = *static_cast<const volatile float*>(&slot.gamma);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = *static_cast<const volatile uint32_t*>(&slot.sequence);
+    return before == after;
+}
+
+size_t GyroSharedReader::ReadRange(uint64_t first, uint64_t end, std::vector<GyroData>& out) {
+    int64_t nowUs = SteadyNowUs();
+
+    // Copy the whole range before mapping any of it, so the offset comes from the
+    // newest sample and older ones are not stamped as if they had just arrived
+    size_t copied = 0;
+    for (uint64_t i = first; i < end && copied < copies.size(); i++) {
+        GyroShmSlot& copy = copies[copied];
+        if (!ReadSlot(i, copy)) {
+            tornReads++;
+            continue;
+        }
+        int64_t offset = nowUs - static_cast<int64_t>(copy.timestampUs);
+        if (!haveClockOffset || offset < clockOffsetUs) {
+            clockOffsetUs = offset;
+            haveClockOffset = true;
+        }
+        copied++;
+    }
+
+    const int64_t maxAgeUs = std::chrono::duration_cast<std::chrono::microseconds>(kMaxSampleAge).count();
+    size_t added = 0;
+    for (size_t i = 0; i < copied; i++) {
+        int64_t localUs = static_cast<int64_t>(copies[i].timestampUs) + clockOffsetUs;
+        if (nowUs - localUs > maxAgeUs) {
+            staleSamples++;
+            continue;
+        }
+        auto local = std::chrono::steady_clock::time_point(std::chrono::microseconds(localUs));
+        out.push_back(GyroDataFromDegrees(copies[i].alpha, copies[i].beta, copies[i].gamma, local));
+        added++;
+    }
+    return added;
+}
+
+size_t GyroSharedReader::ReadNew(std::vector<GyroData>& out) {
+    if (!header) return 0;
+
+    uint64_t written = 0;
+    if (!CheckProducer(written)) return 0;
+    if (written <= lastWriteCount) return 0;
+
+    // The oldest slot may be overwritten while we read it; skip it if we are that far behind
+    uint64_t first = lastWriteCount;
+    if (!primed) {
+        // The producer is writing, so its newest sample anchors the clock offset and
+        // the history behind it can be judged by age; take all of it that is fresh
+        first = 0;
+        primed = true;
+    }
+    if (written - first >= capacity) {
+        first = written - capacity + 1;
+    }
+
+    lastWriteCount = written;
+    return ReadRange(first, written, out);
+}
+
+// -------- Writer --------
+
+GyroSharedWriter::GyroSharedWriter() : header(nullptr), slots(nullptr) {
+}
+
+GyroSharedWriter::~GyroSharedWriter() {
+    header = nullptr;
+    slots = nullptr;
+}
+
+bool GyroSharedWriter::Create(const std::string& path, uint32_t capacity) {
+    if (capacity == 0) return false;
+    try {
+        size_t size = sizeof(GyroShmHeader) + capacity * sizeof(GyroShmSlot);
+        // Never truncated: a reader may have the file mapped, and shrinking it under
+        // the mapping faults the reader (or fails outright on Windows). It only grows.
+        if (!std::filesystem::exists(path)) {
+            std::ofstream create(path, std::ios::binary);
+        }
+        if (std::filesystem::file_size(path) < size) {
+            std::filesystem::resize_file(path, size);
+        }
+
+        file = std::make_unique<bip::file_mapping>(path.c_str(), bip::read_write);
+        region = std::make_unique<bip::mapped_region>(*file, bip::read_write, 0, size);
+
+        header = static_cast<GyroShmHeader*>(region->get_address());
+        slots = reinterpret_cast<GyroShmSlot*>(header + 1);
+        uint64_t previousGeneration = header->magic == kGyroShmMagic ? header->generation : 0;
+
+        // Readers stop accepting the ring until magic is back
+        StoreShared(header->magic, 0u);
+        for (uint32_t i = 0; i < capacity; i++) {
+            StoreShared(slots[i].sequence, 0u);
+            slots[i].timestampUs = 0;
+        }
+        StoreShared(header->writeCount, uint64_t{ 0 });
+        header->version = kGyroShmVersion;
+        header->capacity = capacity;
+        header->slotSize = sizeof(GyroShmSlot);
+        StoreShared(header->generation, previousGeneration + 1);
+        // Magic last so readers never accept a half-initialised header
+        StoreShared(header->magic, kGyroShmMagic);
+        return true;
+    }
+    catch (const std::exception&) {
+        header = nullptr;
+        slots = nullptr;
+        region.reset();
+        file.reset();
+        return false;
+    }
+}
+
+void GyroSharedWriter::Write(float alpha, float beta, float gamma, uint64_t timestampUs) {
+    if (!header) return;
+
+    uint64_t index = header->writeCount;
+    GyroShmSlot& slot = slots[index % header->capacity];
+
+    StoreShared(slot.sequence, slot.sequence + 1);
+    StoreShared(slot.timestampUs, timestampUs);
+    StoreShared(slot.alpha, alpha);
+    StoreShared(slot.beta, beta);
+    StoreShared(slot.gamma, gamma);
+    StoreShared(slot.sequence, slot.sequence + 1);
+    StoreShared(header->writeCount, index + 1);
+}
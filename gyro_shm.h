@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gyro_thread.h"
+
+namespace boost { namespace interprocess {
+class file_mapping;
+class mapped_region;
+} }
+
+/*
+ * Shared-memory gyro channel (Shared/gyro.dat).
+ *
+ * File layout, little endian:
+ *   GyroShmHeader (64 bytes) followed by `capacity` GyroShmSlot entries (32 bytes each).
+ *
+ * Producer, per sample:
+ *   1. slot = writeCount % capacity
+ *   2. slot.sequence += 1      (odd: slot is being written)
+ *   3. write timestampUs, alpha, beta, gamma
+ *   4. slot.sequence += 1      (even: slot is stable)
+ *   5. writeCount += 1
+ * with release ordering between the steps. The reader never writes to the file and
+ * discards any slot whose sequence was odd or changed while it was being copied.
+ *
+ * A producer that (re)starts reuses the file in place, because a reader may have it
+ * mapped: it clears magic, zeroes the slots and writeCount, bumps generation and
+ * sets magic again last. The file only ever grows. Readers treat a changed
+ * generation, or writeCount going backwards, as a new producer.
+ */
+struct GyroShmHeader {
+    uint32_t magic;          // kGyroShmMagic
+    uint32_t version;        // kGyroShmVersion
+    uint32_t capacity;       // number of slots
+    uint32_t slotSize;       // sizeof(GyroShmSlot)
+    uint64_t writeCount;     // samples written since the producer (re)started
+    uint64_t generation;     // bumped every time a producer (re)starts
+    uint8_t reserved[32];
+};
+
+struct GyroShmSlot {
+    uint32_t sequence;
+    uint32_t reserved;
+    uint64_t timestampUs;    // producer's monotonic clock
+    float alpha;             // degrees, same fields as the JSON protocol
+    float beta;
+    float gamma;
+    float reserved2;
+};
+
+static_assert(sizeof(GyroShmHeader) == 64, "GyroShmHeader layout is part of the file format");
+static_assert(sizeof(GyroShmSlot) == 32, "GyroShmSlot layout is part of the file format");
+
+constexpr uint32_t kGyroShmMagic = 0x4D485347;  // "GSHM"
+constexpr uint32_t kGyroShmVersion = 1;
+
+/**
+ * Lock-free reader used by the render thread. Producer timestamps are mapped onto
+ * steady_clock with the smallest observed (now - producer time) offset, so samples
+ * never appear to come from the future. The offset is re-estimated when the
+ * producer restarts, since a new producer may use a different clock.
+ *
+ * Samples older than kMaxSampleAge by that mapping are dropped: a ring left behind
+ * by a producer that stopped must not replay an old head pose.
+ */
+class GyroSharedReader {
+public:
+    static constexpr std::chrono::milliseconds kMaxSampleAge{ 250 };
+
+    GyroSharedReader();
+    ~GyroSharedReader();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    // Appends samples written since the previous call, oldest first. The first call
+    // that finds new samples after Open or a producer restart also returns the fresh
+    // part of the history before them, so a predictor starts with a full window.
+    // Closes the reader if a restarted producer no longer fits the mapping.
+    size_t ReadNew(std::vector<GyroData>& out);
+
+    uint64_t GetTornReads() const { return tornReads; }
+    uint64_t GetStaleSamples() const { return staleSamples; }
+    uint64_t GetProducerResets() const { return producerResets; }
+
+private:
+    std::unique_ptr<boost::interprocess::file_mapping> file;
+    std::unique_ptr<boost::interprocess::mapped_region> region;
+    const GyroShmHeader* header;
+    const GyroShmSlot* slots;
+    uint32_t capacity;
+    size_t mappedSize;
+    uint64_t generation;
+    uint64_t lastWriteCount;
+    bool primed;                       // ReadNew has returned this producer's history
+    int64_t clockOffsetUs;
+    bool haveClockOffset;
+    uint64_t tornReads;
+    uint64_t staleSamples;
+    uint64_t producerResets;
+    std::vector<GyroShmSlot> copies;   // ReadRange scratch, capacity entries
+
+    // False while a producer is resetting the ring, or when it no longer fits the mapping
+    bool CheckProducer(uint64_t& written);
+    size_t ReadRange(uint64_t first, uint64_t end, std::vector<GyroData>& out);
+    bool ReadSlot(uint64_t index, GyroShmSlot& copy) const;
+};
+
+/**
+ * Producer side for C++ senders and tools (see tools/gyro_shm_feed.cpp). Creates the
+ * file, or resets an existing one in place so readers that have it mapped keep a
+ * valid mapping and see a new generation.
+ */
+class GyroSharedWriter {
+public:
+    GyroSharedWriter();
+    ~GyroSharedWriter();
+
+    bool Create(const std::string& path, uint32_t capacity = 256);
+    void Write(float alpha, float beta, float gamma, uint64_t timestampUs);
+    bool IsOpen() const { return header != nullptr; }
+
+private:
+    std::unique_ptr<boost::interprocess::file_mapping> file;
+    std::unique_ptr<boost::interprocess::mapped_region> region;
+    GyroShmHeader* header;
+    GyroShmSlot* slots;
+};
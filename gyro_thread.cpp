@@ -1,61 +1,57 @@
-#include <nlohmann/json.hpp>
-#include <string>
-#include <iostream>
-#include <fstream>
-#include "thread_safe_queue.h"
+#include <memory>
 #include "gyro_thread.h"
-#include <windows.h>
-#include <cstdio>
-
-bool CheckStdinAvailable() {
-    DWORD bytesAvailable = 0;
-    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
-    if (hIn == INVALID_HANDLE_VALUE) return false;
-
-    return PeekNamedPipe(hIn, NULL, 0, NULL, &bytesAvailable, NULL) && bytesAvailable > 0;
-}
-
-#define DEGRAD 0.01745329251994329576923690768489 // PI / 180
-void GyroStdinReaderThread(ThreadSafeQueue<GyroData>& queue) {
-    std::ofstream log("gyro_debug.log", std::ios::app);
-    log << "[INFO] Gyro thread started\n";
-
-    while (true) {
-        if (CheckStdinAvailable()) {
-            std::string line;
-            if (std::getline(std::cin, line)) {
-                try {
-                    if (line.empty()) continue;
-
-                    auto j = nlohmann::json::parse(line);
-
-                    float alpha = j.value("alpha", 0.0f);
-                    float beta = j.value("beta", 0.0f);
-                    float gamma = j.value("gamma", 0.0f);
-
-                    GyroData data;
-                    data.yaw = DEGRAD * alpha;
-                    data.pitch = DEGRAD * gamma;
-                    data.roll = DEGRAD * beta;
-
-                    log << "[INFO] Parsed Gyro: alpha=" << alpha
-                        << ", beta=" << beta
-                        << ", gamma=" << gamma << std::endl;
+#include "gyro_parser.h"
+#include "control_channel.h"
+#include "metrics_registry.h"
+#include "async_logger.h"
+
+namespace {
+
+struct GyroStdinState {
+    GyroStreamParser parser;
+    uint64_t reportedErrors = 0;
+    MetricCounter& recordMetric = MetricsRegistry::instance().Counter("vr_gyro_records_total", "Gyro records parsed from stdin");
+    MetricCounter& errorMetric = MetricsRegistry::instance().Counter("vr_gyro_parse_failures_total", "Malformed gyro records on stdin");
+};
+
+} // namespace
+
+int AttachGyroStdinSource(IoReactor& reactor, GyroMailbox& mailbox, ControlChannel* control) {
+    auto state = std::make_shared<GyroStdinState>();
+    VR_LOG_INFO(LogChannel::Gyro, "Gyro stdin source attached");
+
+    return reactor.AddStream("gyro", IoReactor::StdinHandle(),
+        [state, &mailbox, control](const char* data, size_t size, IoReactor::Clock::time_point arrival) {
+            GyroStreamParser& parser = state->parser;
+
+            if (size == 0) {
+                VR_LOG_INFO(LogChannel::Gyro, "EOF reached on gyro stdin. Records parsed: {}, malformed: {}",
+                    parser.GetRecordCount(), parser.GetErrorCount());
+                return;
+            }
 
-                    queue.push(std::move(data));
-                }
-                catch (const std::exception& e) {
-                    log << "Gyro parse error: " << e.what() << std::endl;
+            while (size > 0) {
+                size_t taken = parser.Feed(data, size);
+                data += taken;
+                size -= taken;
+
+                GyroRecord record;
+                GyroStreamParser::Result result;
+                while ((result = parser.Next(record)) != GyroStreamParser::Result::NeedMore) {
+                    if (result == GyroStreamParser::Result::Command && control) {
+                        control->Submit(parser.GetCommand());
+                    }
+                    if (result != GyroStreamParser::Result::Record) continue;
+
+                    mailbox.push(GyroDataFromDegrees(record.alpha, record.beta, record.gamma, arrival));
+                    state->recordMetric.Add();
                 }
             }
-            else {
-                log << "[INFO] EOF reached in Gyro thread. Exiting.\n";
-                break;
+
+            if (parser.GetErrorCount() != state->reportedErrors) {
+                state->errorMetric.Add(parser.GetErrorCount() - state->reportedErrors);
+                state->reportedErrors = parser.GetErrorCount();
+                VR_LOG_WARN(LogChannel::Gyro, "Gyro parse error: malformed record (total {})", state->reportedErrors);
             }
-        }
-        else {
-            // Sleep briefly to avoid busy spin
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        }
-    }
+        });
 }
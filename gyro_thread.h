@@ -1,19 +1,38 @@
 #pragma once
 
 #include <string>
-#include "thread_safe_queue.h"
+#include <chrono>
+#include "sample_mailbox.h"
+#include "io_reactor.h"
 
 // Forward declaration of GyroData
 struct GyroData {
     float yaw;
     float pitch;
     float roll;
+    std::chrono::steady_clock::time_point timestamp;  // when the sample was read
 };
 
+// Device orientation angles (degrees) to the radian yaw/pitch/roll Player expects
+inline GyroData GyroDataFromDegrees(float alpha, float beta, float gamma,
+    std::chrono::steady_clock::time_point timestamp) {
+    constexpr float degToRad = 0.01745329251994329576923690768489f;  // PI / 180
+    return GyroData{ degToRad * alpha, degToRad * gamma, degToRad * beta, timestamp };
+}
+
+class ControlChannel;
+
+// Enough for ~64 ms of 1 kHz sensor data between two rendered frames
+using GyroMailbox = SampleMailbox<GyroData, 64>;
 
 /**
- * Reads JSON gyro data from stdin line by line and pushes it into a thread-safe queue.
+ * Registers stdin with the I/O reactor as the gyro stream. Records are parsed on the
+ * reactor thread and pushed into a coalescing mailbox, stamped with their arrival time.
+ * '!' command lines on the same stream are queued on the control channel.
  *
- * @param queue Reference to a ThreadSafeQueue<GyroData> instance.
+ * @param reactor IoReactor that has not been started yet.
+ * @param mailbox Reference to the GyroMailbox drained by the render loop.
+ * @param control Control channel for command lines, or nullptr to ignore them.
+ * @return Reactor source id, or -1 if stdin could not be registered.
  */
-void GyroStdinReaderThread(ThreadSafeQueue<GyroData>& queue);
+int AttachGyroStdinSource(IoReactor& reactor, GyroMailbox& mailbox, ControlChannel* control = nullptr);
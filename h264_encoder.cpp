@@ -0,0 +1,138 @@
+#include "h264_encoder.h"
+#include "thread_topology.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+H264Encoder::H264Encoder(int width, int height, int fps, const EncoderSettings& settings)
+    : width(width), height(height), fps(fps), settings(settings) {
+
+    codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        throw std::runtime_error("H.264 codec not found");
+    }
+
+    ctx = avcodec_alloc_context3(codec);
+    if (!ctx) {
+        throw std::runtime_error("Failed to allocate codec context");
+    }
+
+    ctx->bit_rate = settings.bitrate;
+    ctx->width = width;
+    ctx->height = height;
+    ctx->time_base = AVRational{ 1, fps };
+    ctx->framerate = AVRational{ fps, 1 };
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx->gop_size = settings.gop;
+    ctx->max_b_frames = 0;
+
+    // Ultra-fast preset for real-time streaming
+    // Add these for better rate control:
+    av_opt_set(ctx->priv_data, "crf", std::to_string(settings.crf).c_str(), 0);  // Constant rate factor
+    av_opt_set(ctx->priv_data, "rc-lookahead", "0", 0);  // No lookahead for real-time
+    av_opt_set(ctx->priv_data, "preset", "ultrafast", 0);
+    av_opt_set(ctx->priv_data, "tune", "zerolatency", 0);
+    av_opt_set(ctx->priv_data, "profile", "baseline", 0);
+
+    // x264 starts its worker threads inside avcodec_open2, and on Linux they inherit the
+    // opening thread's affinity and scheduling policy. Opened from the render thread they
+    // would all share its pinned core at SCHED_FIFO; opened from a thread registered as
+    // "encoder" they get that entry's configuration, or "default".
+    int openResult = 0;
+    std::thread opener([this, &openResult] {
+        ThreadTopology::Scope threadScope("encoder");
+        openResult = avcodec_open2(ctx, codec, nullptr);
+    });
+    opener.join();
+    if (openResult < 0) {
+        avcodec_free_context(&ctx);
+        throw std::runtime_error("Failed to open codec");
+    }
+
+    frame = av_frame_alloc();
+    if (!frame) {
+        avcodec_free_context(&ctx);
+        throw std::runtime_error("Failed to allocate frame");
+    }
+
+    frame->format = ctx->pix_fmt;
+    frame->width = width;
+    frame->height = height;
+
+    if (av_frame_get_buffer(frame, 32) < 0) {
+        av_frame_free(&frame);
+        avcodec_free_context(&ctx);
+        throw std::runtime_error("Failed to allocate frame buffer");
+    }
+
+    packet = av_packet_alloc();
+    if (!packet) {
+        av_frame_free(&frame);
+        avcodec_free_context(&ctx);
+        throw std::runtime_error("Failed to allocate packet");
+    }
+
+    swsCtx = sws_getContext(
+        width, height, AV_PIX_FMT_RGBA,
+        width, height, AV_PIX_FMT_YUV420P,
+        SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+
+    if (!swsCtx) {
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&ctx);
+        throw std::runtime_error("Failed to create SWS context");
+    }
+}
+
+H264Encoder::~H264Encoder() {
+    if (ctx) avcodec_free_context(&ctx);
+    if (frame) av_frame_free(&frame);
+    if (packet) av_packet_free(&packet);
+    if (swsCtx) sws_freeContext(swsCtx);
+}
+
+std::vector<uint8_t> H264Encoder::encodeFrame(const uint8_t* rgba, int inputWidth, int inputHeight) {
+    swsCtx = sws_getCachedContext(swsCtx,
+        inputWidth, inputHeight, AV_PIX_FMT_RGBA,
+        width, height, AV_PIX_FMT_YUV420P,
+        SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!swsCtx) {
+        throw std::runtime_error("Failed to create SWS context");
+    }
+
+    const uint8_t* inData[1] = { rgba };
+    int inStride[1] = { 4 * inputWidth };
+
+    sws_scale(
+        swsCtx,
+        inData, inStride,
+        0, inputHeight,
+        frame->data, frame->linesize);
+
+    frame->pts = frameIndex++;
+
+    int ret = avcodec_send_frame(ctx, frame);
+    if (ret < 0) {
+        throw std::runtime_error("Error sending frame for encoding");
+    }
+
+    std::vector<uint8_t> outData;
+
+    while ((ret = avcodec_receive_packet(ctx, packet)) == 0) {
+        outData.insert(outData.end(), packet->data, packet->data + packet->size);
+        av_packet_unref(packet);
+    }
+
+    if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+        throw std::runtime_error("Error receiving packet from encoder");
+    }
+
+    return outData;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// ffmpeg stays out of this header; only h264_encoder.cpp includes it
+#include <cstdint>
+#include <vector>
+
+struct AVCodec;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+// Rate control knobs; changing any of them restarts the encoder on the next frame
+struct EncoderSettings {
+    int bitrate = 2000000;
+    int crf = 23;
+    int gop = 10;
+
+    bool operator==(const EncoderSettings&) const = default;
+};
+
+/**
+ * x264 through libavcodec, tuned for real-time streaming: ultrafast preset,
+ * zerolatency tune, baseline profile, no B-frames and no lookahead, so every
+ * encodeFrame call returns the packet for the frame it was given. Throws
+ * std::runtime_error when the codec cannot be set up or a frame fails.
+ *
+ * The codec is opened from a short-lived thread registered with ThreadTopology as
+ * "encoder", so x264's worker threads take that entry's CPUs and priority instead
+ * of inheriting the caller's.
+ */
+class H264Encoder {
+public:
+    H264Encoder(int width, int height, int fps, const EncoderSettings& settings);
+    ~H264Encoder();
+
+    H264Encoder(const H264Encoder&) = delete;
+    H264Encoder& operator=(const H264Encoder&) = delete;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const EncoderSettings& getSettings() const { return settings; }
+
+    // The input may be any size; the conversion stage scales it to the encoder size.
+    // The scaler is only rebuilt when the input size changes.
+    std::vector<uint8_t> encodeFrame(const uint8_t* rgba, int inputWidth, int inputHeight);
+
+private:
+    int width, height, fps;
+    EncoderSettings settings;
+    const AVCodec* codec = nullptr;
+    AVCodecContext* ctx = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    SwsContext* swsCtx = nullptr;
+    int64_t frameIndex = 0;
+};
@@ -0,0 +1,313 @@
+#include "hand_renderer.h"
+#include "async_logger.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+// Explicit attribute locations: mesh vertex at 0, per-instance data at 1-3
+const char* kHandVertexShader = R"(#version 330
+layout(location = 0) in vec3 meshPosition;
+layout(location = 1) in vec4 instanceStart;   // joint centre or bone start, w = radius
+layout(location = 2) in vec3 instanceEnd;     // bone end
+layout(location = 3) in vec4 instanceColor;
+
+uniform mat4 mvpLeft;
+uniform mat4 mvpRight;
+uniform vec4 eyeRemap[2];    // xy: scale, zw: offset of the eye's NDC within the target
+uniform int eyeCount;
+uniform int drawBones;
+
+out vec4 fragColor;
+flat out int fragEye;
+
+void main() {
+    int eye = gl_InstanceID % eyeCount;
+    float radius = instanceStart.w;
+    vec3 world;
+    if (drawBones == 0) {
+        world = instanceStart.xyz + meshPosition * radius;
+    } else {
+        // Unit cylinder along +Y, stretched from start to end
+        vec3 axis = instanceEnd - instanceStart.xyz;
+        float len = length(axis);
+        vec3 dir = (len > 1e-6) ? axis / len : vec3(0.0, 1.0, 0.0);
+        vec3 helper = (abs(dir.y) < 0.99) ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+        vec3 u = normalize(cross(dir, helper));
+        vec3 v = cross(u, dir);
+        world = instanceStart.xyz + axis * meshPosition.y + (u * meshPosition.x + v * meshPosition.z) * radius;
+    }
+
+    vec4 clip = ((eye == 0) ? mvpLeft : mvpRight) * vec4(world, 1.0);
+    clip.xy = clip.xy * eyeRemap[eye].xy + eyeRemap[eye].zw * clip.w;
+    fragColor = instanceColor;
+    fragEye = eye;
+    gl_Position = clip;
+}
+)";
+
+const char* kHandFragmentShader = R"(#version 330
+in vec4 fragColor;
+flat in int fragEye;
+
+uniform vec4 eyeViewport[2];
+uniform int eyeCount;
+
+out vec4 finalColor;
+
+void main() {
+    if (eyeCount > 1) {
+        vec2 pixel = gl_FragCoord.xy - eyeViewport[fragEye].xy;
+        if (pixel.x < 0.0 || pixel.y < 0.0 || pixel.x > eyeViewport[fragEye].z || pixel.y > eyeViewport[fragEye].w) discard;
+    }
+    finalColor = fragColor;
+}
+)";
+
+const int kSphereRings = 6;
+const int kSphereSlices = 8;
+const int kCylinderSides = 8;
+
+const unsigned int kAttribMesh = 0;
+const unsigned int kAttribStart = 1;
+const unsigned int kAttribEnd = 2;
+const unsigned int kAttribColor = 3;
+
+// Triangle lists wound counter-clockwise seen from outside, so culling can stay on
+std::vector<Vector3> BuildSphereMesh() {
+    std::vector<Vector3> vertices;
+    auto point = [](int ring, int slice) {
+        float lat = PI * ring / kSphereRings - PI / 2;
+        float lon = 2 * PI * slice / kSphereSlices;
+        return Vector3{ cosf(lat) * cosf(lon), sinf(lat), cosf(lat) * sinf(lon) };
+    };
+    for (int ring = 0; ring < kSphereRings; ring++) {
+        for (int slice = 0; slice < kSphereSlices; slice++) {
+            Vector3 p00 = point(ring, slice), p01 = point(ring, slice + 1);
+            Vector3 p10 = point(ring + 1, slice), p11 = point(ring + 1, slice + 1);
+            vertices.insert(vertices.end(), { p00, p10, p01, p01, p10, p11 });
+        }
+    }
+    return vertices;
+}
+
+std::vector<Vector3> BuildCylinderMesh() {
+    // Open-ended; the joint spheres cover the ends
+    std::vector<Vector3> vertices;
+    for (int side = 0; side < kCylinderSides; side++) {
+        float a0 = 2 * PI * side / kCylinderSides;
+        float a1 = 2 * PI * (side + 1) / kCylinderSides;
+        Vector3 p0 = { cosf(a0), 0.0f, sinf(a0) }, p1 = { cosf(a1), 0.0f, sinf(a1) };
+        Vector3 q0 = { cosf(a0), 1.0f, sinf(a0) }, q1 = { cosf(a1), 1.0f, sinf(a1) };
+        vertices.insert(vertices.end(), { p0, q0, p1, p1, q0, q1 });
+    }
+    return vertices;
+}
+
+} // namespace
+
+HandRenderer::HandRenderer() {
+    shader = { 0 };
+    jointVao = boneVao = 0;
+    sphereVbo = cylinderVbo = 0;
+    jointVbo = boneVbo = 0;
+    sphereVertexCount = cylinderVertexCount = 0;
+    ready = false;
+    jointCount = boneCount = 0;
+    instancesDirty = false;
+    boneRadius = 0.004f;
+    locMvpLeft = locMvpRight = -1;
+    locEyeRemap = locEyeViewport = -1;
+    locEyeCount = locDrawBones = -1;
+}
+
+HandRenderer::~HandRenderer() {
+    Unload();
+}
+
+bool HandRenderer::Init() {
+    if (ready) return true;
+
+    int version = rlGetVersion();
+    if (version != RL_OPENGL_33 && version != RL_OPENGL_43) {
+        VR_LOG_WARN(LogChannel::Main, "Instanced hand rendering needs OpenGL 3.3, drawing hands with rlgl");
+        return false;
+    }
+
+    shader = LoadShaderFromMemory(kHandVertexShader, kHandFragmentShader);
+    if (!IsShaderValid(shader) || shader.id == rlGetShaderIdDefault()) {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to compile hand shader, drawing hands with rlgl");
+        shader = { 0 };
+        return false;
+    }
+
+    locMvpLeft = GetShaderLocation(shader, "mvpLeft");
+    locMvpRight = GetShaderLocation(shader, "mvpRight");
+    locEyeRemap = GetShaderLocation(shader, "eyeRemap");
+    locEyeViewport = GetShaderLocation(shader, "eyeViewport");
+    locEyeCount = GetShaderLocation(shader, "eyeCount");
+    locDrawBones = GetShaderLocation(shader, "drawBones");
+
+    std::vector<Vector3> sphere = BuildSphereMesh();
+    std::vector<Vector3> cylinder = BuildCylinderMesh();
+    sphereVertexCount = static_cast<int>(sphere.size());
+    cylinderVertexCount = static_cast<int>(cylinder.size());
+
+    // Joints: static sphere mesh plus centre/radius and colour per instance
+    jointVao = rlLoadVertexArray();
+    rlEnableVertexArray(jointVao);
+    sphereVbo = rlLoadVertexBuffer(sphere.data(), sphereVertexCount * static_cast<int>(sizeof(Vector3)), false);
+    rlSetVertexAttribute(kAttribMesh, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(kAttribMesh);
+    jointVbo = rlLoadVertexBuffer(nullptr, kMaxJoints * static_cast<int>(sizeof(HandJointInstance)), true);
+    const int jointStride = static_cast<int>(sizeof(HandJointInstance));
+    rlSetVertexAttribute(kAttribStart, 4, RL_FLOAT, false, jointStride, static_cast<int>(offsetof(HandJointInstance, center)));
+    rlEnableVertexAttribute(kAttribStart);
+    rlSetVertexAttribute(kAttribColor, 4, RL_UNSIGNED_BYTE, true, jointStride, static_cast<int>(offsetof(HandJointInstance, color)));
+    rlEnableVertexAttribute(kAttribColor);
+    rlDisableVertexArray();
+
+    // Bones: static cylinder mesh plus start/radius, end and colour per instance
+    boneVao = rlLoadVertexArray();
+    rlEnableVertexArray(boneVao);
+    cylinderVbo = rlLoadVertexBuffer(cylinder.data(), cylinderVertexCount * static_cast<int>(sizeof(Vector3)), false);
+    rlSetVertexAttribute(kAttribMesh, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(kAttribMesh);
+    boneVbo = rlLoadVertexBuffer(nullptr, kMaxBones * static_cast<int>(sizeof(HandBoneInstance)), true);
+    const int boneStride = static_cast<int>(sizeof(HandBoneInstance));
+    rlSetVertexAttribute(kAttribStart, 4, RL_FLOAT, false, boneStride, static_cast<int>(offsetof(HandBoneInstance, start)));
+    rlEnableVertexAttribute(kAttribStart);
+    rlSetVertexAttribute(kAttribEnd, 3, RL_FLOAT, false, boneStride, static_cast<int>(offsetof(HandBoneInstance, end)));
+    rlEnableVertexAttribute(kAttribEnd);
+    rlSetVertexAttribute(kAttribColor, 4, RL_UNSIGNED_BYTE, true, boneStride, static_cast<int>(offsetof(HandBoneInstance, color)));
+    rlEnableVertexAttribute(kAttribColor);
+    rlDisableVertexArray();
+
+    if (jointVao == 0 || boneVao == 0 || sphereVbo == 0 || cylinderVbo == 0 || jointVbo == 0 || boneVbo == 0) {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to create hand mesh buffers, drawing hands with rlgl");
+        Unload();
+        return false;
+    }
+
+    ready = true;
+    VR_LOG_INFO(LogChannel::Main, "Instanced hand rendering enabled: {} sphere and {} cylinder vertices",
+        sphereVertexCount, cylinderVertexCount);
+    return true;
+}
+
+void HandRenderer::Unload() {
+    unsigned int buffers[] = { sphereVbo, cylinderVbo, jointVbo, boneVbo };
+    for (unsigned int buffer : buffers) {
+        if (buffer != 0) rlUnloadVertexBuffer(buffer);
+    }
+    if (jointVao != 0) rlUnloadVertexArray(jointVao);
+    if (boneVao != 0) rlUnloadVertexArray(boneVao);
+    if (shader.id != 0) UnloadShader(shader);
+    sphereVbo = cylinderVbo = jointVbo = boneVbo = 0;
+    jointVao = boneVao = 0;
+    shader = { 0 };
+    ready = false;
+}
+
+void HandRenderer::SetHands(const VRHand& left, const VRHand& right) {
+    jointCount = 0;
+    boneCount = 0;
+    AppendHand(left);
+    AppendHand(right);
+    instancesDirty = true;
+}
+
+void HandRenderer::AppendHand(const VRHand& hand) {
+    if (!hand.is_tracked || hand.landmarks.size() < 21) return;
+
+    // Same colours and joint sizes as Player::DrawVRHand
+    Color color = (hand.label == "Left") ? SKYBLUE : ORANGE;
+    for (const auto& lm : hand.landmarks) {
+        if (!lm.active || jointCount >= kMaxJoints) continue;
+        float radius = (lm.landmark_id == 0) ? 0.015f : 0.01f;
+        joints[jointCount++] = { lm.position, radius, color };
+    }
+    for (const auto& conn : kHandConnections) {
+        const VRLandmark& a = hand.landmarks[conn[0]];
+        const VRLandmark& b = hand.landmarks[conn[1]];
+        if (!a.active || !b.active || boneCount >= kMaxBones) continue;
+        bones[boneCount++] = { a.position, boneRadius, b.position, color };
+    }
+}
+
+void HandRenderer::Draw() {
+    if (!ready || (jointCount == 0 && boneCount == 0)) return;
+
+    // Queued rlgl geometry first so the hands keep their place in the draw order
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(shader.id);
+    Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(locMvpLeft, mvp);
+    rlSetUniformMatrix(locMvpRight, mvp);
+    float remap[2][4] = { { 1.0f, 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f, 0.0f } };
+    rlSetUniform(locEyeRemap, remap, RL_SHADER_UNIFORM_VEC4, 2);
+    Submit(1);   // depth test is already on inside BeginMode3D
+}
+
+void HandRenderer::DrawStereo(const StereoEye eyes[2], int targetWidth, int targetHeight) {
+    if (!ready || (jointCount == 0 && boneCount == 0)) return;
+
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(locMvpLeft, StereoEyeViewProjection(eyes[0].camera, targetWidth, targetHeight));
+    rlSetUniformMatrix(locMvpRight, StereoEyeViewProjection(eyes[1].camera, targetWidth, targetHeight));
+    float remap[2][4];
+    float viewports[2][4];
+    for (int eye = 0; eye < 2; eye++) {
+        float x = static_cast<float>(eyes[eye].viewportX), y = static_cast<float>(eyes[eye].viewportY);
+        float w = static_cast<float>(eyes[eye].viewportWidth), h = static_cast<float>(eyes[eye].viewportHeight);
+        remap[eye][0] = w / targetWidth;
+        remap[eye][1] = h / targetHeight;
+        remap[eye][2] = (2.0f * x + w) / targetWidth - 1.0f;
+        remap[eye][3] = (2.0f * y + h) / targetHeight - 1.0f;
+        viewports[eye][0] = x;
+        viewports[eye][1] = y;
+        viewports[eye][2] = w;
+        viewports[eye][3] = h;
+    }
+    rlSetUniform(locEyeRemap, remap, RL_SHADER_UNIFORM_VEC4, 2);
+    rlSetUniform(locEyeViewport, viewports, RL_SHADER_UNIFORM_VEC4, 2);
+    rlViewport(0, 0, targetWidth, targetHeight);
+    rlEnableDepthTest();
+    Submit(2);
+    rlDisableDepthTest();
+}
+
+void HandRenderer::Submit(int eyeCount) {
+    rlSetUniform(locEyeCount, &eyeCount, RL_SHADER_UNIFORM_INT, 1);
+
+    // Each joint/bone is drawn once per eye; the instance attributes advance every eyeCount instances
+    int drawBones = 0;
+    if (jointCount > 0) {
+        rlEnableVertexArray(jointVao);
+        if (instancesDirty) rlUpdateVertexBuffer(jointVbo, joints, jointCount * static_cast<int>(sizeof(HandJointInstance)), 0);
+        rlSetVertexAttributeDivisor(kAttribStart, eyeCount);
+        rlSetVertexAttributeDivisor(kAttribColor, eyeCount);
+        rlSetUniform(locDrawBones, &drawBones, RL_SHADER_UNIFORM_INT, 1);
+        rlDrawVertexArrayInstanced(0, sphereVertexCount, jointCount * eyeCount);
+    }
+    if (boneCount > 0) {
+        drawBones = 1;
+        rlEnableVertexArray(boneVao);
+        if (instancesDirty) rlUpdateVertexBuffer(boneVbo, bones, boneCount * static_cast<int>(sizeof(HandBoneInstance)), 0);
+        rlSetVertexAttributeDivisor(kAttribStart, eyeCount);
+        rlSetVertexAttributeDivisor(kAttribEnd, eyeCount);
+        rlSetVertexAttributeDivisor(kAttribColor, eyeCount);
+        rlSetUniform(locDrawBones, &drawBones, RL_SHADER_UNIFORM_INT, 1);
+        rlDrawVertexArrayInstanced(0, cylinderVertexCount, boneCount * eyeCount);
+    }
+    instancesDirty = false;
+
+    rlDisableVertexArray();
+    rlDisableShader();
+}
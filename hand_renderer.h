@@ -0,0 +1,81 @@
+#pragma once
+
+#include "raylib.h"
+#include "player.h"
+#include "stereo_renderer.h"
+
+// Per-frame instance data; layouts are mirrored by the shader attributes
+struct HandJointInstance {
+    Vector3 center;
+    float radius;
+    Color color;
+};
+
+struct HandBoneInstance {
+    Vector3 start;
+    float radius;
+    Vector3 end;
+    Color color;
+};
+
+/**
+ * Draws hand skeletons as instanced low-poly spheres (joints) and cylinders
+ * (bones). Both meshes are uploaded once; each frame only the instance buffers
+ * built from the hand snapshot are updated, and every joint and bone of both
+ * hands goes out in one draw per primitive type. Needs OpenGL 3.3; Player's
+ * DrawVRHand remains the fallback when Init() fails.
+ */
+class HandRenderer {
+public:
+    static constexpr int kMaxJoints = 64;
+    static constexpr int kMaxBones = 64;
+
+    HandRenderer();
+    ~HandRenderer();
+
+    bool Init();
+    void Unload();
+    bool IsReady() const { return ready; }
+
+    // Rebuilds the instance buffers; untracked hands and inactive landmarks are skipped
+    void SetHands(const VRHand& left, const VRHand& right);
+
+    // Inside BeginMode3D: one eye, using rlgl's current matrices and viewport
+    void Draw();
+    // Both eyes of a shared target in one draw per primitive, as StereoRenderer lays them out
+    void DrawStereo(const StereoEye eyes[2], int targetWidth, int targetHeight);
+
+    int GetJointCount() const { return jointCount; }
+    int GetBoneCount() const { return boneCount; }
+
+    void SetBoneRadius(float radius) { boneRadius = radius; }
+
+private:
+    Shader shader;
+    unsigned int jointVao;
+    unsigned int boneVao;
+    unsigned int sphereVbo;
+    unsigned int cylinderVbo;
+    unsigned int jointVbo;
+    unsigned int boneVbo;
+    int sphereVertexCount;
+    int cylinderVertexCount;
+    bool ready;
+
+    HandJointInstance joints[kMaxJoints];
+    HandBoneInstance bones[kMaxBones];
+    int jointCount;
+    int boneCount;
+    bool instancesDirty;
+    float boneRadius;
+
+    int locMvpLeft;
+    int locMvpRight;
+    int locEyeRemap;
+    int locEyeViewport;
+    int locEyeCount;
+    int locDrawBones;
+
+    void AppendHand(const VRHand& hand);
+    void Submit(int eyeCount);
+};
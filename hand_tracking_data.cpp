@@ -0,0 +1,39 @@
+#include "hand_tracking_data.h"
+#include <nlohmann/json.hpp>
+
+std::vector<HandTrackingData> ParseHandTrackingJson(const char* data, size_t size) {
+    std::vector<HandTrackingData> handData;
+    auto parsed = nlohmann::json::parse(data, data + size);
+
+    for (const auto& hand : parsed) {
+        HandTrackingData tracked;
+        tracked.handedness = hand.value("handedness", "");
+        tracked.distance_factor = hand.value("distance_factor", 1.0f);
+        tracked.depth_scale = hand.value("depth_scale", 1.0f);
+        tracked.shoulder_calibrated = hand.value("shoulder_calibrated", false);
+        tracked.confidence = hand.value("confidence", 0.7f);
+
+        if (hand.contains("landmarks")) {
+            for (const auto& lm : hand["landmarks"]) {
+                Vector3 pt = {
+                    lm.value("x", 0.0f),
+                    lm.value("y", 0.0f),
+                    lm.value("z", 0.0f)
+                };
+                tracked.landmarks.push_back(pt);
+            }
+        }
+        handData.push_back(tracked);
+    }
+    return handData;
+}
+
+void ToHandLandmarks(const VRHand& hand, HandLandmarks& out) {
+    out.handedness = hand.label;
+    out.confidence = hand.confidence;
+    for (int i = 0; i < 21; i++) {
+        bool available = hand.is_tracked && i < static_cast<int>(hand.landmarks.size());
+        out.landmarks[i] = available ? hand.landmarks[i].position : Vector3{ 0, 0, 0 };
+        out.active[i] = available && hand.landmarks[i].active;
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef HAND_TRACKING_DATA_H
+#define HAND_TRACKING_DATA_H
+
+#include "player.h"
+#include "gesture_recognition.h"
+#include <cstddef>
+#include <vector>
+
+// Parses the hands.dat JSON payload written by the Python tracker. Throws
+// nlohmann::json::exception on malformed input.
+std::vector<HandTrackingData> ParseHandTrackingJson(const char* data, size_t size);
+
+// World-space landmarks of a hand updated by Player::UpdateVRHand, in the form the
+// gesture code expects
+void ToHandLandmarks(const VRHand& hand, HandLandmarks& out);
+
+#endif // HAND_TRACKING_DATA_H
@@ -0,0 +1,104 @@
+#include "head_pose_predictor.h"
+#include "raymath.h"
+#include <algorithm>
+
+Quaternion HeadOrientationFromGyro(float yaw, float pitch, float roll) {
+    // Same convention the Euler path in Player used: yaw and pitch are inverted and
+    // pitch is offset by 90 degrees because the phone is held upright in the headset.
+    Quaternion qYaw = QuaternionFromAxisAngle({ 0.0f, 1.0f, 0.0f }, yaw);
+    Quaternion qPitch = QuaternionFromAxisAngle({ 0.0f, 0.0f, 1.0f }, -pitch - PI / 2.0f);
+    Quaternion qRoll = QuaternionFromAxisAngle({ 1.0f, 0.0f, 0.0f }, roll);
+    return QuaternionNormalize(QuaternionMultiply(qYaw, QuaternionMultiply(qPitch, qRoll)));
+}
+
+HeadPosePredictor::HeadPosePredictor() {
+    head = 0;
+    count = 0;
+    angularVelocity = { 0.0f, 0.0f, 0.0f };
+    predictionHorizon = 0.030f;  // render + readback + encode + transport
+    maxExtrapolation = 0.100f;
+    velocityWindow = 0.050f;
+    velocitySmoothing = 0.5f;
+    for (auto& s : history) {
+        s.orientation = QuaternionIdentity();
+    }
+}
+
+const HeadPosePredictor::Sample& HeadPosePredictor::GetSample(size_t age) const {
+    return history[(head + kHistorySize - age) % kHistorySize];
+}
+
+void HeadPosePredictor::AddSample(const GyroData& sample) {
+    if (count > 0 && sample.timestamp < GetSample(0).timestamp) return;
+
+    Quaternion q = HeadOrientationFromGyro(sample.yaw, sample.pitch, sample.roll);
+
+    // Keep consecutive samples in the same hemisphere so deltas take the short way round
+    if (count > 0) {
+        Quaternion prev = GetSample(0).orientation;
+        float dot = q.x * prev.x + q.y * prev.y + q.z * prev.z + q.w * prev.w;
+        if (dot < 0.0f) {
+            q = QuaternionScale(q, -1.0f);
+        }
+    }
+
+    head = (head + 1) % kHistorySize;
+    history[head] = { q, sample.timestamp };
+    if (count < kHistorySize) count++;
+
+    UpdateAngularVelocity();
+}
+
+void HeadPosePredictor::UpdateAngularVelocity() {
+    if (count < 2) return;
+
+    const Sample& newest = GetSample(0);
+
+    // Use the oldest sample still inside the velocity window to average out sensor noise
+    size_t oldestAge = 1;
+    for (size_t age = 2; age < count; age++) {
+        auto span = std::chrono::duration<float>(newest.timestamp - GetSample(age).timestamp).count();
+        if (span > velocityWindow) break;
+        oldestAge = age;
+    }
+    const Sample& oldest = GetSample(oldestAge);
+
+    float dt = std::chrono::duration<float>(newest.timestamp - oldest.timestamp).count();
+    if (dt <= 1e-4f) return;
+
+    Quaternion delta = QuaternionMultiply(newest.orientation, QuaternionInvert(oldest.orientation));
+    if (delta.w < 0.0f) {
+        delta = QuaternionScale(delta, -1.0f);
+    }
+
+    Vector3 axis;
+    float angle;
+    QuaternionToAxisAngle(QuaternionNormalize(delta), &axis, &angle);
+
+    Vector3 measured = Vector3Scale(axis, angle / dt);
+    angularVelocity = Vector3Lerp(angularVelocity, measured, velocitySmoothing);
+}
+
+Quaternion HeadPosePredictor::GetLatestOrientation() const {
+    if (count == 0) return QuaternionIdentity();
+    return GetSample(0).orientation;
+}
+
+HeadPosePredictor::Clock::time_point HeadPosePredictor::GetLatestTimestamp() const {
+    if (count == 0) return Clock::time_point{};
+    return GetSample(0).timestamp;
+}
+
+Quaternion HeadPosePredictor::Predict(Clock::time_point displayTime) const {
+    if (count == 0) return QuaternionIdentity();
+
+    const Sample& latest = GetSample(0);
+    float dt = std::chrono::duration<float>(displayTime - latest.timestamp).count();
+    dt = std::clamp(dt, 0.0f, maxExtrapolation);
+
+    float speed = Vector3Length(angularVelocity);
+    if (speed * dt < 1e-5f) return latest.orientation;
+
+    Quaternion step = QuaternionFromAxisAngle(Vector3Scale(angularVelocity, 1.0f / speed), speed * dt);
+    return QuaternionNormalize(QuaternionMultiply(step, latest.orientation));
+}
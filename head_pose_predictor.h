@@ -0,0 +1,66 @@
+#pragma once
+
+#include "raylib.h"
+#include <chrono>
+#include <cstddef>
+#include "gyro_thread.h"
+
+/**
+ * Converts a gyro sample (radians, device yaw/pitch/roll) into the head orientation
+ * used by Player. Identity looks down +X with +Y up, matching Player::Update.
+ */
+Quaternion HeadOrientationFromGyro(float yaw, float pitch, float roll);
+
+/**
+ * Keeps a short history of timestamped gyro samples, estimates the head's angular
+ * velocity and extrapolates the orientation to the time the frame will be shown.
+ * All math is done on quaternions so there is no gimbal lock or yaw wrap-around.
+ */
+class HeadPosePredictor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    HeadPosePredictor();
+
+    // Samples older than the newest one are ignored, e.g. when a second source
+    // replays history the first one already delivered
+    void AddSample(const GyroData& sample);
+    bool HasSamples() const { return count > 0; }
+
+    // Orientation expected at displayTime (latest sample + angular velocity * dt)
+    Quaternion Predict(Clock::time_point displayTime) const;
+    Quaternion GetLatestOrientation() const;
+    Clock::time_point GetLatestTimestamp() const;
+    Vector3 GetAngularVelocity() const { return angularVelocity; }  // rad/s, world space
+
+    // Configuration
+    // Expected time between sampling the pose and the frame being displayed
+    void SetPredictionHorizon(float seconds) { predictionHorizon = seconds; }
+    float GetPredictionHorizon() const { return predictionHorizon; }
+    // Upper bound on extrapolation so a stalled sensor does not spin the view
+    void SetMaxExtrapolation(float seconds) { maxExtrapolation = seconds; }
+    void SetVelocityWindow(float seconds) { velocityWindow = seconds; }
+    void SetVelocitySmoothing(float factor) { velocitySmoothing = factor; }
+
+private:
+    struct Sample {
+        Quaternion orientation;
+        Clock::time_point timestamp;
+    };
+
+    // Enough for the whole velocity window from a 1 kHz shared-memory producer
+    static constexpr size_t kHistorySize = 128;
+
+    Sample history[kHistorySize];
+    size_t head;   // index of the newest sample
+    size_t count;
+    Vector3 angularVelocity;
+
+    float predictionHorizon;
+    float maxExtrapolation;
+    float velocityWindow;
+    float velocitySmoothing;
+
+    const Sample& GetSample(size_t age) const;  // 0 = newest
+    void UpdateAngularVelocity();
+};
@@ -0,0 +1,183 @@
+#include "input_injector.h"
+#include "async_logger.h"
+#include "thread_topology.h"
+#if defined(_WIN32)
+#include "windows_input.h"
+#elif defined(__linux__)
+#include "linux_input.h"
+#endif
+#include <algorithm>
+
+bool MockInputBackend::Inject(const InputEvent* events, size_t count) {
+    calls++;
+    if (callCost.count() > 0) {
+        // Spin rather than sleep: the syscalls this stands in for do not yield
+        auto until = std::chrono::steady_clock::now() + callCost;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        records.push_back({ events[i], now });
+    }
+    return true;
+}
+
+InputInjector::InputInjector() {
+    stopWorker = false;
+    inFlight = false;
+    coalescing = true;
+    running = false;
+    stats = Stats();
+    pending.reserve(kMaxPending);
+}
+
+InputInjector::~InputInjector() {
+    Stop();
+}
+
+bool InputInjector::Start(std::unique_ptr<InputBackend> newBackend) {
+    if (running || !newBackend) return false;
+    backend = std::move(newBackend);
+    stopWorker = false;
+    running = true;
+    worker = std::thread(&InputInjector::WorkerLoop, this);
+    VR_LOG_INFO(LogChannel::Main, "Input injection backend: {}", backend->GetName());
+    return true;
+}
+
+void InputInjector::Stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopWorker = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    running = false;
+    backend.reset();
+}
+
+const char* InputInjector::GetBackendName() const {
+    return backend ? backend->GetName() : "none";
+}
+
+void InputInjector::Push(InputEvent event) {
+    event.queuedAt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.queued++;
+        if (!running) {
+            stats.dropped++;
+            return;
+        }
+        // A move directly after another move replaces it, keeping the older queue time for latency
+        if (coalescing && event.type == InputEvent::Type::Move &&
+            !pending.empty() && pending.back().type == InputEvent::Type::Move) {
+            pending.back().x = event.x;
+            pending.back().y = event.y;
+            stats.coalesced++;
+            return;
+        }
+        // Only moves are shed when the backend falls behind; a lost release would leave a button stuck
+        if (pending.size() >= kMaxPending && event.type == InputEvent::Type::Move) {
+            stats.dropped++;
+            return;
+        }
+        pending.push_back(event);
+    }
+    wake.notify_one();
+}
+
+void InputInjector::MoveTo(int x, int y) {
+    Push({ .type = InputEvent::Type::Move, .x = x, .y = y });
+}
+
+void InputInjector::ButtonDown(InputButton button, int x, int y) {
+    Push({ .type = InputEvent::Type::ButtonDown, .button = button, .x = x, .y = y });
+}
+
+void InputInjector::ButtonUp(InputButton button, int x, int y) {
+    Push({ .type = InputEvent::Type::ButtonUp, .button = button, .x = x, .y = y });
+}
+
+void InputInjector::Click(InputButton button, int x, int y) {
+    ButtonDown(button, x, y);
+    ButtonUp(button, x, y);
+}
+
+void InputInjector::Flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !running || (pending.empty() && !inFlight); });
+}
+
+void InputInjector::SetCoalescing(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex);
+    coalescing = enabled;
+}
+
+InputInjector::Stats InputInjector::TakeStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
+
+void InputInjector::WorkerLoop() {
+    AsyncLogger::instance().registerThread();
+    ThreadTopology::Scope threadScope("input");
+    // Swapped with pending under the lock, so neither side allocates in steady state
+    std::vector<InputEvent> batch;
+    batch.reserve(kMaxPending);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopWorker || !pending.empty(); });
+            if (pending.empty()) {
+                break;  // stopping with nothing left to inject
+            }
+            batch.swap(pending);
+            inFlight = true;
+        }
+
+        bool ok = backend->Inject(batch.data(), batch.size());
+        auto injectedAt = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.batches++;
+            stats.injected += batch.size();
+            stats.maxBatch = std::max(stats.maxBatch, batch.size());
+            if (!ok) {
+                stats.failedBatches++;
+            }
+            for (const auto& event : batch) {
+                double ms = std::chrono::duration<double, std::milli>(injectedAt - event.queuedAt).count();
+                stats.latencyMs += ms;
+                stats.maxLatencyMs = std::max(stats.maxLatencyMs, ms);
+            }
+            inFlight = false;
+        }
+        idle.notify_all();
+        batch.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    idle.notify_all();
+}
+
+std::unique_ptr<InputBackend> CreateSystemInputBackend() {
+#if defined(_WIN32)
+    return CreateWindowsInputBackend();
+#elif defined(__linux__)
+    return CreateLinuxInputBackend();
+#else
+    return nullptr;
+#endif
+}
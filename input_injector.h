@@ -0,0 +1,136 @@
+#pragma once
+
+// No raylib and no windows.h here: this is shared by the desktop renderer and the OS backends
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class InputButton : uint8_t {
+    None,
+    Left,
+    Right
+};
+
+// One pointer event in desktop pixels (primary screen, origin top-left)
+struct InputEvent {
+    enum class Type : uint8_t {
+        Move,
+        ButtonDown,
+        ButtonUp
+    };
+
+    Type type = Type::Move;
+    InputButton button = InputButton::None;
+    int x = 0;
+    int y = 0;
+    std::chrono::steady_clock::time_point queuedAt{};  // oldest input merged into this event
+};
+
+/**
+ * OS side of input injection. Inject receives a whole batch in queue order and
+ * should hand it to the OS in as few calls as it can. Only called from the
+ * injector thread.
+ */
+class InputBackend {
+public:
+    virtual ~InputBackend() = default;
+    virtual const char* GetName() const = 0;
+    virtual bool Inject(const InputEvent* events, size_t count) = 0;
+};
+
+/**
+ * Records injected events in memory instead of sending them anywhere, so the
+ * queue can be measured without a desktop. An optional per-call cost stands in
+ * for the syscall the real backends pay once per batch.
+ */
+class MockInputBackend : public InputBackend {
+public:
+    struct Record {
+        InputEvent event;
+        std::chrono::steady_clock::time_point injectedAt;
+    };
+
+    const char* GetName() const override { return "mock"; }
+    bool Inject(const InputEvent* events, size_t count) override;
+
+    void SetCallCost(std::chrono::microseconds cost) { callCost = cost; }
+    // Only safe once the injector is stopped or flushed
+    const std::vector<Record>& GetRecords() const { return records; }
+    uint64_t GetCalls() const { return calls; }
+
+private:
+    std::vector<Record> records;
+    uint64_t calls = 0;
+    std::chrono::microseconds callCost{ 0 };
+};
+
+/**
+ * Moves pointer injection off the caller's thread. Callers push events and
+ * return immediately; a worker thread takes everything pending in one go and
+ * passes it to the backend as a single batch. Consecutive moves collapse into
+ * the latest one, so a pointer updated at render rate costs one move per batch,
+ * while button events keep their order and their position.
+ */
+class InputInjector {
+public:
+    static constexpr size_t kMaxPending = 1024;
+
+    struct Stats {
+        uint64_t queued = 0;        // events pushed
+        uint64_t coalesced = 0;     // moves merged into a later move
+        uint64_t dropped = 0;       // moves pushed while kMaxPending events were waiting, or before Start
+        uint64_t injected = 0;      // events handed to the backend
+        uint64_t batches = 0;       // backend calls
+        uint64_t failedBatches = 0;
+        size_t maxBatch = 0;
+        double latencyMs = 0.0;     // push -> backend returned, summed over injected events
+        double maxLatencyMs = 0.0;
+    };
+
+    InputInjector();
+    ~InputInjector();
+
+    // Takes ownership of the backend and starts the worker; false if the backend is null
+    bool Start(std::unique_ptr<InputBackend> backend);
+    // Injects whatever is still pending, then joins the worker
+    void Stop();
+    bool IsRunning() const { return running; }
+    const char* GetBackendName() const;
+
+    void Push(InputEvent event);
+    void MoveTo(int x, int y);
+    void ButtonDown(InputButton button, int x, int y);
+    void ButtonUp(InputButton button, int x, int y);
+    void Click(InputButton button, int x, int y);
+
+    // Blocks until everything pushed so far has been injected
+    void Flush();
+    // Off, every move reaches the backend (for comparing against the coalesced path)
+    void SetCoalescing(bool enabled);
+
+    Stats TakeStats();
+
+private:
+    std::unique_ptr<InputBackend> backend;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<InputEvent> pending;
+    bool stopWorker;
+    bool inFlight;
+    bool coalescing;
+    std::atomic<bool> running;
+    Stats stats;
+
+    void WorkerLoop();
+};
+
+// The platform's real backend (SendInput, XTest or uinput); null if none is usable
+std::unique_ptr<InputBackend> CreateSystemInputBackend();
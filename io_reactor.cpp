@@ -0,0 +1,308 @@
+#include "io_reactor.h"
+#include "thread_topology.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr size_t kReadChunk = 4096;
+
+uint64_t ElapsedUs(IoReactor::Clock::time_point from) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(IoReactor::Clock::now() - from).count();
+    return us > 0 ? static_cast<uint64_t>(us) : 0;
+}
+
+} // namespace
+
+IoReactor::IoReactor() : running(false), stopRequested(false) {
+#ifdef __linux__
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    inotifyFd = -1;
+#endif
+}
+
+IoReactor::~IoReactor() {
+    Stop();
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+    if (wakeFd >= 0) close(wakeFd);
+    if (epollFd >= 0) close(epollFd);
+#endif
+}
+
+IoReactor::NativeHandle IoReactor::StdinHandle() {
+#ifdef __linux__
+    return STDIN_FILENO;
+#else
+    return GetStdHandle(STD_INPUT_HANDLE);
+#endif
+}
+
+int IoReactor::AddStream(const std::string& name, NativeHandle handle, StreamHandler handler) {
+    if (running) return -1;
+
+    auto source = std::make_unique<Source>();
+    source->name = name;
+    source->kind = SourceKind::Stream;
+    source->handle = handle;
+    source->onData = std::move(handler);
+    int id = static_cast<int>(sources.size());
+
+#ifdef __linux__
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u32 = static_cast<uint32_t>(id);
+    if (epollFd < 0) return -1;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, handle, &ev) < 0) {
+        // EPERM: a regular file (e.g. `vr < recorded.jsonl`) or /dev/null, which are
+        // always readable; anything else is a real failure
+        if (errno != EPERM) return -1;
+        source->direct = true;
+    }
+#else
+    if (handle == nullptr || handle == INVALID_HANDLE_VALUE) return -1;
+#endif
+
+    sources.push_back(std::move(source));
+    return id;
+}
+
+int IoReactor::AddFileWatch(const std::string& name, const std::string& path, FileHandler handler) {
+    if (running) return -1;
+#ifdef __linux__
+    if (inotifyFd < 0) {
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0) return -1;
+
+        // inotify and the wake eventfd use keys no source id can reach
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = UINT32_MAX;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, inotifyFd, &ev) < 0) return -1;
+    }
+
+    int wd = inotify_add_watch(inotifyFd, path.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB);
+    if (wd < 0) return -1;
+
+    auto source = std::make_unique<Source>();
+    source->name = name;
+    source->kind = SourceKind::FileWatch;
+    source->handle = wd;
+    source->path = path;
+    source->onChange = std::move(handler);
+    sources.push_back(std::move(source));
+    return static_cast<int>(sources.size() - 1);
+#else
+    (void)name;
+    (void)path;
+    (void)handler;
+    return -1;
+#endif
+}
+
+bool IoReactor::Start() {
+    if (running) return true;
+    stopRequested = false;
+
+#ifdef __linux__
+    if (epollFd < 0 || wakeFd < 0) return false;
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u32 = UINT32_MAX - 1;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) < 0 && errno != EEXIST) return false;
+
+    running = true;
+    thread = std::thread(&IoReactor::Run, this);
+#else
+    running = true;
+    for (auto& source : sources) {
+        if (source->kind == SourceKind::Stream) {
+            source->readerDone = false;
+            readerSources.push_back(source.get());
+            readers.emplace_back(&IoReactor::RunStream, this, source.get());
+        }
+    }
+#endif
+    return true;
+}
+
+void IoReactor::Stop() {
+    if (!running) return;
+    stopRequested = true;
+
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+    if (thread.joinable()) thread.join();
+#else
+    // Readers sit in a blocking ReadFile; cancel it so they see stopRequested.
+    // A reader that had not entered ReadFile yet misses the cancel, so it is
+    // repeated each time the wait for the thread to exit times out.
+    for (size_t i = 0; i < readers.size(); i++) {
+        HANDLE reader = readers[i].native_handle();
+        while (!readerSources[i]->readerDone) {
+            CancelSynchronousIo(reader);
+            if (WaitForSingleObject(reader, 10) == WAIT_OBJECT_0) break;
+        }
+        readers[i].join();
+    }
+    readers.clear();
+    readerSources.clear();
+#endif
+
+    running = false;
+}
+
+void IoReactor::DispatchStream(Source& source, const char* data, size_t size, Clock::time_point arrival) {
+    source.onData(data, size, arrival);
+    source.events.fetch_add(1, std::memory_order_relaxed);
+    source.bytes.fetch_add(size, std::memory_order_relaxed);
+    UpdateMax(source.maxDispatchUs, ElapsedUs(arrival));
+}
+
+#ifdef __linux__
+void IoReactor::Run() {
+    ThreadTopology::Scope threadScope("io");
+    epoll_event events[16];
+    char chunk[kReadChunk];
+
+    while (!stopRequested) {
+        // Direct sources always have data until EOF, so only block once they are done
+        bool directOpen = false;
+        for (auto& source : sources) {
+            if (source->direct && source->open) directOpen = true;
+        }
+
+        int n = epoll_wait(epollFd, events, 16, directOpen ? 0 : -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        auto arrival = Clock::now();
+
+        for (auto& source : sources) {
+            if (source->direct && source->open) {
+                ReadStream(*source, chunk, sizeof(chunk), arrival);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint32_t key = events[i].data.u32;
+            if (key == UINT32_MAX - 1) {
+                // wakeFd: clear it, the loop condition handles shutdown
+                uint64_t value;
+                ssize_t drained = read(wakeFd, &value, sizeof(value));
+                (void)drained;
+                continue;
+            }
+            if (key == UINT32_MAX) {
+                DrainInotify(arrival);
+                continue;
+            }
+
+            Source& source = *sources[key];
+            if (source.open) {
+                ReadStream(source, chunk, sizeof(chunk), arrival);
+            }
+        }
+    }
+}
+
+void IoReactor::ReadStream(Source& source, char* chunk, size_t size, Clock::time_point arrival) {
+    ssize_t got = read(source.handle, chunk, size);
+    if (got > 0) {
+        DispatchStream(source, chunk, static_cast<size_t>(got), arrival);
+    }
+    else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+        if (!source.direct) epoll_ctl(epollFd, EPOLL_CTL_DEL, source.handle, nullptr);
+        source.open = false;
+        source.onData(nullptr, 0, arrival);
+    }
+}
+
+void IoReactor::DrainInotify(Clock::time_point arrival) {
+    alignas(inotify_event) char buf[4096];
+    ssize_t len;
+    while ((len = read(inotifyFd, buf, sizeof(buf))) > 0) {
+        for (char* p = buf; p < buf + len;) {
+            auto* event = reinterpret_cast<inotify_event*>(p);
+            for (auto& source : sources) {
+                if (source->kind == SourceKind::FileWatch && source->handle == event->wd) {
+                    source->onChange(arrival);
+                    source->events.fetch_add(1, std::memory_order_relaxed);
+                    UpdateMax(source->maxDispatchUs, ElapsedUs(arrival));
+                }
+            }
+            p += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+#else
+void IoReactor::RunStream(Source* source) {
+    ThreadTopology::Scope threadScope("io-" + source->name);
+    char chunk[kReadChunk];
+
+    while (!stopRequested) {
+        DWORD got = 0;
+        BOOL ok = ReadFile(source->handle, chunk, sizeof(chunk), &got, NULL);
+        auto arrival = Clock::now();
+        if (stopRequested) break;
+
+        if (ok && got > 0) {
+            DispatchStream(*source, chunk, got, arrival);
+        }
+        else {
+            source->open = false;
+            source->onData(nullptr, 0, arrival);
+            break;
+        }
+    }
+    source->readerDone = true;
+}
+#endif
+
+void IoReactor::ReportConsumed(int sourceId, Clock::time_point arrival) {
+    if (sourceId < 0 || sourceId >= static_cast<int>(sources.size())) return;
+    Source& source = *sources[sourceId];
+    uint64_t us = ElapsedUs(arrival);
+    source.consumed.fetch_add(1, std::memory_order_relaxed);
+    source.totalConsumeUs.fetch_add(us, std::memory_order_relaxed);
+    UpdateMax(source.maxConsumeUs, us);
+}
+
+std::vector<IoReactor::SourceStats> IoReactor::GetStats(bool reset) {
+    std::vector<SourceStats> stats;
+    stats.reserve(sources.size());
+
+    for (auto& source : sources) {
+        SourceStats s;
+        s.name = source->name;
+        s.events = reset ? source->events.exchange(0) : source->events.load();
+        s.bytes = reset ? source->bytes.exchange(0) : source->bytes.load();
+        s.maxDispatchMs = (reset ? source->maxDispatchUs.exchange(0) : source->maxDispatchUs.load()) / 1000.0f;
+        s.consumed = reset ? source->consumed.exchange(0) : source->consumed.load();
+        uint64_t total = reset ? source->totalConsumeUs.exchange(0) : source->totalConsumeUs.load();
+        s.avgConsumeMs = s.consumed ? (total / 1000.0f) / s.consumed : 0.0f;
+        s.maxConsumeMs = (reset ? source->maxConsumeUs.exchange(0) : source->maxConsumeUs.load()) / 1000.0f;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void IoReactor::UpdateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Single input I/O thread for every byte stream and file notification the process
+ * consumes (gyro stdin, control channel, hand file).
+ *
+ * On Linux all sources are multiplexed with epoll (inotify for file watches, an
+ * eventfd for shutdown). Streams epoll cannot watch, such as stdin redirected from
+ * a regular file, are read directly on the same thread, one chunk per loop.
+ *
+ * Elsewhere each stream gets a blocking reader that is cancelled on Stop(); file
+ * watches are not available there. Stdin is usually an anonymous pipe, which cannot
+ * be opened for overlapped I/O, so it cannot join a completion port; a reader
+ * thread per stream is the price of that.
+ *
+ * Sources are registered before Start(). Handlers run on the reactor thread.
+ */
+class IoReactor {
+public:
+    using Clock = std::chrono::steady_clock;
+#ifdef _WIN32
+    using NativeHandle = void*;
+#else
+    using NativeHandle = int;
+#endif
+    // size == 0 means the stream reached EOF and was removed
+    using StreamHandler = std::function<void(const char* data, size_t size, Clock::time_point arrival)>;
+    using FileHandler = std::function<void(Clock::time_point arrival)>;
+
+    struct SourceStats {
+        std::string name;
+        uint64_t events;
+        uint64_t bytes;
+        float maxDispatchMs;     // wakeup -> handler returned
+        uint64_t consumed;
+        float avgConsumeMs;      // wakeup -> ReportConsumed()
+        float maxConsumeMs;
+    };
+
+    IoReactor();
+    ~IoReactor();
+
+    static NativeHandle StdinHandle();
+
+    // Returns a source id for ReportConsumed()/stats, or -1 on failure
+    int AddStream(const std::string& name, NativeHandle handle, StreamHandler handler);
+    int AddFileWatch(const std::string& name, const std::string& path, FileHandler handler);
+
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return running; }
+
+    // Called by whoever finally uses data that arrived at `arrival` (any thread)
+    void ReportConsumed(int sourceId, Clock::time_point arrival);
+
+    // Snapshot of per-source counters; reset clears them for the next interval
+    std::vector<SourceStats> GetStats(bool reset);
+
+private:
+    enum class SourceKind { Stream, FileWatch };
+
+    struct Source {
+        std::string name;
+        SourceKind kind;
+        NativeHandle handle;
+        std::string path;
+        StreamHandler onData;
+        FileHandler onChange;
+        bool open = true;
+        bool direct = false;     // not pollable (regular file); read until EOF without waiting
+        std::atomic<bool> readerDone{ true };
+
+        std::atomic<uint64_t> events{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> maxDispatchUs{ 0 };
+        std::atomic<uint64_t> consumed{ 0 };
+        std::atomic<uint64_t> totalConsumeUs{ 0 };
+        std::atomic<uint64_t> maxConsumeUs{ 0 };
+    };
+
+    std::vector<std::unique_ptr<Source>> sources;
+    std::atomic<bool> running;
+    std::atomic<bool> stopRequested;
+
+#ifdef __linux__
+    int epollFd;
+    int wakeFd;
+    int inotifyFd;
+    std::thread thread;
+
+    void Run();
+    void ReadStream(Source& source, char* chunk, size_t size, Clock::time_point arrival);
+    void DrainInotify(Clock::time_point arrival);
+#else
+    std::vector<std::thread> readers;
+    std::vector<Source*> readerSources;
+
+    void RunStream(Source* source);
+#endif
+
+    void DispatchStream(Source& source, const char* data, size_t size, Clock::time_point arrival);
+    static void UpdateMax(std::atomic<uint64_t>& target, uint64_t value);
+};
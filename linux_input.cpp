@@ -0,0 +1,199 @@
+#include "linux_input.h"
+#include "input_injector.h"
+
+#if defined(__linux__)
+#include "async_logger.h"
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Loaded at runtime so the binary does not link against X11; the display stays opaque
+using XOpenDisplayProc = void* (*)(const char* name);
+using XCloseDisplayProc = int (*)(void* display);
+using XFlushProc = int (*)(void* display);
+using XTestQueryExtensionProc = int (*)(void* display, int* eventBase, int* errorBase, int* major, int* minor);
+using XTestFakeMotionEventProc = int (*)(void* display, int screen, int x, int y, unsigned long delay);
+using XTestFakeButtonEventProc = int (*)(void* display, unsigned int button, int isPress, unsigned long delay);
+
+class XTestInputBackend : public InputBackend {
+public:
+    ~XTestInputBackend() override {
+        if (display) closeDisplay(display);
+        if (xtst) dlclose(xtst);
+        if (x11) dlclose(x11);
+    }
+
+    bool Open() {
+        x11 = dlopen("libX11.so.6", RTLD_NOW | RTLD_LOCAL);
+        xtst = dlopen("libXtst.so.6", RTLD_NOW | RTLD_LOCAL);
+        if (!x11 || !xtst) return false;
+
+        auto openDisplay = reinterpret_cast<XOpenDisplayProc>(dlsym(x11, "XOpenDisplay"));
+        closeDisplay = reinterpret_cast<XCloseDisplayProc>(dlsym(x11, "XCloseDisplay"));
+        flush = reinterpret_cast<XFlushProc>(dlsym(x11, "XFlush"));
+        auto queryExtension = reinterpret_cast<XTestQueryExtensionProc>(dlsym(xtst, "XTestQueryExtension"));
+        fakeMotion = reinterpret_cast<XTestFakeMotionEventProc>(dlsym(xtst, "XTestFakeMotionEvent"));
+        fakeButton = reinterpret_cast<XTestFakeButtonEventProc>(dlsym(xtst, "XTestFakeButtonEvent"));
+        if (!openDisplay || !closeDisplay || !flush || !queryExtension || !fakeMotion || !fakeButton) {
+            return false;
+        }
+
+        display = openDisplay(nullptr);
+        if (!display) return false;
+        int eventBase, errorBase, major, minor;
+        return queryExtension(display, &eventBase, &errorBase, &major, &minor) != 0;
+    }
+
+    const char* GetName() const override { return "XTest"; }
+
+    bool Inject(const InputEvent* events, size_t count) override {
+        // Requests are buffered by Xlib; the whole batch goes out in one flush
+        for (size_t i = 0; i < count; i++) {
+            const InputEvent& event = events[i];
+            if (event.x != lastX || event.y != lastY) {
+                fakeMotion(display, -1, event.x, event.y, 0);
+                lastX = event.x;
+                lastY = event.y;
+            }
+            if (event.type != InputEvent::Type::Move && event.button != InputButton::None) {
+                unsigned int button = event.button == InputButton::Left ? 1 : 3;
+                fakeButton(display, button, event.type == InputEvent::Type::ButtonDown, 0);
+            }
+        }
+        return flush(display) != 0;
+    }
+
+private:
+    void* x11 = nullptr;
+    void* xtst = nullptr;
+    void* display = nullptr;
+    XCloseDisplayProc closeDisplay = nullptr;
+    XFlushProc flush = nullptr;
+    XTestFakeMotionEventProc fakeMotion = nullptr;
+    XTestFakeButtonEventProc fakeButton = nullptr;
+    int lastX = INT_MIN;
+    int lastY = INT_MIN;
+};
+
+// Virtual absolute pointer whose axes span the desktop in pixels
+class UinputInputBackend : public InputBackend {
+public:
+    ~UinputInputBackend() override {
+        if (fd >= 0) {
+            ioctl(fd, UI_DEV_DESTROY);
+            close(fd);
+        }
+    }
+
+    bool Open(int width, int height) {
+        fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        bool ok = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 &&
+            ioctl(fd, UI_SET_KEYBIT, BTN_LEFT) == 0 &&
+            ioctl(fd, UI_SET_KEYBIT, BTN_RIGHT) == 0 &&
+            ioctl(fd, UI_SET_EVBIT, EV_ABS) == 0 &&
+            ioctl(fd, UI_SET_ABSBIT, ABS_X) == 0 &&
+            ioctl(fd, UI_SET_ABSBIT, ABS_Y) == 0;
+
+        uinput_abs_setup axis = {};
+        axis.code = ABS_X;
+        axis.absinfo.maximum = width - 1;
+        ok = ok && ioctl(fd, UI_ABS_SETUP, &axis) == 0;
+        axis.code = ABS_Y;
+        axis.absinfo.maximum = height - 1;
+        ok = ok && ioctl(fd, UI_ABS_SETUP, &axis) == 0;
+
+        uinput_setup setup = {};
+        setup.id.bustype = BUS_VIRTUAL;
+        setup.id.vendor = 0x1209;
+        setup.id.product = 0x0001;
+        std::snprintf(setup.name, UINPUT_MAX_NAME_SIZE, "VRenv virtual pointer");
+        ok = ok && ioctl(fd, UI_DEV_SETUP, &setup) == 0 && ioctl(fd, UI_DEV_CREATE) == 0;
+        if (!ok) {
+            close(fd);
+            fd = -1;
+        }
+        return ok;
+    }
+
+    const char* GetName() const override { return "uinput"; }
+
+    bool Inject(const InputEvent* events, size_t count) override {
+        buffer.clear();
+        for (size_t i = 0; i < count; i++) {
+            const InputEvent& event = events[i];
+            if (event.x != lastX) {
+                Append(EV_ABS, ABS_X, event.x);
+                lastX = event.x;
+            }
+            if (event.y != lastY) {
+                Append(EV_ABS, ABS_Y, event.y);
+                lastY = event.y;
+            }
+            if (event.type != InputEvent::Type::Move && event.button != InputButton::None) {
+                Append(EV_KEY, event.button == InputButton::Left ? BTN_LEFT : BTN_RIGHT,
+                    event.type == InputEvent::Type::ButtonDown ? 1 : 0);
+            }
+            // One report per event, so a press and its release are never merged
+            Append(EV_SYN, SYN_REPORT, 0);
+        }
+        size_t bytes = buffer.size() * sizeof(input_event);
+        return write(fd, buffer.data(), bytes) == static_cast<ssize_t>(bytes);
+    }
+
+private:
+    int fd = -1;
+    std::vector<input_event> buffer;
+    int lastX = INT_MIN;
+    int lastY = INT_MIN;
+
+    void Append(int type, int code, int value) {
+        input_event event = {};
+        event.type = static_cast<unsigned short>(type);
+        event.code = static_cast<unsigned short>(code);
+        event.value = value;
+        buffer.push_back(event);
+    }
+};
+
+// "width,height" of the first framebuffer, which is what the compositor spans the pointer over
+bool FramebufferSize(int& width, int& height) {
+    FILE* file = std::fopen("/sys/class/graphics/fb0/virtual_size", "r");
+    if (!file) return false;
+    bool ok = std::fscanf(file, "%d,%d", &width, &height) == 2 && width > 1 && height > 1;
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace
+
+std::unique_ptr<InputBackend> CreateLinuxInputBackend() {
+    auto xtest = std::make_unique<XTestInputBackend>();
+    if (xtest->Open()) {
+        return xtest;
+    }
+
+    int width = 0;
+    int height = 0;
+    if (!FramebufferSize(width, height)) {
+        VR_LOG_WARN(LogChannel::Main, "No X display and no framebuffer size, input injection disabled");
+        return nullptr;
+    }
+    auto uinput = std::make_unique<UinputInputBackend>();
+    if (uinput->Open(width, height)) {
+        return uinput;
+    }
+    VR_LOG_WARN(LogChannel::Main, "Cannot create a uinput device, input injection disabled");
+    return nullptr;
+}
+
+#endif
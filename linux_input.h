@@ -0,0 +1,9 @@
+#pragma once
+
+#include <memory>
+
+class InputBackend;
+
+// X11 XTest backend when a display is reachable (libXtst is loaded at runtime), otherwise a
+// uinput absolute pointer sized to the framebuffer; null if neither is available
+std::unique_ptr<InputBackend> CreateLinuxInputBackend();
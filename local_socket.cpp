@@ -0,0 +1,238 @@
+#include "local_socket.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+#ifdef _WIN32
+bool StartWinsock() {
+    // Never cleaned up; the servers live as long as the process
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+SOCKET NewSocket(int family) {
+    if (!StartWinsock()) return INVALID_SOCKET;
+    return WSASocketW(family, SOCK_STREAM, 0, nullptr, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_NO_HANDLE_INHERIT);
+}
+
+bool SetNonBlocking(SOCKET socket) {
+    u_long mode = 1;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+}
+#else
+bool SetNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+} // namespace
+
+SocketHandle ListenLocalSocket(const std::string& path, int backlog, bool nonBlocking) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+#ifdef _WIN32
+        WSASetLastError(WSAENAMETOOLONG);
+#else
+        errno = ENAMETOOLONG;
+#endif
+        return kInvalidSocket;
+    }
+    std::copy(path.begin(), path.end(), address.sun_path);
+    RemoveSocketPath(path);
+
+#ifdef _WIN32
+    SOCKET listener = NewSocket(AF_UNIX);
+    if (listener == INVALID_SOCKET) return kInvalidSocket;
+#else
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0) return kInvalidSocket;
+#endif
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, backlog) != 0 ||
+        (nonBlocking && !SetNonBlocking(listener))) {
+        int error = LastSocketError();
+        CloseSocket(listener);
+#ifdef _WIN32
+        WSASetLastError(error);
+#else
+        errno = error;
+#endif
+        return kInvalidSocket;
+    }
+    return listener;
+}
+
+SocketHandle AcceptLocalSocket(SocketHandle listener, bool nonBlocking) {
+#ifdef _WIN32
+    // An accepted socket inherits the listener's blocking mode, so set it either way
+    SOCKET client = accept(listener, nullptr, nullptr);
+    if (client == INVALID_SOCKET) return kInvalidSocket;
+    u_long mode = nonBlocking ? 1 : 0;
+    ioctlsocket(client, FIONBIO, &mode);
+    SetHandleInformation(reinterpret_cast<HANDLE>(client), HANDLE_FLAG_INHERIT, 0);
+    return client;
+#else
+    return accept4(listener, nullptr, nullptr, SOCK_CLOEXEC | (nonBlocking ? SOCK_NONBLOCK : 0));
+#endif
+}
+
+void CloseSocket(SocketHandle socket) {
+    if (socket == kInvalidSocket) return;
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+void RemoveSocketPath(const std::string& path) {
+#ifdef _WIN32
+    DeleteFileA(path.c_str());
+#else
+    unlink(path.c_str());
+#endif
+}
+
+bool OpenWakePair(SocketHandle pair[2]) {
+    pair[0] = pair[1] = kInvalidSocket;
+#ifdef _WIN32
+    // Winsock has no socketpair(); connect two loopback TCP sockets through a
+    // listener that only lives for the handshake
+    SOCKET listener = NewSocket(AF_INET);
+    if (listener == INVALID_SOCKET) return false;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int length = sizeof(address);
+    bool ok = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0 &&
+        listen(listener, 1) == 0;
+    if (ok) {
+        pair[1] = NewSocket(AF_INET);
+        ok = pair[1] != INVALID_SOCKET &&
+            connect(pair[1], reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+    if (ok) {
+        pair[0] = AcceptLocalSocket(listener, true);
+        ok = pair[0] != kInvalidSocket && SetNonBlocking(pair[1]);
+    }
+    closesocket(listener);
+#else
+    int fds[2];
+    bool ok = socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) == 0;
+    if (ok) {
+        pair[0] = fds[0];
+        pair[1] = fds[1];
+    }
+#endif
+    if (!ok) {
+        CloseSocket(pair[0]);
+        CloseSocket(pair[1]);
+        pair[0] = pair[1] = kInvalidSocket;
+    }
+    return ok;
+}
+
+void SignalWake(SocketHandle writeEnd) {
+    // A full buffer means a wake is already pending
+    char byte = 0;
+    SendSocket(writeEnd, &byte, 1);
+}
+
+void DrainWake(SocketHandle readEnd) {
+    char buffer[64];
+    while (ReceiveSocket(readEnd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+long SendSocket(SocketHandle socket, const void* data, size_t size) {
+#ifdef _WIN32
+    int chunk = static_cast<int>(std::min<size_t>(size, INT_MAX));
+    return send(socket, static_cast<const char*>(data), chunk, 0);
+#else
+    return static_cast<long>(send(socket, data, size, MSG_NOSIGNAL));
+#endif
+}
+
+long ReceiveSocket(SocketHandle socket, void* buffer, size_t size) {
+#ifdef _WIN32
+    int chunk = static_cast<int>(std::min<size_t>(size, INT_MAX));
+    return recv(socket, static_cast<char*>(buffer), chunk, 0);
+#else
+    return static_cast<long>(recv(socket, buffer, size, 0));
+#endif
+}
+
+void SetSendTimeout(SocketHandle socket, int timeoutMs) {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(timeoutMs);
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+    timeval timeout = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#endif
+}
+
+bool PollSockets(std::vector<SocketPollEntry>& entries, int timeoutMs) {
+    thread_local std::vector<pollfd> native;
+    native.clear();
+    for (const auto& entry : entries) {
+        pollfd fd = {};
+        fd.fd = entry.socket;
+        fd.events = static_cast<short>((entry.wantRead ? POLLIN : 0) | (entry.wantWrite ? POLLOUT : 0));
+        native.push_back(fd);
+    }
+
+#ifdef _WIN32
+    int result = WSAPoll(native.data(), static_cast<ULONG>(native.size()), timeoutMs);
+#else
+    int result = poll(native.data(), native.size(), timeoutMs);
+#endif
+    bool interrupted = result < 0 && SocketWouldBlock();
+    for (size_t i = 0; i < entries.size(); i++) {
+        short revents = result > 0 ? native[i].revents : 0;
+        entries[i].readable = (revents & POLLIN) != 0;
+        entries[i].writable = (revents & POLLOUT) != 0;
+        entries[i].failed = (revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+    }
+    return result >= 0 || interrupted;
+}
+
+int LastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool SocketWouldBlock() {
+    int error = LastSocketError();
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK || error == WSAEINTR;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+}
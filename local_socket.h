@@ -0,0 +1,60 @@
+#pragma once
+
+// No raylib and no windows.h here; the platform headers stay in local_socket.cpp
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Unix domain stream sockets for the local servers (metrics, encoded stream).
+ * Linux uses the BSD calls and poll(); Windows 10 1803 and later has AF_UNIX in
+ * Winsock, multiplexed with WSAPoll. WSAPoll only takes sockets, so the pair that
+ * wakes a sleeping server is a socket pair on both.
+ *
+ * Every socket is created non-inheritable. Listening and accepted sockets are
+ * blocking unless nonBlocking is passed; wake pairs are always non-blocking.
+ */
+#ifdef _WIN32
+using SocketHandle = uintptr_t;  // SOCKET
+constexpr SocketHandle kInvalidSocket = ~static_cast<SocketHandle>(0);
+#else
+using SocketHandle = int;
+constexpr SocketHandle kInvalidSocket = -1;
+#endif
+
+struct SocketPollEntry {
+    SocketHandle socket = kInvalidSocket;
+    bool wantRead = false;
+    bool wantWrite = false;
+    // Filled in by PollSockets
+    bool readable = false;
+    bool writable = false;
+    bool failed = false;  // hung up, errored or not a socket
+};
+
+// Removes a socket file left by a previous run, then binds and listens on path.
+// Returns kInvalidSocket on failure, with the reason in LastSocketError().
+SocketHandle ListenLocalSocket(const std::string& path, int backlog, bool nonBlocking);
+SocketHandle AcceptLocalSocket(SocketHandle listener, bool nonBlocking);
+void CloseSocket(SocketHandle socket);
+void RemoveSocketPath(const std::string& path);
+
+// A connected pair: Signal on pair[1] makes pair[0] readable until it is drained
+bool OpenWakePair(SocketHandle pair[2]);
+void SignalWake(SocketHandle writeEnd);
+void DrainWake(SocketHandle readEnd);
+
+// Never raises SIGPIPE. Negative on error; see SocketWouldBlock.
+long SendSocket(SocketHandle socket, const void* data, size_t size);
+long ReceiveSocket(SocketHandle socket, void* buffer, size_t size);
+void SetSendTimeout(SocketHandle socket, int timeoutMs);
+
+// timeoutMs < 0 waits forever. False only on a real failure; an interrupted wait
+// returns true with nothing ready.
+bool PollSockets(std::vector<SocketPollEntry>& entries, int timeoutMs);
+
+// errno or WSAGetLastError() of the last failed call on this thread
+int LastSocketError();
+// The last call failed only because it would have blocked or was interrupted
+bool SocketWouldBlock();
@@ -0,0 +1,264 @@
+#include "metrics_registry.h"
+#include "thread_topology.h"
+#include "async_logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+std::string FormatValue(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+// HELP text may not contain raw backslashes or newlines
+std::string EscapeHelp(const std::string& help) {
+    std::string escaped;
+    escaped.reserve(help.size());
+    for (char c : help) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+MetricHistogram::MetricHistogram(std::vector<double> upperBounds) : bounds(std::move(upperBounds)) {
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    buckets = std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1);
+    for (size_t i = 0; i <= bounds.size(); i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::Observe(double value) {
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+MetricHistogram::Snapshot MetricHistogram::Read() const {
+    Snapshot snapshot;
+    snapshot.cumulative.resize(bounds.size() + 1);
+    uint64_t total = 0;
+    for (size_t i = 0; i <= bounds.size(); i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+        snapshot.cumulative[i] = total;
+    }
+    snapshot.sum = sum.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+std::vector<double> MetricHistogram::ExponentialBounds(double start, double factor, int count) {
+    std::vector<double> result;
+    result.reserve(std::max(0, count));
+    for (int i = 0; i < count; i++) {
+        result.push_back(start);
+        start *= factor;
+    }
+    return result;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::FindOrAdd(const std::string& name, const std::string& help, Kind kind) {
+    for (auto& entry : entries) {
+        if (entry->name == name && entry->kind == kind) return *entry;
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->kind = kind;
+    entries.push_back(std::move(entry));
+    return *entries.back();
+}
+
+MetricCounter& MetricsRegistry::Counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = FindOrAdd(name, help, Kind::Counter);
+    if (!entry.counter) entry.counter = std::make_unique<MetricCounter>();
+    return *entry.counter;
+}
+
+MetricGauge& MetricsRegistry::Gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = FindOrAdd(name, help, Kind::Gauge);
+    if (!entry.gauge) entry.gauge = std::make_unique<MetricGauge>();
+    return *entry.gauge;
+}
+
+MetricHistogram& MetricsRegistry::Histogram(const std::string& name, const std::string& help, std::vector<double> upperBounds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = FindOrAdd(name, help, Kind::Histogram);
+    if (!entry.histogram) entry.histogram = std::make_unique<MetricHistogram>(std::move(upperBounds));
+    return *entry.histogram;
+}
+
+std::string MetricsRegistry::RenderPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string text;
+    for (const auto& entry : entries) {
+        text += "# HELP " + entry->name + " " + EscapeHelp(entry->help) + "\n";
+        switch (entry->kind) {
+        case Kind::Counter:
+            text += "# TYPE " + entry->name + " counter\n";
+            text += entry->name + " " + std::to_string(entry->counter->Get()) + "\n";
+            break;
+        case Kind::Gauge:
+            text += "# TYPE " + entry->name + " gauge\n";
+            text += entry->name + " " + FormatValue(entry->gauge->Get()) + "\n";
+            break;
+        case Kind::Histogram: {
+            text += "# TYPE " + entry->name + " histogram\n";
+            const auto& bounds = entry->histogram->GetBounds();
+            auto snapshot = entry->histogram->Read();
+            for (size_t i = 0; i < bounds.size(); i++) {
+                text += entry->name + "_bucket{le=\"" + FormatValue(bounds[i]) + "\"} " +
+                    std::to_string(snapshot.cumulative[i]) + "\n";
+            }
+            text += entry->name + "_bucket{le=\"+Inf\"} " + std::to_string(snapshot.cumulative.back()) + "\n";
+            text += entry->name + "_sum " + FormatValue(snapshot.sum) + "\n";
+            text += entry->name + "_count " + std::to_string(snapshot.cumulative.back()) + "\n";
+            break;
+        }
+        }
+    }
+    return text;
+}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+bool MetricsExporter::Start(const std::string& file, const std::string& socket, std::chrono::milliseconds period) {
+    if (worker.joinable()) return false;
+    filePath = file;
+    socketPath = socket;
+    interval = std::max(period, std::chrono::milliseconds(100));
+    stopping = false;
+
+    if (!socketPath.empty()) {
+        listenSocket = ListenLocalSocket(socketPath, 4, false);
+        if (listenSocket == kInvalidSocket || !OpenWakePair(wakeSockets)) {
+            VR_LOG_WARN(LogChannel::Main, "Metrics socket {} unavailable (error {})", socketPath, LastSocketError());
+            if (listenSocket != kInvalidSocket) {
+                CloseSocket(listenSocket);
+                RemoveSocketPath(socketPath);
+            }
+            listenSocket = kInvalidSocket;
+        }
+    }
+    if (listenSocket == kInvalidSocket) socketPath.clear();
+    if (filePath.empty() && socketPath.empty()) return false;
+
+    worker = std::thread(&MetricsExporter::Run, this);
+    return true;
+}
+
+void MetricsExporter::Stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (wakeSockets[1] != kInvalidSocket) SignalWake(wakeSockets[1]);
+    worker.join();
+
+    // The last values of a short run still reach the file
+    if (!filePath.empty()) WriteFile();
+    if (listenSocket != kInvalidSocket) {
+        CloseSocket(listenSocket);
+        RemoveSocketPath(socketPath);
+        listenSocket = kInvalidSocket;
+    }
+    for (SocketHandle& socket : wakeSockets) {
+        CloseSocket(socket);
+        socket = kInvalidSocket;
+    }
+}
+
+void MetricsExporter::Run() {
+    AsyncLogger::instance().registerThread();
+    ThreadTopology::Scope threadScope("metrics");
+    VR_LOG_INFO(LogChannel::Main, "Metrics export: file={} socket={} interval_ms={}",
+        filePath.empty() ? "-" : filePath, socketPath.empty() ? "-" : socketPath, static_cast<int>(interval.count()));
+
+    std::vector<SocketPollEntry> polled(2);
+    polled[0].wantRead = true;
+    polled[1].wantRead = true;
+    auto nextWrite = std::chrono::steady_clock::now();
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (!filePath.empty() && now >= nextWrite) {
+            WriteFile();
+            nextWrite = now + interval;
+        }
+
+        if (listenSocket != kInvalidSocket) {
+            // Sleeps until a scraper connects, the next file write is due, or Stop
+            int timeoutMs = -1;
+            if (!filePath.empty()) {
+                timeoutMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(
+                    nextWrite - std::chrono::steady_clock::now()).count());
+                timeoutMs = std::max(timeoutMs, 0);
+            }
+            polled[0].socket = wakeSockets[0];
+            polled[1].socket = listenSocket;
+            if (!PollSockets(polled, timeoutMs)) {
+                VR_LOG_ERROR(LogChannel::Main, "Metrics socket poll failed (error {})", LastSocketError());
+                break;
+            }
+            if (polled[0].readable || polled[0].failed) break;
+            if (polled[1].readable) {
+                SocketHandle client = AcceptLocalSocket(listenSocket, false);
+                if (client != kInvalidSocket) ServeClient(client);
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (wake.wait_until(lock, nextWrite, [this] { return stopping; })) break;
+    }
+}
+
+void MetricsExporter::WriteFile() {
+    // Written beside the target so the rename stays on one filesystem
+    std::string temporary = filePath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out << MetricsRegistry::instance().RenderPrometheus();
+        if (!out.good()) {
+            VR_LOG_WARN(LogChannel::Main, "Failed to write metrics to {}", temporary);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, filePath, error);
+    if (error) {
+        VR_LOG_WARN(LogChannel::Main, "Failed to publish metrics file {}: {}", filePath, error.message());
+    }
+}
+
+void MetricsExporter::ServeClient(SocketHandle client) {
+    // A scraper that stops reading cannot hold up the exporter for long
+    SetSendTimeout(client, 1000);
+
+    std::string text = MetricsRegistry::instance().RenderPrometheus();
+    size_t sent = 0;
+    while (sent < text.size()) {
+        long written = SendSocket(client, text.data() + sent, text.size() - sent);
+        if (written <= 0) break;
+        sent += static_cast<size_t>(written);
+    }
+    CloseSocket(client);
+}
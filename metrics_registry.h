@@ -0,0 +1,123 @@
+#pragma once
+
+// No raylib and no windows.h here: stages on both sides of that split record into it
+#include "local_socket.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Monotonic count, e.g. frames captured
+class MetricCounter {
+public:
+    void Add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t Get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{ 0 };
+};
+
+// Last sampled value, e.g. a queue depth
+class MetricGauge {
+public:
+    void Set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+    double Get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value{ 0.0 };
+};
+
+// Fixed-bucket distribution, e.g. encode time in ms. Observe is two relaxed atomic
+// adds after a search over the bucket bounds.
+class MetricHistogram {
+public:
+    struct Snapshot {
+        std::vector<uint64_t> cumulative;  // per upper bound, the last entry being +Inf
+        double sum = 0.0;
+    };
+
+    explicit MetricHistogram(std::vector<double> upperBounds);
+
+    void Observe(double value);
+    Snapshot Read() const;
+    const std::vector<double>& GetBounds() const { return bounds; }
+
+    // count bounds starting at start, each factor times the previous one
+    static std::vector<double> ExponentialBounds(double start, double factor, int count);
+
+private:
+    std::vector<double> bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;  // bounds.size() + 1, not cumulative
+    std::atomic<double> sum{ 0.0 };
+};
+
+/**
+ * Process-wide set of named metrics, rendered in the Prometheus text exposition
+ * format. Registration takes a lock and returns a reference that stays valid for
+ * the life of the process, so a stage looks its metrics up once and updates them
+ * lock-free from then on. Registering an existing name returns the existing metric.
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    MetricCounter& Counter(const std::string& name, const std::string& help);
+    MetricGauge& Gauge(const std::string& name, const std::string& help);
+    MetricHistogram& Histogram(const std::string& name, const std::string& help, std::vector<double> upperBounds);
+
+    std::string RenderPrometheus() const;
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        Kind kind;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Entry>> entries;
+
+    MetricsRegistry() = default;
+    Entry& FindOrAdd(const std::string& name, const std::string& help, Kind kind);
+};
+
+/**
+ * Publishes MetricsRegistry for a scraper. A file is rewritten every interval
+ * through a temporary file and a rename, so a reader (e.g. node_exporter's
+ * textfile collector) never sees half of it. A Unix socket can be served as well
+ * (on Windows through Winsock AF_UNIX): every connection receives the current
+ * text and is closed.
+ */
+class MetricsExporter {
+public:
+    ~MetricsExporter();
+
+    // Either path may be empty; returns false if neither could be set up
+    bool Start(const std::string& filePath, const std::string& socketPath, std::chrono::milliseconds interval);
+    void Stop();
+
+private:
+    std::string filePath;
+    std::string socketPath;
+    std::chrono::milliseconds interval{ 5000 };
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    SocketHandle listenSocket = kInvalidSocket;
+    SocketHandle wakeSockets[2] = { kInvalidSocket, kInvalidSocket };
+
+    void Run();
+    void WriteFile();
+    void ServeClient(SocketHandle client);
+};
@@ -0,0 +1,81 @@
+#include "motion_history.h"
+#include <cmath>
+#include <raymath.h>
+
+MotionHistory::MotionHistory() {
+    head = 0;
+    count = 0;
+    velocity = { 0, 0, 0 };
+    acceleration = { 0, 0, 0 };
+    opennessRate = 0.0f;
+    maxGap = 0.25;
+    smoothingTime = 0.05f;
+}
+
+void MotionHistory::Clear() {
+    head = 0;
+    count = 0;
+    velocity = { 0, 0, 0 };
+    acceleration = { 0, 0, 0 };
+    opennessRate = 0.0f;
+}
+
+const MotionSample& MotionHistory::At(size_t age) const {
+    return samples[(head + kCapacity - age) % kCapacity];
+}
+
+double MotionHistory::Span() const {
+    if (count < 2) return 0.0;
+    return Latest().time - At(count - 1).time;
+}
+
+const MotionSample& MotionHistory::WindowStart(double window) const {
+    double cutoff = Latest().time - window;
+    size_t age = 0;
+    while (age + 1 < count && At(age + 1).time >= cutoff) {
+        age++;
+    }
+    return At(age);
+}
+
+MotionHistory::OpennessRange MotionHistory::GetOpennessRange(double window) const {
+    OpennessRange range = { Latest().openness, Latest().openness };
+    double cutoff = Latest().time - window;
+    for (size_t age = 1; age < count && At(age).time >= cutoff; age++) {
+        range.min = fminf(range.min, At(age).openness);
+        range.max = fmaxf(range.max, At(age).openness);
+    }
+    return range;
+}
+
+void MotionHistory::Push(const Vector3& position, float openness, double time) {
+    if (count > 0) {
+        double gap = time - Latest().time;
+        if (gap > maxGap || gap < 0.0) {
+            Clear();
+        }
+        else if (gap <= 0.0) {
+            return;  // duplicate timestamp adds no information
+        }
+    }
+
+    if (count > 0) {
+        const MotionSample& prev = Latest();
+        float dt = static_cast<float>(time - prev.time);
+        // Exponential smoothing with a fixed time constant, independent of the sample rate
+        float alpha = 1.0f - expf(-dt / smoothingTime);
+
+        Vector3 instantVelocity = Vector3Scale(Vector3Subtract(position, prev.position), 1.0f / dt);
+        Vector3 newVelocity = (count == 1) ? instantVelocity : Vector3Lerp(velocity, instantVelocity, alpha);
+        Vector3 instantAcceleration = Vector3Scale(Vector3Subtract(newVelocity, velocity), 1.0f / dt);
+        acceleration = (count == 1) ? Vector3{ 0, 0, 0 } : Vector3Lerp(acceleration, instantAcceleration, alpha);
+        velocity = newVelocity;
+
+        float instantOpenness = (openness - prev.openness) / dt;
+        opennessRate = (count == 1) ? instantOpenness : opennessRate + (instantOpenness - opennessRate) * alpha;
+    }
+
+    head = (head + 1) % kCapacity;
+    samples[head] = { position, openness, time };
+    if (count < kCapacity) count++;
+}
@@ -0,0 +1,65 @@
+#ifndef MOTION_HISTORY_H
+#define MOTION_HISTORY_H
+
+#include "raylib.h"
+#include <cstddef>
+
+struct MotionSample {
+    Vector3 position;   // wrist, world space
+    float openness;     // HandFeatures::openness at this time
+    double time;        // seconds
+};
+
+// Fixed-capacity ring of timestamped wrist samples. Velocity, acceleration and the
+// openness rate are updated incrementally on every push with time-constant smoothing,
+// so they do not depend on how often samples arrive.
+class MotionHistory {
+public:
+    // Longest window a gesture may look back over, at the fastest tracker rate we
+    // expect; the ring holds all of it, so a window is never cut short by capacity
+    static constexpr float kMaxWindow = 1.0f;      // seconds
+    static constexpr float kMaxSampleRate = 240.0f;  // Hz
+    static constexpr size_t kCapacity = static_cast<size_t>(kMaxWindow * kMaxSampleRate) + 1;
+
+    struct OpennessRange {
+        float min;
+        float max;
+    };
+
+    MotionHistory();
+
+    void Push(const Vector3& position, float openness, double time);
+    void Clear();
+
+    size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    double Span() const;  // seconds between oldest and newest sample
+
+    const MotionSample& Latest() const { return At(0); }
+    const MotionSample& At(size_t age) const;  // 0 = newest
+    // Oldest sample that is at most `window` seconds older than the newest one
+    const MotionSample& WindowStart(double window) const;
+    // Lowest and highest openness over the last `window` seconds, newest sample included
+    OpennessRange GetOpennessRange(double window) const;
+
+    Vector3 GetVelocity() const { return velocity; }          // m/s
+    Vector3 GetAcceleration() const { return acceleration; }  // m/s^2
+    float GetOpennessRate() const { return opennessRate; }    // openness per second
+
+    // Samples further apart than this mean the hand was lost; history restarts
+    void SetMaxGap(double seconds) { maxGap = seconds; }
+    void SetSmoothingTime(float seconds) { smoothingTime = seconds; }
+
+private:
+    MotionSample samples[kCapacity];
+    size_t head;   // index of the newest sample
+    size_t count;
+
+    Vector3 velocity;
+    Vector3 acceleration;
+    float opennessRate;
+    double maxGap;
+    float smoothingTime;
+};
+
+#endif // MOTION_HISTORY_H
@@ -0,0 +1,13 @@
+#include "pixel_convert.h"
+#include <cstring>
+
+void SwizzleBgraToRgba(uint8_t* pixels, size_t pixelCount) {
+    // Whole pixels as little-endian words: keeps G and A, exchanges bytes 0 and 2.
+    // The compiler turns this loop into vector shuffles, unlike a per-byte std::swap.
+    for (size_t i = 0; i < pixelCount; i++) {
+        uint32_t pixel;
+        std::memcpy(&pixel, pixels + i * 4, sizeof(pixel));
+        pixel = (pixel & 0xFF00FF00u) | ((pixel >> 16) & 0xFFu) | ((pixel & 0xFFu) << 16);
+        std::memcpy(pixels + i * 4, &pixel, sizeof(pixel));
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// No windows.h here, so the conversion can be measured and reused off the capture path
+#include <cstddef>
+#include <cstdint>
+
+// Swaps the blue and red bytes of pixelCount 32-bit pixels in place, turning the
+// BGRA that GDI hands back into the RGBA the texture upload and encoder expect
+void SwizzleBgraToRgba(uint8_t* pixels, size_t pixelCount);
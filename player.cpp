@@ -1,17 +1,31 @@
 ﻿#include "player.h"
 #include "raymath.h"
+#include "head_pose_predictor.h"
+#include "stereo_scene.h"
 #include <cmath>
 #define DEGTORAD (PI / 180.0f)
 
+const int kHandConnections[kHandConnectionCount][2] = {
+    {0,1}, {1,2}, {2,3}, {3,4},
+    {0,5}, {5,6}, {6,7}, {7,8},
+    {0,9}, {9,10}, {10,11}, {11,12},
+    {0,13}, {13,14}, {14,15}, {15,16},
+    {0,17}, {17,18}, {18,19}, {19,20},
+    {5,9}, {9,13}, {13,17}
+};
 
 Player::Player() {
     position = { 0.0f, 1.6f, 0.0f };
-    rotation = { 0.0f, 0.0f,0.0f };
+    orientation = QuaternionIdentity();
     camera = { 0 };
     camera.fovy = 90.0f;
     camera.up = { 0.0f, 1.0f, 0.0f };
     camera.projection = CAMERA_PERSPECTIVE;
 
+    panelPos = { 0 };
+    panelSize = { 0 };
+    panelRevision = 0;
+    handRevision = 0;
     laserUV = { 0 };
     laserIntersecting = false;
 
@@ -23,40 +37,34 @@ Player::Player() {
 }
 
 void Player::SetYawPitchRoll(float yaw, float pitch, float roll) {
-	pitch = -pitch; 
-    yaw = -yaw;
-    pitch -= DEGTORAD * (90.f);
-    while (yaw > 2.0f * PI) yaw -= 2.0f * PI;
-    while (yaw < 0.0f) yaw += 2.0f * PI;
-    if (yaw > PI) yaw -= 2.0f * PI;
-    pitch = Clamp(pitch, -2.0f*PI, PI *2.0f);
-	roll = Clamp(roll, -PI / 1.0f, PI / 1.0f); 
-    float smoothYaw = yaw, smoothPitch = pitch, smoothRoll = roll;
-    const float smoothingFactor = 0.15f;  // Adjust for more/less smoothing
-    smoothYaw = smoothYaw * (1.0f - smoothingFactor) + yaw * smoothingFactor;
-    smoothPitch = smoothPitch * (1.0f - smoothingFactor) + pitch * smoothingFactor;
-    smoothRoll = smoothRoll * (1.0f - smoothingFactor) + roll * smoothingFactor;
-    rotation = { smoothPitch,smoothYaw, smoothRoll };
+    SetOrientation(HeadOrientationFromGyro(yaw, pitch, roll));
+}
+
+void Player::SetOrientation(const Quaternion& q) {
+    orientation = QuaternionNormalize(q);
 }
 
 void Player::HandleMouseLook(Vector2 delta) {
-    rotation.y += delta.x * 0.003f;
-    rotation.x += delta.y * 0.003f;
+    // Yaw around world up, pitch around the head's own horizontal axis
+    Quaternion yawStep = QuaternionFromAxisAngle({ 0.0f, 1.0f, 0.0f }, -delta.x * 0.003f);
+    Quaternion pitchStep = QuaternionFromAxisAngle({ 0.0f, 0.0f, 1.0f }, delta.y * 0.003f);
+    orientation = QuaternionNormalize(QuaternionMultiply(yawStep, QuaternionMultiply(orientation, pitchStep)));
 }
 
 void Player::SetPanelInfo(const Vector3& pos, const Vector3& size) {
+    if (pos.x == panelPos.x && pos.y == panelPos.y && pos.z == panelPos.z &&
+        size.x == panelSize.x && size.y == panelSize.y && size.z == panelSize.z) {
+        return;
+    }
     panelPos = pos;
     panelSize = size;
+    panelRevision++;
 }
 
 void Player::Update() {
     camera.position = position;
 
-    Vector3 forward = {
-        cosf(rotation.y) * cosf(rotation.x),
-        sinf(rotation.x),
-        sinf(rotation.y) * cosf(rotation.x)
-    };
+    Vector3 forward = Vector3RotateByQuaternion({ 1.0f, 0.0f, 0.0f }, orientation);
     camera.target = Vector3Add(position, forward);
 }
 void Player::UpdateVRHand(VRHand& hand, const HandTrackingData& handData) {
@@ -175,16 +183,7 @@ void Player::DrawVRHand(const VRHand& hand) {
     }
 
     // Draw connections
-    const int connections[][2] = {
-        {0,1}, {1,2}, {2,3}, {3,4},
-        {0,5}, {5,6}, {6,7}, {7,8},
-        {0,9}, {9,10}, {10,11}, {11,12},
-        {0,13}, {13,14}, {14,15}, {15,16},
-        {0,17}, {17,18}, {18,19}, {19,20},
-        {5,9}, {9,13}, {13,17}
-    };
-
-    for (const auto& conn : connections) {
+    for (const auto& conn : kHandConnections) {
         if (hand.landmarks[conn[0]].active && hand.landmarks[conn[1]].active) {
             DrawLine3D(hand.landmarks[conn[0]].position,
                 hand.landmarks[conn[1]].position,
@@ -193,27 +192,75 @@ void Player::DrawVRHand(const VRHand& hand) {
     }
 }
 
-void Player::DrawHands(const std::vector<HandTrackingData>& hands) {
+void Player::UpdateHands(const std::vector<HandTrackingData>& hands) {
+    // World positions are camera-anchored, so compare the tracker landmarks instead;
+    // the frame tracker already sees head motion through the eye cameras
+    bool inputChanged = false;
+
     // Update left/right hand objects
     for (const auto& hand : hands) {
         if (hand.handedness == "Left") {
             UpdateVRHand(leftHand, hand);
+            inputChanged |= StoreHandInput(leftHandInput, hand);
         }
         else if (hand.handedness == "Right") {
             UpdateVRHand(rightHand, hand);
+            inputChanged |= StoreHandInput(rightHandInput, hand);
         }
     }
 
+    if (inputChanged) {
+        handRevision++;
+    }
+}
+
+bool Player::StoreHandInput(std::vector<Vector3>& stored, const HandTrackingData& handData) {
+    bool same = stored.size() == handData.landmarks.size();
+    for (size_t i = 0; same && i < stored.size(); i++) {
+        const Vector3& a = stored[i];
+        const Vector3& b = handData.landmarks[i];
+        same = a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+    if (same) return false;
+    stored = handData.landmarks;
+    return true;
+}
+
+void Player::DrawHands(const std::vector<HandTrackingData>& hands) {
+    UpdateHands(hands);
+
     // Draw both hands
     DrawVRHand(leftHand);
     DrawVRHand(rightHand);
 }
 
-void Player::DrawLaserPointer() {
+void Player::AppendHands(StereoSceneBatch& batch) const {
+    AppendVRHand(batch, leftHand);
+    AppendVRHand(batch, rightHand);
+}
+
+void Player::AppendVRHand(StereoSceneBatch& batch, const VRHand& hand) const {
+    if (!hand.is_tracked) return;
+
+    Color color = (hand.label == "Left") ? SKYBLUE : ORANGE;
+    for (const auto& lm : hand.landmarks) {
+        if (lm.active) {
+            float size = (lm.landmark_id == 0) ? 0.015f : 0.01f;
+            batch.Sphere(lm.position, size, color);
+        }
+    }
+    for (const auto& conn : kHandConnections) {
+        if (hand.landmarks[conn[0]].active && hand.landmarks[conn[1]].active) {
+            batch.Line(hand.landmarks[conn[0]].position, hand.landmarks[conn[1]].position, color);
+        }
+    }
+}
+
+bool Player::TraceLaser(Vector3& hit, Vector3& end) {
     Vector3 dir = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
     Ray ray = { camera.position, dir };
 
-    Vector3 hit = { 0 };
+    hit = { 0 };
     laserIntersecting = false;
 
     // Simple plane intersection (Z plane)
@@ -228,10 +275,25 @@ void Player::DrawLaserPointer() {
                 1.0f - (rel.y + panelSize.y / 2) / panelSize.y
             };
             laserIntersecting = true;
-            DrawSphere(hit, 0.015f, YELLOW);
         }
     }
 
-    Vector3 laserEnd = Vector3Add(ray.position, Vector3Scale(ray.direction, 100.0f));
-    DrawLine3D(ray.position, laserEnd, RED);
+    end = Vector3Add(ray.position, Vector3Scale(ray.direction, 100.0f));
+    return laserIntersecting;
+}
+
+void Player::DrawLaserPointer() {
+    Vector3 hit, laserEnd;
+    if (TraceLaser(hit, laserEnd)) {
+        DrawSphere(hit, 0.015f, YELLOW);
+    }
+    DrawLine3D(camera.position, laserEnd, RED);
+}
+
+void Player::AppendLaserPointer(StereoSceneBatch& batch) {
+    Vector3 hit, laserEnd;
+    if (TraceLaser(hit, laserEnd)) {
+        batch.Sphere(hit, 0.015f, YELLOW);
+    }
+    batch.Line(camera.position, laserEnd, RED);
 }
@@ -29,14 +29,27 @@ struct HandTrackingData {
     bool shoulder_calibrated;
 };
 
+// Landmark index pairs of the hand skeleton
+constexpr int kHandConnectionCount = 23;
+extern const int kHandConnections[kHandConnectionCount][2];
+
+class StereoSceneBatch;
+
 class Player {
 public:
     Player();
     VRHand leftHand;
     VRHand rightHand;
     void SetYawPitchRoll(float yaw, float pitch, float roll);
+    void SetOrientation(const Quaternion& q);
+    Quaternion GetOrientation() const { return orientation; }
     void HandleMouseLook(Vector2 delta);
     void SetPanelInfo(const Vector3& pos, const Vector3& size);
+    // Bumped whenever SetPanelInfo actually moves or resizes the panel
+    unsigned int GetPanelRevision() const { return panelRevision; }
+    // Bumped whenever UpdateHands receives tracker landmarks that differ from the last ones
+    // for that hand; head motion alone moves the hands in world space but does not bump it
+    unsigned int GetHandRevision() const { return handRevision; }
     void Update();
 	void UpdateVRHand(VRHand& hand, const HandTrackingData& handData);
     Camera3D GetLeftEyeCamera(float eyeSeparation);
@@ -44,16 +57,27 @@ public:
 	void DrawVRHand(const VRHand& hand);
     bool GetVRMouseData(Vector2& uv, bool& leftClick, bool& rightClick, bool& isDragging);
     Vector3 ComputeHandAnchorPosition(const std::string& handedness);
+    void UpdateHands(const std::vector<HandTrackingData>& hands);
     void DrawHands(const std::vector<HandTrackingData>& hands);
     void DrawLaserPointer();
+    // Single-pass stereo: same geometry as DrawVRHand/DrawLaserPointer, added to a batch
+    void AppendHands(StereoSceneBatch& batch) const;
+    void AppendLaserPointer(StereoSceneBatch& batch);
 
 private:
     Camera3D camera;
     Vector3 position;
-    Vector3 rotation;  // yaw, pitch, roll
-	float yaw, pitch, roll;
+    Quaternion orientation;  // head orientation, identity looks down +X
     Vector3 panelPos;
     Vector3 panelSize;
+    unsigned int panelRevision;
+    unsigned int handRevision;
+    std::vector<Vector3> leftHandInput;   // tracker-space landmarks behind handRevision
+    std::vector<Vector3> rightHandInput;
     Vector2 laserUV;
     bool laserIntersecting;
+
+    bool TraceLaser(Vector3& hit, Vector3& end);
+    static bool StoreHandInput(std::vector<Vector3>& stored, const HandTrackingData& handData);
+    void AppendVRHand(StereoSceneBatch& batch, const VRHand& hand) const;
 };
@@ -0,0 +1,199 @@
+#include "pose_reprojector.h"
+#include "async_logger.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// One triangle covering the whole target; no vertex buffer needed
+const char* kWarpVertexShader = R"(#version 330
+void main() {
+    vec2 corner = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1)) - 1.0;
+    gl_Position = vec4(corner, 0.0, 1.0);
+}
+)";
+
+const char* kWarpFragmentShader = R"(#version 330
+uniform sampler2D texture0;
+uniform mat4 deltaLeft;     // late view space -> render view space, rotation only
+uniform mat4 deltaRight;
+uniform vec4 viewportLeft;
+uniform vec4 viewportRight;
+uniform vec2 tanHalfFov;    // view-space extent of the eye's NDC square at z = -1
+uniform vec2 targetSize;
+
+out vec4 finalColor;
+
+bool Inside(vec2 p, vec4 viewport) {
+    return p.x >= viewport.x && p.y >= viewport.y && p.x < viewport.x + viewport.z && p.y < viewport.y + viewport.w;
+}
+
+void main() {
+    vec2 p = gl_FragCoord.xy;
+    vec4 viewport;
+    mat3 delta;
+    if (Inside(p, viewportLeft)) {
+        viewport = viewportLeft;
+        delta = mat3(deltaLeft);
+    }
+    else if (Inside(p, viewportRight)) {
+        viewport = viewportRight;
+        delta = mat3(deltaRight);
+    }
+    else {
+        finalColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // View ray of this pixel under the late pose, expressed in the rendered pose
+    vec2 ndc = (p - viewport.xy) / viewport.zw * 2.0 - 1.0;
+    vec3 ray = delta * vec3(ndc * tanHalfFov, -1.0);
+    vec2 source = (ray.xy / -ray.z) / tanHalfFov;
+
+    // Nothing was rendered there: behind the eye or past the edge of its frustum
+    if (ray.z > -1e-4 || abs(source.x) > 1.0 || abs(source.y) > 1.0) {
+        finalColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // Keep the bilinear footprint inside this eye's half of the target
+    vec2 pixel = viewport.xy + (source * 0.5 + 0.5) * viewport.zw;
+    pixel = clamp(pixel, viewport.xy + 0.5, viewport.xy + viewport.zw - 0.5);
+    finalColor = vec4(texture(texture0, pixel / targetSize).rgb, 1.0);
+}
+)";
+
+// World-to-view rotation of a camera, translation dropped
+Matrix ViewRotation(const Camera3D& camera) {
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    view.m12 = view.m13 = view.m14 = 0.0f;
+    return view;
+}
+
+} // namespace
+
+PoseReprojector::PoseReprojector() {
+    shader = { 0 };
+    output = { 0 };
+    vao = 0;
+    width = 0;
+    height = 0;
+    ready = false;
+    locDeltaLeft = locDeltaRight = -1;
+    locViewportLeft = locViewportRight = -1;
+    locTanHalfFov = locTargetSize = -1;
+}
+
+PoseReprojector::~PoseReprojector() {
+    Unload();
+}
+
+bool PoseReprojector::Init(int targetWidth, int targetHeight) {
+    if (ready) return true;
+
+    int version = rlGetVersion();
+    if (version != RL_OPENGL_33 && version != RL_OPENGL_43) {
+        VR_LOG_WARN(LogChannel::Main, "Reprojection needs OpenGL 3.3, frames go out as rendered");
+        return false;
+    }
+
+    shader = LoadShaderFromMemory(kWarpVertexShader, kWarpFragmentShader);
+    if (!IsShaderValid(shader) || shader.id == rlGetShaderIdDefault()) {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to compile reprojection shader, frames go out as rendered");
+        shader = { 0 };
+        return false;
+    }
+
+    locDeltaLeft = GetShaderLocation(shader, "deltaLeft");
+    locDeltaRight = GetShaderLocation(shader, "deltaRight");
+    locViewportLeft = GetShaderLocation(shader, "viewportLeft");
+    locViewportRight = GetShaderLocation(shader, "viewportRight");
+    locTanHalfFov = GetShaderLocation(shader, "tanHalfFov");
+    locTargetSize = GetShaderLocation(shader, "targetSize");
+
+    // Core profile draws need a bound vertex array even without attributes
+    vao = rlLoadVertexArray();
+    output = LoadRenderTexture(targetWidth, targetHeight);
+    if (vao == 0 || !IsRenderTextureValid(output)) {
+        Unload();
+        return false;
+    }
+
+    width = targetWidth;
+    height = targetHeight;
+    ready = true;
+    VR_LOG_INFO(LogChannel::Main, "Rotational reprojection enabled");
+    return true;
+}
+
+void PoseReprojector::Unload() {
+    if (output.id != 0) UnloadRenderTexture(output);
+    if (vao != 0) rlUnloadVertexArray(vao);
+    if (shader.id != 0) UnloadShader(shader);
+    output = { 0 };
+    vao = 0;
+    shader = { 0 };
+    ready = false;
+}
+
+void PoseReprojector::Warp(const Texture2D& source, const StereoEye renderEyes[2], const StereoEye lateEyes[2], bool rewarp) {
+    if (!ready) return;
+    auto start = std::chrono::steady_clock::now();
+
+    Matrix deltas[2];
+    float viewports[2][4];
+    for (int eye = 0; eye < 2; eye++) {
+        // Undo the late view rotation, then apply the rendered one
+        deltas[eye] = MatrixMultiply(MatrixTranspose(ViewRotation(lateEyes[eye].camera)), ViewRotation(renderEyes[eye].camera));
+        viewports[eye][0] = static_cast<float>(renderEyes[eye].viewportX);
+        viewports[eye][1] = static_cast<float>(renderEyes[eye].viewportY);
+        viewports[eye][2] = static_cast<float>(renderEyes[eye].viewportWidth);
+        viewports[eye][3] = static_cast<float>(renderEyes[eye].viewportHeight);
+    }
+
+    // Same projection StereoEyeViewProjection and BeginMode3D use: fovy with the target's aspect
+    float tanHalfY = tanf(renderEyes[0].camera.fovy * DEG2RAD * 0.5f);
+    float tanHalfFov[2] = { tanHalfY * static_cast<float>(width) / static_cast<float>(height), tanHalfY };
+    float targetSize[2] = { static_cast<float>(width), static_cast<float>(height) };
+
+    BeginTextureMode(output);
+    rlViewport(0, 0, width, height);
+    rlDisableDepthTest();
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(locDeltaLeft, deltas[0]);
+    rlSetUniformMatrix(locDeltaRight, deltas[1]);
+    rlSetUniform(locViewportLeft, viewports[0], RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locViewportRight, viewports[1], RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locTanHalfFov, tanHalfFov, RL_SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(locTargetSize, targetSize, RL_SHADER_UNIFORM_VEC2, 1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(source.id);
+    rlEnableVertexArray(vao);
+    rlDrawVertexArray(0, 3);
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+    EndTextureMode();
+
+    // Rotation the pass corrected, as the angle between the two left-eye view directions
+    Vector3 renderForward = Vector3Subtract(renderEyes[0].camera.target, renderEyes[0].camera.position);
+    Vector3 lateForward = Vector3Subtract(lateEyes[0].camera.target, lateEyes[0].camera.position);
+    double correction = Vector3Angle(renderForward, lateForward) * RAD2DEG;
+    stats.correctionDeg += correction;
+    if (correction > stats.maxCorrectionDeg) stats.maxCorrectionDeg = correction;
+    if (rewarp) {
+        stats.rewarps++;
+    }
+    else {
+        stats.warps++;
+    }
+    stats.warpMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+PoseReprojector::Stats PoseReprojector::TakeStats() {
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "raylib.h"
+#include "stereo_renderer.h"
+#include <cstdint>
+
+/**
+ * Rotational reprojection of a rendered stereo frame, in the spirit of
+ * asynchronous timewarp. The frame is rendered from one head orientation; right
+ * before readback each eye's image is re-projected to a fresher orientation with
+ * one full-screen pass: every output pixel's view ray is rotated by the delta
+ * between the two poses and looked up in the rendered image. Eye translation is
+ * ignored, so only rotation is corrected. Needs OpenGL 3.3 (GLSL 330), which
+ * Mesa's llvmpipe provides.
+ */
+class PoseReprojector {
+public:
+    struct Stats {
+        uint64_t warps = 0;             // passes over a freshly rendered frame
+        uint64_t rewarps = 0;           // passes re-emitting an older frame
+        double correctionDeg = 0.0;     // accumulated view rotation corrected
+        double maxCorrectionDeg = 0.0;
+        double warpMs = 0.0;            // CPU time issuing the passes
+    };
+
+    PoseReprojector();
+    ~PoseReprojector();
+
+    // Output target matches the scene target it reprojects
+    bool Init(int width, int height);
+    void Unload();
+    bool IsReady() const { return ready; }
+
+    // Draws source, rendered with renderEyes, into the output as seen from lateEyes.
+    // Both sets share viewports; only the cameras differ.
+    void Warp(const Texture2D& source, const StereoEye renderEyes[2], const StereoEye lateEyes[2], bool rewarp);
+    Texture2D GetOutputTexture() const { return output.texture; }
+    RenderTexture2D GetOutputTarget() const { return output; }
+
+    Stats TakeStats();
+
+private:
+    Shader shader;
+    RenderTexture2D output;
+    unsigned int vao;
+    int width;
+    int height;
+    bool ready;
+    Stats stats;
+
+    int locDeltaLeft;
+    int locDeltaRight;
+    int locViewportLeft;
+    int locViewportRight;
+    int locTanHalfFov;
+    int locTargetSize;
+};
@@ -0,0 +1,155 @@
+#include "resolution_governor.h"
+
+namespace {
+
+const double kSmoothing = 0.1;      // weight of the newest stage time
+const double kHighWater = 0.95;     // fraction of the budget above which a frame counts as over
+const double kLowWater = 0.75;      // fraction below which a frame counts as having headroom
+const double kRaiseTarget = 0.85;   // predicted cost after raising a scale must stay under this
+const int kLowerAfterFrames = 8;    // consecutive over-budget frames before lowering a scale
+const int kRaiseAfterFrames = 60;   // consecutive frames with headroom before raising one
+const int kSettleFrames = 10;       // frames ignored after a step while the new cost shows up
+const auto kEncoderDwell = std::chrono::seconds(2);
+
+void Smooth(double& cost, bool& has, double ms) {
+    cost = has ? cost + kSmoothing * (ms - cost) : ms;
+    has = true;
+}
+
+// Stage costs are taken to follow the pixel count
+double PixelRatio(int level, int next) {
+    double ratio = ResolutionGovernor::kScales[next] / ResolutionGovernor::kScales[level];
+    return ratio * ratio;
+}
+
+} // namespace
+
+ResolutionGovernor::ResolutionGovernor() {
+    budget = std::chrono::microseconds(0);
+    renderLevel = 0;
+    encoderLevel = 0;
+    renderCost = readbackCost = encodeCost = 0.0;
+    hasRender = hasReadback = hasEncode = false;
+    overFrames = 0;
+    underFrames = 0;
+    settleFrames = 0;
+    lastEncoderStep = Clock::time_point{};
+    stats = Stats();
+}
+
+void ResolutionGovernor::SetBudget(std::chrono::microseconds budget) {
+    this->budget = budget;
+    if (!IsEnabled()) {
+        renderLevel = 0;
+        encoderLevel = 0;
+    }
+}
+
+void ResolutionGovernor::AddRender(double ms) {
+    Smooth(renderCost, hasRender, ms);
+    stats.renderMs += ms;
+    stats.renders++;
+}
+
+void ResolutionGovernor::AddReadback(double ms) {
+    Smooth(readbackCost, hasReadback, ms);
+    stats.readbackMs += ms;
+}
+
+void ResolutionGovernor::AddEncode(double ms) {
+    Smooth(encodeCost, hasEncode, ms);
+    stats.encodeMs += ms;
+}
+
+bool ResolutionGovernor::Update(Clock::time_point now) {
+    stats.frames++;
+    if (!IsEnabled()) return false;
+
+    double budgetMs = budget.count() / 1000.0;
+    double total = renderCost + readbackCost + encodeCost;
+    if (total > budgetMs) {
+        stats.overBudget++;
+    }
+    if (settleFrames > 0) {
+        settleFrames--;
+        return false;
+    }
+
+    if (total > budgetMs * kHighWater) {
+        overFrames++;
+        underFrames = 0;
+    }
+    else if (total < budgetMs * kLowWater) {
+        underFrames++;
+        overFrames = 0;
+    }
+    else {
+        overFrames = 0;
+        underFrames = 0;
+    }
+
+    if (overFrames >= kLowerAfterFrames) {
+        // Shed pixels where the time goes; readback follows the render region
+        overFrames = 0;
+        if (encodeCost > renderCost + readbackCost) {
+            return StepEncoder(1, now) || StepRender(1);
+        }
+        return StepRender(1) || StepEncoder(1, now);
+    }
+    if (underFrames >= kRaiseAfterFrames) {
+        // Bring the lower of the two scales back first
+        underFrames = 0;
+        if (encoderLevel > renderLevel) {
+            return StepEncoder(-1, now) || StepRender(-1);
+        }
+        return StepRender(-1) || StepEncoder(-1, now);
+    }
+    return false;
+}
+
+bool ResolutionGovernor::FitsAfterStep(double cost, int level, int next) const {
+    double total = renderCost + readbackCost + encodeCost;
+    double predicted = total + cost * (PixelRatio(level, next) - 1.0);
+    return predicted < budget.count() / 1000.0 * kRaiseTarget;
+}
+
+bool ResolutionGovernor::StepRender(int step) {
+    int next = renderLevel + step;
+    if (next < 0 || next >= kLevels) return false;
+    if (step < 0 && !FitsAfterStep(renderCost + readbackCost, renderLevel, next)) return false;
+
+    double ratio = PixelRatio(renderLevel, next);
+    renderCost *= ratio;
+    readbackCost *= ratio;
+    renderLevel = next;
+    stats.renderSteps++;
+    Settle();
+    return true;
+}
+
+bool ResolutionGovernor::StepEncoder(int step, Clock::time_point now) {
+    int next = encoderLevel + step;
+    if (next < 0 || next >= kLevels) return false;
+    // Every step restarts the encoder and costs a key frame
+    if (now - lastEncoderStep < kEncoderDwell) return false;
+    if (step < 0 && !FitsAfterStep(encodeCost, encoderLevel, next)) return false;
+
+    encodeCost *= PixelRatio(encoderLevel, next);
+    encoderLevel = next;
+    lastEncoderStep = now;
+    stats.encoderSteps++;
+    Settle();
+    return true;
+}
+
+void ResolutionGovernor::Settle() {
+    overFrames = 0;
+    underFrames = 0;
+    settleFrames = kSettleFrames;
+}
+
+ResolutionGovernor::Stats ResolutionGovernor::TakeStats() {
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Keeps the per-frame work inside a time budget by trading resolution for time.
+ * The main loop reports how long rendering, readback and encoding took; the
+ * governor smooths each stage and, when the sum stays over the budget, lowers
+ * the scale of the stage that costs most: the render scale shrinks each eye's
+ * viewport inside the fixed render target (readback follows it), the encoder
+ * scale sets the size the conversion stage scales to. It raises a scale again
+ * once the cost predicted at the next level fits comfortably. Encoder steps
+ * restart the encoder, so they are rate limited separately.
+ */
+class ResolutionGovernor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kLevels = 5;
+    static constexpr float kScales[kLevels] = { 1.0f, 0.875f, 0.75f, 0.625f, 0.5f };
+
+    struct Stats {
+        uint64_t frames = 0;        // Update calls
+        uint64_t overBudget = 0;    // frames whose smoothed cost exceeded the budget
+        uint64_t renderSteps = 0;
+        uint64_t encoderSteps = 0;
+        double renderMs = 0.0;      // raw stage times as reported
+        uint64_t renders = 0;
+        double readbackMs = 0.0;
+        double encodeMs = 0.0;
+    };
+
+    ResolutionGovernor();
+
+    // Stage times of the frame being produced; a re-emitted frame reports no render
+    void AddRender(double ms);
+    void AddReadback(double ms);
+    void AddEncode(double ms);
+    // Once per frame sent; true when either scale changed
+    bool Update(Clock::time_point now);
+
+    float GetRenderScale() const { return kScales[renderLevel]; }
+    float GetEncoderScale() const { return kScales[encoderLevel]; }
+
+    // Configuration; a zero budget disables the governor and keeps full resolution
+    void SetBudget(std::chrono::microseconds budget);
+    std::chrono::microseconds GetBudget() const { return budget; }
+    bool IsEnabled() const { return budget.count() > 0; }
+
+    Stats TakeStats();
+
+private:
+    std::chrono::microseconds budget;
+    int renderLevel;
+    int encoderLevel;
+
+    // Smoothed stage costs in milliseconds at the current scales
+    double renderCost;
+    double readbackCost;
+    double encodeCost;
+    bool hasRender;
+    bool hasReadback;
+    bool hasEncode;
+
+    int overFrames;
+    int underFrames;
+    int settleFrames;
+    Clock::time_point lastEncoderStep;
+    Stats stats;
+
+    // step +1 lowers the scale one level, -1 raises it; false if the step is not possible or does not fit
+    bool StepRender(int step);
+    bool StepEncoder(int step, Clock::time_point now);
+    bool FitsAfterStep(double cost, int level, int next) const;
+    void Settle();
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Bounded single-consumer channel for sensor samples.
+ *
+ * The producer never blocks and memory never grows: once Capacity samples are pending
+ * the oldest one is overwritten. The consumer drains everything pending in one call,
+ * so it always sees the newest sample plus the intermediate ones for filtering.
+ */
+template<typename T, size_t Capacity>
+class SampleMailbox {
+public:
+    struct Stats {
+        uint64_t pushed = 0;
+        uint64_t consumed = 0;
+        uint64_t overwritten = 0;   // samples lost because the consumer fell behind
+        size_t maxBacklog = 0;      // deepest the mailbox got
+    };
+
+private:
+    std::array<T, Capacity> ring_;
+    size_t head_ = 0;   // next slot to write
+    size_t count_ = 0;
+    Stats stats_;
+    mutable std::mutex mutex_;
+    std::condition_variable pushed_;
+
+public:
+    void push(const T& item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ring_[head_] = item;
+            head_ = (head_ + 1) % Capacity;
+            if (count_ == Capacity) {
+                stats_.overwritten++;
+            }
+            else {
+                count_++;
+            }
+            stats_.pushed++;
+            if (count_ > stats_.maxBacklog) stats_.maxBacklog = count_;
+        }
+        pushed_.notify_one();
+    }
+
+    // Blocks until a sample is pending or the timeout passes; true if one is pending.
+    // Lets an idle consumer sleep without adding latency to the next sample.
+    template<typename Rep, typename Period>
+    bool waitPending(std::chrono::duration<Rep, Period> timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return pushed_.wait_for(lock, timeout, [this] { return count_ > 0; });
+    }
+
+    // Appends every pending sample to out, oldest first, and returns how many were taken.
+    // Reserve Capacity in out once and this never allocates.
+    size_t drain(std::vector<T>& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t tail = (head_ + Capacity - count_) % Capacity;
+        for (size_t i = 0; i < count_; i++) {
+            out.push_back(ring_[(tail + i) % Capacity]);
+        }
+        size_t taken = count_;
+        stats_.consumed += taken;
+        count_ = 0;
+        return taken;
+    }
+
+    // Newest pending sample without consuming anything
+    std::optional<T> peekLatest() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == 0) {
+            return std::nullopt;
+        }
+        return ring_[(head_ + Capacity - 1) % Capacity];
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    // Counters restart from zero; used for periodic reporting
+    void resetStats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_ = Stats{};
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+};
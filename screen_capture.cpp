@@ -2,10 +2,14 @@
 #define NOMINMAX
 #include <windows.h>
 #include <wingdi.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iostream>
 #include "screen_capture.h"
+#include "thread_topology.h"
+#include "metrics_registry.h"
+#include "pixel_convert.h"
 
 // Static member definitions
 std::unique_ptr<std::thread> ScreenCapture::captureThread = nullptr;
@@ -13,6 +17,7 @@ std::atomic<bool> ScreenCapture::shouldStop{ false };
 std::atomic<bool> ScreenCapture::isRunning{ false };
 ThreadSafeQueue<CapturedFrame> ScreenCapture::frameQueue;
 std::atomic<float> ScreenCapture::captureRate{ 1.0f / 120.0f };
+std::atomic<int> ScreenCapture::downscale{ 1 };
 
 // Thread-local storage for Windows handles
 thread_local HDC screenDC = nullptr;
@@ -81,13 +86,17 @@ CapturedFrame ScreenCapture::captureDesktopInternal() {
         return frame;
     }
 
+    int divisor = std::max(1, downscale.load());
+    int frameWidth = std::max(1, screenWidth / divisor);
+    int frameHeight = std::max(1, screenHeight / divisor);
+
     // Create or recreate bitmap if size changed
-    if (!bitmap || screenWidth != lastWidth || screenHeight != lastHeight) {
+    if (!bitmap || frameWidth != lastWidth || frameHeight != lastHeight) {
         if (bitmap) {
             DeleteObject(bitmap);
         }
 
-        bitmap = CreateCompatibleBitmap(screenDC, screenWidth, screenHeight);
+        bitmap = CreateCompatibleBitmap(screenDC, frameWidth, frameHeight);
         if (!bitmap) {
             // // std::cout << "Failed to create compatible bitmap" << std::endl;
             return frame;
@@ -96,21 +105,30 @@ CapturedFrame ScreenCapture::captureDesktopInternal() {
         // Setup bitmap info for pixel data extraction
         ZeroMemory(&bitmapInfo, sizeof(BITMAPINFO));
         bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bitmapInfo.bmiHeader.biWidth = screenWidth;
-        bitmapInfo.bmiHeader.biHeight = -screenHeight; // Negative for top-down
+        bitmapInfo.bmiHeader.biWidth = frameWidth;
+        bitmapInfo.bmiHeader.biHeight = -frameHeight; // Negative for top-down
         bitmapInfo.bmiHeader.biPlanes = 1;
         bitmapInfo.bmiHeader.biBitCount = 32;
         bitmapInfo.bmiHeader.biCompression = BI_RGB;
 
-        lastWidth = screenWidth;
-        lastHeight = screenHeight;
-        // // std::cout << "Created new bitmap: " << screenWidth << "x" << screenHeight << std::endl;
+        lastWidth = frameWidth;
+        lastHeight = frameHeight;
+        // // std::cout << "Created new bitmap: " << frameWidth << "x" << frameHeight << std::endl;
     }
 
     HBITMAP oldBitmap = (HBITMAP)SelectObject(memoryDC, bitmap);
 
-    // Capture screen
-    BOOL blitResult = BitBlt(memoryDC, 0, 0, screenWidth, screenHeight, screenDC, 0, 0, SRCCOPY);
+    // Capture screen; a reduced panel resolution is filtered down here so less data crosses to the GPU
+    BOOL blitResult;
+    if (divisor == 1) {
+        blitResult = BitBlt(memoryDC, 0, 0, screenWidth, screenHeight, screenDC, 0, 0, SRCCOPY);
+    }
+    else {
+        SetStretchBltMode(memoryDC, HALFTONE);
+        SetBrushOrgEx(memoryDC, 0, 0, nullptr);
+        blitResult = StretchBlt(memoryDC, 0, 0, frameWidth, frameHeight,
+            screenDC, 0, 0, screenWidth, screenHeight, SRCCOPY);
+    }
     if (!blitResult) {
         DWORD error = GetLastError();
         // // std::cout << "BitBlt failed with error: " << error << std::endl;
@@ -119,8 +137,8 @@ CapturedFrame ScreenCapture::captureDesktopInternal() {
     }
 
     // Extract pixel data
-    frame.pixels.resize(screenWidth * screenHeight * 4);
-    int result = GetDIBits(screenDC, bitmap, 0, screenHeight,
+    frame.pixels.resize(static_cast<size_t>(frameWidth) * frameHeight * 4);
+    int result = GetDIBits(screenDC, bitmap, 0, frameHeight,
         frame.pixels.data(), &bitmapInfo, DIB_RGB_COLORS);
 
     SelectObject(memoryDC, oldBitmap);
@@ -131,21 +149,26 @@ CapturedFrame ScreenCapture::captureDesktopInternal() {
         return frame;
     }
 
-    frame.width = screenWidth;
-    frame.height = screenHeight;
+    frame.width = frameWidth;
+    frame.height = frameHeight;
     frame.channels = 4;
+    frame.downscale = divisor;
     frame.isValid = true;
     frame.timestamp = std::chrono::steady_clock::now();
 
     // Convert BGRA to RGBA (Windows uses BGRA format)
-    for (size_t i = 0; i < frame.pixels.size(); i += 4) {
-        std::swap(frame.pixels[i], frame.pixels[i + 2]);
-    }
+    SwizzleBgraToRgba(frame.pixels.data(), frame.pixels.size() / 4);
 
     return frame;
 }
 
 void ScreenCapture::captureThreadFunction() {
+    ThreadTopology::Scope threadScope("capture");
+    auto& metrics = MetricsRegistry::instance();
+    MetricCounter& capturedMetric = metrics.Counter("vr_capture_frames_total", "Desktop frames captured");
+    MetricCounter& droppedMetric = metrics.Counter("vr_capture_frames_dropped_total",
+        "Captured frames discarded unrendered because the queue was full");
+    MetricCounter& failedMetric = metrics.Counter("vr_capture_failures_total", "Desktop captures that failed");
     // // std::cout << "Capture thread started" << std::endl;
     isRunning = true;
 
@@ -159,10 +182,13 @@ void ScreenCapture::captureThreadFunction() {
         if (frame.isValid) {
             // Keep only the latest 3 frames to prevent memory buildup
             while (frameQueue.size() > 2) {
-                frameQueue.tryPop();
+                if (frameQueue.tryPop()) {
+                    droppedMetric.Add();
+                }
             }
             frameQueue.push(std::move(frame));
             frameCount++;
+            capturedMetric.Add();
 
             // Log progress every 5 seconds
             auto now = std::chrono::steady_clock::now();
@@ -173,6 +199,7 @@ void ScreenCapture::captureThreadFunction() {
             }
         }
         else {
+            failedMetric.Add();
             // // // std::cout << "Failed to capture frame" << std::endl;
         }
 
@@ -245,6 +272,10 @@ void ScreenCapture::setCaptureRate(float fps) {
     // // std::cout << "Set capture rate to " << fps << " FPS" << std::endl;
 }
 
+void ScreenCapture::setDownscale(int divisor) {
+    downscale = std::max(1, divisor);
+}
+
 bool ScreenCapture::isInitialized() {
     return isRunning;
 }
@@ -11,10 +11,11 @@ struct CapturedFrame {
     int width;
     int height;
     int channels;
+    int downscale;      // desktop pixels per frame pixel along each axis
     bool isValid;
     std::chrono::steady_clock::time_point timestamp;
 
-    CapturedFrame() : width(0), height(0), channels(0), isValid(false) {}
+    CapturedFrame() : width(0), height(0), channels(0), downscale(1), isValid(false) {}
 };
 
 class ScreenCapture {
@@ -24,6 +25,7 @@ private:
     static std::atomic<bool> isRunning;
     static ThreadSafeQueue<CapturedFrame> frameQueue;
     static std::atomic<float> captureRate;
+    static std::atomic<int> downscale;
 
     static void captureThreadFunction();
     static CapturedFrame captureDesktopInternal();
@@ -33,6 +35,9 @@ public:
     static void cleanup();
     static std::optional<CapturedFrame> getLatestFrame();
     static void setCaptureRate(float fps);
+    static float getCaptureRate() { return 1.0f / captureRate.load(); }
+    // Captures at 1/divisor of the desktop resolution (filtered on the GDI side)
+    static void setDownscale(int divisor);
     static bool isInitialized();
     static size_t getQueueSize();
 };
@@ -0,0 +1,275 @@
+#include "session_recording.h"
+#include "async_logger.h"
+#include "thread_topology.h"
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr uint32_t kMaxRecordSize = 64u << 20;
+
+void Append(std::vector<char>& buffer, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+} // namespace
+
+// -------- Recorder --------
+
+SessionRecorder::SessionRecorder()
+    : open(false), offset(0), recordCount(0), lastTimeUs(0), recordFrames(false), droppedFrames(0),
+      stopWriter(false), writeFailed(false) {
+}
+
+SessionRecorder::~SessionRecorder() {
+    Close();
+}
+
+bool SessionRecorder::Open(const std::string& path) {
+    Close();
+
+    file = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!file->is_open()) {
+        VR_LOG_ERROR(LogChannel::Main, "Cannot open session recording {}", path);
+        file.reset();
+        return false;
+    }
+
+    SessionFileHeader header = {};
+    header.magic = kSessionMagic;
+    header.version = kSessionVersion;
+    header.headerSize = sizeof(SessionFileHeader);
+    file->write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    index.clear();
+    startTime = Clock::now();
+    offset = sizeof(header);
+    recordCount = 0;
+    lastTimeUs = 0;
+    lastHands.clear();
+    droppedFrames = 0;
+
+    pending.clear();
+    stopWriter = false;
+    writeFailed = false;
+    open = true;
+    writer = std::thread(&SessionRecorder::WriterLoop, this);
+    return true;
+}
+
+void SessionRecorder::Close() {
+    if (!file) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopWriter = true;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    open = false;
+    if (droppedFrames > 0) {
+        VR_LOG_WARN(LogChannel::Main, "Session recording dropped {} frames while the disk was behind", droppedFrames);
+    }
+    if (writeFailed) {
+        // The records are incomplete; an index pointing past them would only mislead the reader
+        file.reset();
+        return;
+    }
+
+    SessionFileHeader header = {};
+    header.magic = kSessionMagic;
+    header.version = kSessionVersion;
+    header.headerSize = sizeof(SessionFileHeader);
+    header.indexOffset = offset;
+    header.indexCount = static_cast<uint32_t>(index.size());
+    header.recordCount = recordCount;
+    header.durationUs = lastTimeUs;
+
+    file->write(reinterpret_cast<const char*>(index.data()),
+        static_cast<std::streamsize>(index.size() * sizeof(SessionIndexEntry)));
+    file->seekp(0);
+    file->write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file->close();
+    file.reset();
+}
+
+void SessionRecorder::WriterLoop() {
+    AsyncLogger::instance().registerThread();
+    ThreadTopology::Scope threadScope("recorder");
+    // Swapped with pending under the lock, so neither side reallocates in steady state
+    std::vector<char> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopWriter || !pending.empty(); });
+            if (pending.empty()) {
+                break;  // stopping with everything written
+            }
+            batch.swap(pending);
+        }
+        if (!writeFailed) {
+            file->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            if (!file->good()) {
+                writeFailed = true;
+                VR_LOG_ERROR(LogChannel::Main, "Session recording write failed; later records are discarded");
+            }
+        }
+        batch.clear();
+    }
+    file->flush();
+}
+
+void SessionRecorder::WriteRecord(SessionRecordType type, Clock::time_point time,
+    const void* first, size_t firstSize, const void* second, size_t secondSize) {
+    if (!open || writeFailed) return;
+
+    // Inputs arrive from several sources slightly out of order; keep the file monotonic
+    int64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(time - startTime).count();
+    if (timeUs < lastTimeUs) timeUs = lastTimeUs;
+
+    SessionRecordHeader header = {};
+    header.type = type;
+    header.size = static_cast<uint32_t>(firstSize + secondSize);
+    header.timeUs = timeUs;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (type == SessionRecordType::Frame && pending.size() + sizeof(header) + header.size > kMaxPendingBytes) {
+            droppedFrames++;
+            return;
+        }
+        Append(pending, &header, sizeof(header));
+        Append(pending, first, firstSize);
+        if (secondSize > 0) {
+            Append(pending, second, secondSize);
+        }
+    }
+    wake.notify_one();
+
+    if (recordCount % kIndexInterval == 0) {
+        index.push_back({ timeUs, offset });
+    }
+    offset += sizeof(header) + header.size;
+    recordCount++;
+    lastTimeUs = timeUs;
+}
+
+void SessionRecorder::RecordHands(Clock::time_point time, const std::string& json) {
+    if (!open || json == lastHands) return;
+    lastHands = json;
+    WriteRecord(SessionRecordType::Hands, time, json.data(), json.size());
+}
+
+void SessionRecorder::RecordGyro(const GyroData& sample) {
+    float values[3] = { sample.yaw, sample.pitch, sample.roll };
+    WriteRecord(SessionRecordType::Gyro, sample.timestamp, values, sizeof(values));
+}
+
+void SessionRecorder::RecordFrame(Clock::time_point time, int width, int height, const std::vector<uint8_t>& encoded) {
+    if (!recordFrames) return;
+    uint32_t size[2] = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    WriteRecord(SessionRecordType::Frame, time, size, sizeof(size), encoded.data(), encoded.size());
+}
+
+// -------- Reader --------
+
+SessionReader::SessionReader() : header{}, dataEnd(0), position(0) {
+}
+
+bool SessionReader::Open(const std::string& path) {
+    Close();
+
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != kSessionMagic || header.version != kSessionVersion ||
+        header.headerSize < sizeof(SessionFileHeader)) {
+        Close();
+        return false;
+    }
+
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec) {
+        Close();
+        return false;
+    }
+
+    // Unclosed recordings have no index; everything after the header is records
+    dataEnd = fileSize;
+    if (header.indexOffset != 0 &&
+        header.indexOffset + static_cast<uint64_t>(header.indexCount) * sizeof(SessionIndexEntry) <= fileSize) {
+        index.resize(header.indexCount);
+        file.seekg(static_cast<std::streamoff>(header.indexOffset));
+        file.read(reinterpret_cast<char*>(index.data()),
+            static_cast<std::streamsize>(index.size() * sizeof(SessionIndexEntry)));
+        if (!file) {
+            index.clear();
+            file.clear();
+        }
+        else {
+            dataEnd = header.indexOffset;
+        }
+    }
+
+    position = header.headerSize;
+    file.seekg(static_cast<std::streamoff>(position));
+    return true;
+}
+
+void SessionReader::Close() {
+    if (file.is_open()) file.close();
+    file.clear();
+    index.clear();
+    header = {};
+    dataEnd = 0;
+    position = 0;
+}
+
+bool SessionReader::Next(SessionRecord& record) {
+    if (!file.is_open() || position + sizeof(SessionRecordHeader) > dataEnd) return false;
+
+    SessionRecordHeader recordHeader;
+    file.read(reinterpret_cast<char*>(&recordHeader), sizeof(recordHeader));
+    if (!file || recordHeader.size > kMaxRecordSize ||
+        position + sizeof(recordHeader) + recordHeader.size > dataEnd) {
+        // Truncated tail of an unclosed recording
+        position = dataEnd;
+        return false;
+    }
+
+    record.type = recordHeader.type;
+    record.timeUs = recordHeader.timeUs;
+    record.payload.resize(recordHeader.size);
+    file.read(reinterpret_cast<char*>(record.payload.data()), recordHeader.size);
+    position += sizeof(recordHeader) + recordHeader.size;
+    return static_cast<bool>(file);
+}
+
+void SessionReader::Seek(int64_t timeUs) {
+    if (!file.is_open()) return;
+    file.clear();
+
+    // Start from the last index entry before the target, then skip record by record
+    position = header.headerSize;
+    for (const auto& entry : index) {
+        if (entry.timeUs >= timeUs) break;
+        position = entry.offset;
+    }
+
+    SessionRecordHeader recordHeader;
+    while (position + sizeof(recordHeader) <= dataEnd) {
+        file.seekg(static_cast<std::streamoff>(position));
+        file.read(reinterpret_cast<char*>(&recordHeader), sizeof(recordHeader));
+        if (!file || recordHeader.timeUs >= timeUs) break;
+        position += sizeof(recordHeader) + recordHeader.size;
+    }
+
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(position));
+}
@@ -0,0 +1,144 @@
+#ifndef SESSION_RECORDING_H
+#define SESSION_RECORDING_H
+
+#include "gyro_thread.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// On-disk layout (little-endian):
+//   SessionFileHeader
+//   { SessionRecordHeader, payload[size] } ...
+//   SessionIndexEntry[indexCount]            (written by Close)
+// Times are microseconds since the start of the recording. A file whose recorder
+// did not close has indexOffset == 0 and is read sequentially.
+
+constexpr uint32_t kSessionMagic = 0x4E535256;  // "VRSN"
+constexpr uint16_t kSessionVersion = 1;
+
+enum class SessionRecordType : uint8_t {
+    Hands = 1,   // raw hands.dat JSON payload
+    Gyro = 2,    // float yaw, pitch, roll (radians)
+    Frame = 3    // uint32 width, uint32 height, encoded H.264 bytes
+};
+
+struct SessionFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint64_t indexOffset;
+    uint32_t indexCount;
+    uint32_t recordCount;
+    int64_t durationUs;
+};
+static_assert(sizeof(SessionFileHeader) == 32, "session header layout is part of the file format");
+
+struct SessionRecordHeader {
+    SessionRecordType type;
+    uint8_t reserved[3];
+    uint32_t size;
+    int64_t timeUs;
+};
+static_assert(sizeof(SessionRecordHeader) == 16, "record header layout is part of the file format");
+
+struct SessionIndexEntry {
+    int64_t timeUs;
+    uint64_t offset;   // file offset of a record header
+};
+static_assert(sizeof(SessionIndexEntry) == 16, "index entry layout is part of the file format");
+
+struct SessionRecord {
+    SessionRecordType type;
+    int64_t timeUs;
+    std::vector<uint8_t> payload;   // reused between reads
+};
+
+/**
+ * Appends timestamped inputs to a session file. Called from the main loop only.
+ * Identical consecutive hand payloads are stored once, since hands.dat is polled
+ * every frame whether or not it changed.
+ *
+ * Records are serialized into a memory buffer that a writer thread swaps out and
+ * writes, so the main loop never waits on the disk. If the disk falls more than
+ * kMaxPendingBytes behind, frame records are dropped; hand and gyro records never are.
+ */
+class SessionRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32_t kIndexInterval = 64;   // records per index entry
+    static constexpr size_t kMaxPendingBytes = 64u << 20;
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return open; }
+
+    void SetRecordFrames(bool enabled) { recordFrames = enabled; }
+    bool GetRecordFrames() const { return recordFrames; }
+
+    void RecordHands(Clock::time_point time, const std::string& json);
+    void RecordGyro(const GyroData& sample);
+    void RecordFrame(Clock::time_point time, int width, int height, const std::vector<uint8_t>& encoded);
+
+    uint32_t GetRecordCount() const { return recordCount; }
+    uint64_t GetDroppedFrames() const { return droppedFrames; }
+
+private:
+    std::unique_ptr<std::ofstream> file;   // owned by the writer thread while open
+    std::vector<SessionIndexEntry> index;
+    bool open;
+    Clock::time_point startTime;
+    uint64_t offset;
+    uint32_t recordCount;
+    int64_t lastTimeUs;
+    bool recordFrames;
+    std::string lastHands;
+    uint64_t droppedFrames;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<char> pending;      // serialized records not yet handed to the writer
+    bool stopWriter;
+    std::atomic<bool> writeFailed;
+
+    void WriterLoop();
+    void WriteRecord(SessionRecordType type, Clock::time_point time,
+        const void* first, size_t firstSize, const void* second = nullptr, size_t secondSize = 0);
+};
+
+// Sequential reader with time-based seeking through the index
+class SessionReader {
+public:
+    SessionReader();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file.is_open(); }
+
+    bool Next(SessionRecord& record);
+    // Positions the reader so the next record is the first at or after timeUs
+    void Seek(int64_t timeUs);
+    void Rewind() { Seek(0); }
+
+    const SessionFileHeader& GetHeader() const { return header; }
+    bool HasIndex() const { return !index.empty(); }
+
+private:
+    std::ifstream file;
+    SessionFileHeader header;
+    std::vector<SessionIndexEntry> index;
+    uint64_t dataEnd;
+    uint64_t position;
+};
+
+#endif // SESSION_RECORDING_H
@@ -0,0 +1,167 @@
+#include "session_replay.h"
+#include "hand_tracking_data.h"
+#include "raymath.h"
+#include <cstring>
+#include <thread>
+
+namespace {
+
+HeadPosePredictor::Clock::time_point RecordTime(int64_t timeUs) {
+    return HeadPosePredictor::Clock::time_point(std::chrono::microseconds(timeUs));
+}
+
+} // namespace
+
+SessionReplay::SessionReplay() {
+    pacing = Pacing::AsFastAsPossible;
+    speed = 1.0f;
+    lastHandsTime = 0.0;
+    record.type = SessionRecordType::Hands;
+    record.timeUs = 0;
+    hands = std::make_unique<VRHandsController>();
+    SetPanelInfo({ 0.0f, 1.8f, 4.0f }, { 17.60f, 5.0f, 0.1f });
+}
+
+bool SessionReplay::Open(const std::string& path) {
+    if (!reader.Open(path)) return false;
+    ResetPipeline();
+    return true;
+}
+
+void SessionReplay::SetPanelInfo(const Vector3& position, const Vector3& size) {
+    panelPosition = position;
+    panelSize = size;
+    player.SetPanelInfo(position, size);
+    hands->SetPanelInfo(position, size);
+}
+
+bool SessionReplay::LoadGestureTemplates(const std::string& path) {
+    if (!hands->LoadGestureTemplates(path)) return false;
+    templatePath = path;
+    return true;
+}
+
+void SessionReplay::ResetPipeline() {
+    // Fresh components so a second Run() starts from the same state as the first
+    headPredictor = HeadPosePredictor();
+    hands = std::make_unique<VRHandsController>();
+    hands->SetPanelInfo(panelPosition, panelSize);
+    if (!templatePath.empty()) {
+        hands->LoadGestureTemplates(templatePath);
+    }
+    player.SetOrientation(QuaternionIdentity());
+    stats = ReplayStats();
+    lastHandsTime = 0.0;
+    wallStart = std::chrono::steady_clock::now();
+}
+
+ReplayStats SessionReplay::Run() {
+    reader.Rewind();
+    ResetPipeline();
+    while (Step()) {
+    }
+    return stats;
+}
+
+bool SessionReplay::Step() {
+    if (!reader.Next(record)) return false;
+
+    if (pacing == Pacing::Original) {
+        auto due = wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::micro>(record.timeUs / speed));
+        std::this_thread::sleep_until(due);
+    }
+
+    switch (record.type) {
+    case SessionRecordType::Gyro:
+        ApplyGyro(record);
+        break;
+    case SessionRecordType::Hands:
+        ApplyHands(record);
+        break;
+    case SessionRecordType::Frame:
+        stats.frameRecords++;
+        stats.frameBytes += record.payload.size();
+        break;
+    }
+
+    stats.sessionSeconds = record.timeUs / 1e6;
+    stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return true;
+}
+
+void SessionReplay::ApplyGyro(const SessionRecord& gyro) {
+    if (gyro.payload.size() < 3 * sizeof(float)) {
+        stats.parseErrors++;
+        return;
+    }
+
+    float values[3];
+    memcpy(values, gyro.payload.data(), sizeof(values));
+    headPredictor.AddSample({ values[0], values[1], values[2], RecordTime(gyro.timeUs) });
+    stats.gyroRecords++;
+
+    // Same prediction the live loop applies, anchored to the recorded clock
+    auto horizon = std::chrono::duration_cast<HeadPosePredictor::Clock::duration>(
+        std::chrono::duration<float>(headPredictor.GetPredictionHorizon()));
+    player.SetOrientation(headPredictor.Predict(RecordTime(gyro.timeUs) + horizon));
+}
+
+void SessionReplay::ApplyHands(const SessionRecord& payload) {
+    using Clock = std::chrono::steady_clock;
+    auto parseStart = Clock::now();
+    std::vector<HandTrackingData> handData;
+    try {
+        handData = ParseHandTrackingJson(reinterpret_cast<const char*>(payload.payload.data()), payload.payload.size());
+    }
+    catch (const std::exception&) {
+        stats.parseErrors++;
+        return;
+    }
+    stats.handRecords++;
+
+    auto playerStart = Clock::now();
+    player.Update();
+
+    // Hands absent from this payload are untracked, as they would be on screen
+    HandTrackingData missing;
+    const HandTrackingData* left = &missing;
+    const HandTrackingData* right = &missing;
+    for (const auto& hand : handData) {
+        if (hand.handedness == "Left") left = &hand;
+        else if (hand.handedness == "Right") right = &hand;
+    }
+    player.UpdateVRHand(player.leftHand, *left);
+    player.UpdateVRHand(player.rightHand, *right);
+
+    double time = payload.timeUs / 1e6;
+    float deltaTime = static_cast<float>(time - lastHandsTime);
+    lastHandsTime = time;
+
+    HandLandmarks tracked[2];
+    size_t trackedCount = 0;
+    if (player.leftHand.is_tracked) ToHandLandmarks(player.leftHand, tracked[trackedCount++]);
+    if (player.rightHand.is_tracked) ToHandLandmarks(player.rightHand, tracked[trackedCount++]);
+    auto handsStart = Clock::now();
+
+    hands->Update(std::span<const HandLandmarks>(tracked, trackedCount), deltaTime, time);
+    auto handsEnd = Clock::now();
+
+    ReplayHandsEvent event = {};
+    event.time = time;
+    event.leftGesture = hands->GetLeftGesture();
+    event.rightGesture = hands->GetRightGesture();
+    event.mouseActive = hands->GetRight().GetMouseData(event.mouseUV, event.mouseClicking, event.mouseDragging);
+    event.scrolling = hands->GetLeft().IsScrolling();
+    event.scrollDelta = hands->GetLeft().TakeScrollDelta();
+
+    using seconds = std::chrono::duration<double>;
+    stats.parseSeconds += seconds(playerStart - parseStart).count();
+    stats.playerSeconds += seconds(handsStart - playerStart).count();
+    stats.handsSeconds += seconds(handsEnd - handsStart).count();
+
+    stats.gestureCounts[static_cast<size_t>(event.leftGesture.type)]++;
+    stats.gestureCounts[static_cast<size_t>(event.rightGesture.type)]++;
+
+    if (onHands) onHands(event);
+}
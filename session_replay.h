@@ -0,0 +1,98 @@
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+#include "session_recording.h"
+#include "player.h"
+#include "head_pose_predictor.h"
+#include "gesture_recognition.h"
+#include "vr_mouse.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Outcome of one recorded hands payload after it went through the pipeline
+struct ReplayHandsEvent {
+    double time;                // seconds since the start of the recording
+    GestureData leftGesture;
+    GestureData rightGesture;
+    bool mouseActive;           // right hand, click pointer
+    Vector2 mouseUV;
+    bool mouseClicking;
+    bool mouseDragging;
+    bool scrolling;             // left hand, scroll pointer
+    float scrollDelta;
+};
+
+struct ReplayStats {
+    uint64_t handRecords = 0;
+    uint64_t gyroRecords = 0;
+    uint64_t frameRecords = 0;
+    uint64_t frameBytes = 0;
+    uint64_t parseErrors = 0;
+    uint64_t gestureCounts[static_cast<size_t>(GestureType::RELEASE) + 1] = {};  // both hands
+    double sessionSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    // Time spent per pipeline stage while handling hands payloads
+    double parseSeconds = 0.0;     // ParseHandTrackingJson
+    double playerSeconds = 0.0;    // Player::Update + UpdateVRHand for both hands
+    double handsSeconds = 0.0;     // VRHandsController::Update: features, recognition, both pointers
+};
+
+/**
+ * Feeds a recorded session through Player, HeadPosePredictor and VRHandsController
+ * (batched gesture recognition and both pointers) without a window. Every component is driven by the recorded
+ * timestamps, so a replay gives the same results on every run and at any pacing.
+ */
+class SessionReplay {
+public:
+    enum class Pacing {
+        Original,          // sleep so records are processed at their recorded times
+        AsFastAsPossible
+    };
+    using HandsCallback = std::function<void(const ReplayHandsEvent&)>;
+
+    SessionReplay();
+
+    bool Open(const std::string& path);
+    void SetPacing(Pacing mode) { pacing = mode; }
+    void SetSpeed(float factor) { speed = factor > 0.0f ? factor : 1.0f; }
+    void SetPanelInfo(const Vector3& position, const Vector3& size);
+    void SetHandsCallback(HandsCallback callback) { onHands = std::move(callback); }
+    // Kept across runs; the hands controller is rebuilt for every Run()
+    bool LoadGestureTemplates(const std::string& path);
+
+    // Processes one record; false once the session is exhausted
+    bool Step();
+    // Replays the whole session from the start
+    ReplayStats Run();
+    const ReplayStats& GetStats() const { return stats; }
+
+    Player& GetPlayer() { return player; }
+    VRHandsController& GetHandsController() { return *hands; }
+    const SessionFileHeader& GetHeader() const { return reader.GetHeader(); }
+
+private:
+    SessionReader reader;
+    SessionRecord record;
+    Player player;
+    HeadPosePredictor headPredictor;
+    std::unique_ptr<VRHandsController> hands;
+    HandsCallback onHands;
+    ReplayStats stats;
+
+    Pacing pacing;
+    float speed;
+    Vector3 panelPosition;
+    Vector3 panelSize;
+    std::string templatePath;
+    double lastHandsTime;
+    std::chrono::steady_clock::time_point wallStart;
+
+    void ResetPipeline();
+    void ApplyGyro(const SessionRecord& gyro);
+    void ApplyHands(const SessionRecord& hands);
+};
+
+#endif // SESSION_REPLAY_H
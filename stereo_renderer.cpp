@@ -0,0 +1,319 @@
+#include "stereo_renderer.h"
+#include "async_logger.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <chrono>
+#include <cstddef>
+
+namespace {
+
+// Attribute locations are the raylib defaults LoadShaderFromMemory binds:
+// vertexPosition 0, vertexTexCoord 1, vertexNormal 2, vertexColor 3, vertexTexCoord2 5.
+// The normal slot carries the other end of a line and texcoord2.x its side.
+const char* kStereoVertexShader = R"(#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+in vec4 vertexColor;
+in vec2 vertexTexCoord2;
+
+uniform mat4 mvpLeft;
+uniform mat4 mvpRight;
+uniform vec4 viewportLeft;
+uniform vec4 viewportRight;
+uniform vec2 targetSize;
+uniform float lineWidth;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+flat out int fragEye;
+
+// Pulls a point behind the near plane onto it along the line
+vec4 ClipToNear(vec4 p, vec4 other) {
+    float d = p.z + p.w;
+    if (d >= 0.0) return p;
+    float dOther = other.z + other.w;
+    return mix(p, other, d / (d - dOther));
+}
+
+void main() {
+    mat4 mvp = (gl_InstanceID == 0) ? mvpLeft : mvpRight;
+    vec4 viewport = (gl_InstanceID == 0) ? viewportLeft : viewportRight;
+
+    vec4 clip = mvp * vec4(vertexPosition, 1.0);
+    float side = vertexTexCoord2.x;
+    if (side != 0.0) {
+        vec4 other = mvp * vec4(vertexNormal, 1.0);
+        vec4 a = ClipToNear(clip, other);
+        vec4 b = ClipToNear(other, clip);
+        vec2 dir = (b.xy / b.w - a.xy / a.w) * viewport.zw;
+        vec2 normal = (dot(dir, dir) > 1e-12) ? normalize(vec2(-dir.y, dir.x)) : vec2(0.0);
+        clip = a;
+        clip.xy += normal * side * (lineWidth / viewport.zw) * clip.w;
+    }
+
+    // Squeeze the eye's NDC into its viewport of the shared target
+    vec2 scale = viewport.zw / targetSize;
+    vec2 offset = (2.0 * viewport.xy + viewport.zw) / targetSize - 1.0;
+    clip.xy = clip.xy * scale + offset * clip.w;
+
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    fragEye = gl_InstanceID;
+    gl_Position = clip;
+}
+)";
+
+const char* kStereoFragmentShader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+flat in int fragEye;
+
+uniform sampler2D texture0;
+uniform vec4 viewportLeft;
+uniform vec4 viewportRight;
+
+out vec4 finalColor;
+
+void main() {
+    // Geometry squeezed into one eye must not spill into the other
+    vec4 viewport = (fragEye == 0) ? viewportLeft : viewportRight;
+    vec2 pixel = gl_FragCoord.xy - viewport.xy;
+    if (pixel.x < 0.0 || pixel.y < 0.0 || pixel.x > viewport.z || pixel.y > viewport.w) discard;
+    finalColor = texture(texture0, fragTexCoord) * fragColor;
+}
+)";
+
+const int kEyes = 2;
+
+// Attribute layout of StereoVertex for the vertex buffer currently bound
+void SetVertexLayout() {
+    const int stride = static_cast<int>(sizeof(StereoVertex));
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, stride,
+        static_cast<int>(offsetof(StereoVertex, position)));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, stride,
+        static_cast<int>(offsetof(StereoVertex, texcoord)));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 3, RL_FLOAT, false, stride,
+        static_cast<int>(offsetof(StereoVertex, lineOther)));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, stride,
+        static_cast<int>(offsetof(StereoVertex, color)));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2, 1, RL_FLOAT, false, stride,
+        static_cast<int>(offsetof(StereoVertex, lineSide)));
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2);
+}
+
+} // namespace
+
+Matrix StereoEyeViewProjection(const Camera3D& camera, int targetWidth, int targetHeight) {
+    // Same matrices BeginMode3D builds for a perspective camera
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    double aspect = static_cast<double>(targetWidth) / static_cast<double>(targetHeight);
+    Matrix projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect,
+        rlGetCullDistanceNear(), rlGetCullDistanceFar());
+    return MatrixMultiply(view, projection);
+}
+
+StereoRenderer::StereoRenderer() {
+    shader = { 0 };
+    vao = 0;
+    vbo = 0;
+    vboCapacity = 0;
+    staticVao = 0;
+    staticVbo = 0;
+    staticColoredCount = 0;
+    staticTexturedCount = 0;
+    staticTextureId = 0;
+    staticKey = 0;
+    hasStatic = false;
+    ready = false;
+    lineWidth = 1.0f;
+    locMvpLeft = locMvpRight = -1;
+    locViewportLeft = locViewportRight = -1;
+    locTargetSize = locLineWidth = -1;
+}
+
+StereoRenderer::~StereoRenderer() {
+    Unload();
+}
+
+bool StereoRenderer::Init() {
+    if (ready) return true;
+
+    // gl_InstanceID and instanced draws need a GL 3.3 context
+    int version = rlGetVersion();
+    if (version != RL_OPENGL_33 && version != RL_OPENGL_43) {
+        VR_LOG_WARN(LogChannel::Main, "Single-pass stereo needs OpenGL 3.3, using two-pass rendering");
+        return false;
+    }
+
+    shader = LoadShaderFromMemory(kStereoVertexShader, kStereoFragmentShader);
+    if (!IsShaderValid(shader) || shader.id == rlGetShaderIdDefault()) {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to compile single-pass stereo shader, using two-pass rendering");
+        shader = { 0 };
+        return false;
+    }
+
+    locMvpLeft = GetShaderLocation(shader, "mvpLeft");
+    locMvpRight = GetShaderLocation(shader, "mvpRight");
+    locViewportLeft = GetShaderLocation(shader, "viewportLeft");
+    locViewportRight = GetShaderLocation(shader, "viewportRight");
+    locTargetSize = GetShaderLocation(shader, "targetSize");
+    locLineWidth = GetShaderLocation(shader, "lineWidth");
+
+    vao = rlLoadVertexArray();
+    staticVao = rlLoadVertexArray();
+    if (vao == 0 || staticVao == 0) {
+        if (vao != 0) rlUnloadVertexArray(vao);
+        if (staticVao != 0) rlUnloadVertexArray(staticVao);
+        vao = staticVao = 0;
+        UnloadShader(shader);
+        shader = { 0 };
+        return false;
+    }
+
+    ready = true;
+    EnsureCapacity(16384);
+    VR_LOG_INFO(LogChannel::Main, "Single-pass stereo rendering enabled");
+    return true;
+}
+
+void StereoRenderer::Unload() {
+    if (vbo != 0) rlUnloadVertexBuffer(vbo);
+    if (vao != 0) rlUnloadVertexArray(vao);
+    if (staticVbo != 0) rlUnloadVertexBuffer(staticVbo);
+    if (staticVao != 0) rlUnloadVertexArray(staticVao);
+    if (shader.id != 0) UnloadShader(shader);
+    vbo = 0;
+    vao = 0;
+    vboCapacity = 0;
+    staticVbo = 0;
+    staticVao = 0;
+    hasStatic = false;
+    shader = { 0 };
+    ready = false;
+}
+
+void StereoRenderer::EnsureCapacity(int vertexCount) {
+    if (vertexCount <= vboCapacity) return;
+
+    int capacity = vboCapacity > 0 ? vboCapacity : 1024;
+    while (capacity < vertexCount) capacity *= 2;
+
+    rlEnableVertexArray(vao);
+    if (vbo != 0) rlUnloadVertexBuffer(vbo);
+    vbo = rlLoadVertexBuffer(nullptr, capacity * static_cast<int>(sizeof(StereoVertex)), true);
+    vboCapacity = capacity;
+
+    SetVertexLayout();
+    rlDisableVertexArray();
+}
+
+void StereoRenderer::BakeStatic(const StereoSceneBatch& batch, uint64_t key) {
+    if (!ready) return;
+
+    const auto& colored = batch.GetColored();
+    const auto& textured = batch.GetTextured();
+    int coloredCount = static_cast<int>(colored.size());
+    int texturedCount = batch.GetTextureId() != 0 ? static_cast<int>(textured.size()) : 0;
+    const int stride = static_cast<int>(sizeof(StereoVertex));
+
+    // Rebuilt from scratch; this only happens when the panel changes
+    rlEnableVertexArray(staticVao);
+    if (staticVbo != 0) rlUnloadVertexBuffer(staticVbo);
+    staticVbo = rlLoadVertexBuffer(nullptr, (coloredCount + texturedCount) * stride, false);
+    if (coloredCount > 0) rlUpdateVertexBuffer(staticVbo, colored.data(), coloredCount * stride, 0);
+    if (texturedCount > 0) rlUpdateVertexBuffer(staticVbo, textured.data(), texturedCount * stride, coloredCount * stride);
+    SetVertexLayout();
+    rlDisableVertexArray();
+
+    staticColoredCount = coloredCount;
+    staticTexturedCount = texturedCount;
+    staticTextureId = batch.GetTextureId();
+    staticKey = key;
+    hasStatic = true;
+    stats.staticBakes++;
+    stats.uploadedVertices += static_cast<uint64_t>(coloredCount + texturedCount);
+}
+
+void StereoRenderer::DrawLayer(unsigned int layerVao, int coloredCount, int texturedCount, unsigned int textureId) {
+    if (coloredCount == 0 && texturedCount == 0) return;
+
+    rlEnableVertexArray(layerVao);
+    if (coloredCount > 0) {
+        rlEnableTexture(rlGetTextureIdDefault());
+        rlDrawVertexArrayInstanced(0, coloredCount, kEyes);
+        stats.drawCalls++;
+    }
+    if (texturedCount > 0) {
+        rlEnableTexture(textureId);
+        rlDrawVertexArrayInstanced(coloredCount, texturedCount, kEyes);
+        stats.drawCalls++;
+    }
+    stats.vertices += static_cast<uint64_t>(coloredCount + texturedCount);
+}
+
+void StereoRenderer::Render(const StereoSceneBatch& batch, const StereoEye eyes[2], int targetWidth, int targetHeight) {
+    if (!ready) return;
+    auto start = std::chrono::steady_clock::now();
+
+    const auto& colored = batch.GetColored();
+    const auto& textured = batch.GetTextured();
+    int coloredCount = static_cast<int>(colored.size());
+    int texturedCount = batch.GetTextureId() != 0 ? static_cast<int>(textured.size()) : 0;
+
+    // Anything raylib queued so far goes first so draw order matches the two-pass path
+    rlDrawRenderBatchActive();
+
+    EnsureCapacity(coloredCount + texturedCount);
+    const int stride = static_cast<int>(sizeof(StereoVertex));
+    if (coloredCount > 0) rlUpdateVertexBuffer(vbo, colored.data(), coloredCount * stride, 0);
+    if (texturedCount > 0) rlUpdateVertexBuffer(vbo, textured.data(), texturedCount * stride, coloredCount * stride);
+    stats.uploadedVertices += static_cast<uint64_t>(coloredCount + texturedCount);
+
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(locMvpLeft, StereoEyeViewProjection(eyes[0].camera, targetWidth, targetHeight));
+    rlSetUniformMatrix(locMvpRight, StereoEyeViewProjection(eyes[1].camera, targetWidth, targetHeight));
+    float viewports[kEyes][4];
+    for (int eye = 0; eye < kEyes; eye++) {
+        viewports[eye][0] = static_cast<float>(eyes[eye].viewportX);
+        viewports[eye][1] = static_cast<float>(eyes[eye].viewportY);
+        viewports[eye][2] = static_cast<float>(eyes[eye].viewportWidth);
+        viewports[eye][3] = static_cast<float>(eyes[eye].viewportHeight);
+    }
+    rlSetUniform(locViewportLeft, viewports[0], RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locViewportRight, viewports[1], RL_SHADER_UNIFORM_VEC4, 1);
+    float target[2] = { static_cast<float>(targetWidth), static_cast<float>(targetHeight) };
+    rlSetUniform(locTargetSize, target, RL_SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(locLineWidth, &lineWidth, RL_SHADER_UNIFORM_FLOAT, 1);
+
+    // The batch does not keep raylib's face winding; every shape in it is closed or a
+    // single panel, so drawing without culling gives the same image
+    rlViewport(0, 0, targetWidth, targetHeight);
+    rlEnableDepthTest();
+    rlDisableBackfaceCulling();
+    rlActiveTextureSlot(0);
+
+    if (hasStatic) {
+        DrawLayer(staticVao, staticColoredCount, staticTexturedCount, staticTextureId);
+    }
+    DrawLayer(vao, coloredCount, texturedCount, batch.GetTextureId());
+
+    rlDisableTexture();
+    rlDisableShader();
+    rlDisableVertexArray();
+    rlEnableBackfaceCulling();
+    rlDisableDepthTest();
+
+    stats.frames++;
+    stats.submitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+StereoRenderer::Stats StereoRenderer::TakeStats() {
+    Stats result = stats;
+    stats = Stats();
+    return result;
+}
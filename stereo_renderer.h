@@ -0,0 +1,82 @@
+#pragma once
+
+#include "raylib.h"
+#include "stereo_scene.h"
+#include <cstdint>
+
+// Per-eye view of the shared render target
+struct StereoEye {
+    Camera3D camera;
+    int viewportX;
+    int viewportY;
+    int viewportWidth;
+    int viewportHeight;
+};
+
+// View-projection for one eye rendered into a target of the given size
+Matrix StereoEyeViewProjection(const Camera3D& camera, int targetWidth, int targetHeight);
+
+/**
+ * Draws a StereoSceneBatch into both eyes with one instanced draw per range:
+ * gl_InstanceID picks the eye's view-projection and viewport, and fragments
+ * outside that eye's viewport are discarded. Needs OpenGL 3.3; callers fall
+ * back to drawing the scene once per eye when Init() fails.
+ */
+class StereoRenderer {
+public:
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t drawCalls = 0;
+        uint64_t vertices = 0;          // drawn per eye, static layer included
+        uint64_t uploadedVertices = 0;
+        uint64_t staticBakes = 0;
+        double buildMs = 0.0;    // accumulated by the caller through AddBuildTime
+        double submitMs = 0.0;
+    };
+
+    StereoRenderer();
+    ~StereoRenderer();
+
+    bool Init();
+    void Unload();
+    bool IsReady() const { return ready; }
+
+    // Static layer: geometry that only changes with the panel (grid, panel quad or
+    // placeholder) is baked once into its own buffer and drawn ahead of every
+    // per-frame batch until it is baked again under a different key
+    void BakeStatic(const StereoSceneBatch& batch, uint64_t key);
+    bool IsStaticCurrent(uint64_t key) const { return hasStatic && staticKey == key; }
+
+    // Renders the static layer and then batch into the currently bound target of size targetWidth x targetHeight
+    void Render(const StereoSceneBatch& batch, const StereoEye eyes[2], int targetWidth, int targetHeight);
+
+    void SetLineWidth(float pixels) { lineWidth = pixels; }
+    void AddBuildTime(double ms) { stats.buildMs += ms; }
+    Stats TakeStats();
+
+private:
+    Shader shader;
+    unsigned int vao;
+    unsigned int vbo;
+    int vboCapacity;   // vertices
+    unsigned int staticVao;
+    unsigned int staticVbo;
+    int staticColoredCount;
+    int staticTexturedCount;
+    unsigned int staticTextureId;
+    uint64_t staticKey;
+    bool hasStatic;
+    bool ready;
+    float lineWidth;
+    Stats stats;
+
+    int locMvpLeft;
+    int locMvpRight;
+    int locViewportLeft;
+    int locViewportRight;
+    int locTargetSize;
+    int locLineWidth;
+
+    void EnsureCapacity(int vertexCount);
+    void DrawLayer(unsigned int layerVao, int coloredCount, int texturedCount, unsigned int textureId);
+};
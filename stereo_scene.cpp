@@ -0,0 +1,112 @@
+#include "stereo_scene.h"
+#include "raymath.h"
+#include <cmath>
+
+namespace {
+
+const int kSphereRings = 16;     // DrawSphere tessellation
+const int kSphereSlices = 16;
+
+StereoVertex MakeVertex(Vector3 p, Color color) {
+    return { p, p, { 0.0f, 0.0f }, 0.0f, color };
+}
+
+} // namespace
+
+StereoSceneBatch::StereoSceneBatch() {
+    textureId = 0;
+    colored.reserve(16384);
+    textured.reserve(6);
+
+    // Unit sphere as a triangle list, same ring/slice layout as DrawSphereEx
+    for (int ring = 0; ring < kSphereRings + 2; ring++) {
+        float lat0 = DEG2RAD * (270.0f + (180.0f / (kSphereRings + 1)) * ring);
+        float lat1 = DEG2RAD * (270.0f + (180.0f / (kSphereRings + 1)) * (ring + 1));
+        for (int slice = 0; slice < kSphereSlices; slice++) {
+            float lon0 = DEG2RAD * (360.0f * slice / kSphereSlices);
+            float lon1 = DEG2RAD * (360.0f * (slice + 1) / kSphereSlices);
+            Vector3 a = { cosf(lat0) * sinf(lon0), sinf(lat0), cosf(lat0) * cosf(lon0) };
+            Vector3 b = { cosf(lat1) * sinf(lon1), sinf(lat1), cosf(lat1) * cosf(lon1) };
+            Vector3 c = { cosf(lat1) * sinf(lon0), sinf(lat1), cosf(lat1) * cosf(lon0) };
+            Vector3 d = { cosf(lat0) * sinf(lon1), sinf(lat0), cosf(lat0) * cosf(lon1) };
+            unitSphere.insert(unitSphere.end(), { a, b, c, a, d, b });
+        }
+    }
+}
+
+void StereoSceneBatch::Clear() {
+    colored.clear();
+    textured.clear();
+    textureId = 0;
+}
+
+void StereoSceneBatch::Line(Vector3 a, Vector3 b, Color color) {
+    // Quad A-, B-, B+, A+ once the shader offsets each end along its own screen normal
+    StereoVertex aLow = { a, b, { 0.0f, 0.0f }, -1.0f, color };
+    StereoVertex aHigh = { a, b, { 0.0f, 0.0f }, 1.0f, color };
+    StereoVertex bLow = { b, a, { 0.0f, 0.0f }, 1.0f, color };
+    StereoVertex bHigh = { b, a, { 0.0f, 0.0f }, -1.0f, color };
+    colored.insert(colored.end(), { aLow, bLow, bHigh, aLow, bHigh, aHigh });
+}
+
+void StereoSceneBatch::Triangle(Vector3 a, Vector3 b, Vector3 c, Color color) {
+    colored.insert(colored.end(), { MakeVertex(a, color), MakeVertex(b, color), MakeVertex(c, color) });
+}
+
+void StereoSceneBatch::Sphere(Vector3 center, float radius, Color color) {
+    for (const Vector3& p : unitSphere) {
+        colored.push_back(MakeVertex(Vector3Add(center, Vector3Scale(p, radius)), color));
+    }
+}
+
+void StereoSceneBatch::Grid(int slices, float spacing) {
+    int halfSlices = slices / 2;
+    float extent = halfSlices * spacing;
+    for (int i = -halfSlices; i <= halfSlices; i++) {
+        Color color = (i == 0) ? Color{ 127, 127, 127, 255 } : Color{ 191, 191, 191, 255 };
+        float offset = i * spacing;
+        Line({ offset, 0.0f, -extent }, { offset, 0.0f, extent }, color);
+        Line({ -extent, 0.0f, offset }, { extent, 0.0f, offset }, color);
+    }
+}
+
+void StereoSceneBatch::Cube(Vector3 center, float width, float height, float length, Color color) {
+    float x0 = center.x - width / 2, x1 = center.x + width / 2;
+    float y0 = center.y - height / 2, y1 = center.y + height / 2;
+    float z0 = center.z - length / 2, z1 = center.z + length / 2;
+    auto face = [&](Vector3 a, Vector3 b, Vector3 c, Vector3 d) {
+        Triangle(a, b, c, color);
+        Triangle(a, c, d, color);
+    };
+    face({ x0, y0, z1 }, { x1, y0, z1 }, { x1, y1, z1 }, { x0, y1, z1 });   // front
+    face({ x1, y0, z0 }, { x0, y0, z0 }, { x0, y1, z0 }, { x1, y1, z0 });   // back
+    face({ x0, y1, z1 }, { x1, y1, z1 }, { x1, y1, z0 }, { x0, y1, z0 });   // top
+    face({ x0, y0, z0 }, { x1, y0, z0 }, { x1, y0, z1 }, { x0, y0, z1 });   // bottom
+    face({ x1, y0, z1 }, { x1, y0, z0 }, { x1, y1, z0 }, { x1, y1, z1 });   // right
+    face({ x0, y0, z0 }, { x0, y0, z1 }, { x0, y1, z1 }, { x0, y1, z0 });   // left
+}
+
+void StereoSceneBatch::CubeWires(Vector3 center, float width, float height, float length, Color color) {
+    float x0 = center.x - width / 2, x1 = center.x + width / 2;
+    float y0 = center.y - height / 2, y1 = center.y + height / 2;
+    float z0 = center.z - length / 2, z1 = center.z + length / 2;
+    for (float z : { z0, z1 }) {
+        Line({ x0, y0, z }, { x1, y0, z }, color);
+        Line({ x1, y0, z }, { x1, y1, z }, color);
+        Line({ x1, y1, z }, { x0, y1, z }, color);
+        Line({ x0, y1, z }, { x0, y0, z }, color);
+    }
+    Line({ x0, y0, z0 }, { x0, y0, z1 }, color);
+    Line({ x1, y0, z0 }, { x1, y0, z1 }, color);
+    Line({ x1, y1, z0 }, { x1, y1, z1 }, color);
+    Line({ x0, y1, z0 }, { x0, y1, z1 }, color);
+}
+
+void StereoSceneBatch::TexturedQuad(const Vector3 corners[4], const Vector2 uvs[4], unsigned int texture) {
+    StereoVertex v[4];
+    for (int i = 0; i < 4; i++) {
+        v[i] = { corners[i], corners[i], uvs[i], 0.0f, WHITE };
+    }
+    textured.insert(textured.end(), { v[0], v[1], v[2], v[0], v[2], v[3] });
+    textureId = texture;
+}
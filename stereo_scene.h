@@ -0,0 +1,45 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// Interleaved vertex for the instanced stereo path. Lines are stored as quads whose
+// two sides are pushed apart in screen space by the vertex shader, per eye.
+struct StereoVertex {
+    Vector3 position;
+    Vector3 lineOther;   // far end of the line this vertex belongs to (position for triangles)
+    Vector2 texcoord;
+    float lineSide;      // -1/+1 for line vertices, 0 for triangles
+    Color color;
+};
+static_assert(sizeof(StereoVertex) == 40, "vertex layout is mirrored in the shader attributes");
+
+/**
+ * CPU-side scene geometry for one frame, built once and drawn for both eyes.
+ * Mirrors the raylib 3D shape calls the two-pass path uses.
+ */
+class StereoSceneBatch {
+public:
+    StereoSceneBatch();
+
+    void Clear();
+
+    void Line(Vector3 a, Vector3 b, Color color);
+    void Triangle(Vector3 a, Vector3 b, Vector3 c, Color color);
+    void Sphere(Vector3 center, float radius, Color color);
+    void Grid(int slices, float spacing);                          // same layout as DrawGrid
+    void Cube(Vector3 center, float width, float height, float length, Color color);
+    void CubeWires(Vector3 center, float width, float height, float length, Color color);
+    // Textured quad in a separate range; corners and UVs as in rlBegin(RL_QUADS)
+    void TexturedQuad(const Vector3 corners[4], const Vector2 uvs[4], unsigned int textureId);
+
+    const std::vector<StereoVertex>& GetColored() const { return colored; }
+    const std::vector<StereoVertex>& GetTextured() const { return textured; }
+    unsigned int GetTextureId() const { return textureId; }
+
+private:
+    std::vector<StereoVertex> colored;
+    std::vector<StereoVertex> textured;
+    unsigned int textureId;
+    std::vector<Vector3> unitSphere;   // triangle list, built once
+};
@@ -0,0 +1,383 @@
+#include "stream_server.h"
+#include "frame_header.h"
+#include "metrics_registry.h"
+#include "thread_topology.h"
+#include "async_logger.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+constexpr uint8_t kNalIdr = 5;
+constexpr uint8_t kNalSps = 7;
+constexpr uint8_t kNalPps = 8;
+constexpr size_t kMaxRequestLine = 256;
+
+struct NalSummary {
+    bool idr = false;
+    bool sps = false;
+    bool pps = false;
+    std::vector<uint8_t> parameterSets;  // SPS and PPS NAL units with 4-byte start codes
+};
+
+size_t FindStartCode(const uint8_t* data, size_t size, size_t from) {
+    for (size_t i = from; i + 3 <= size; i++) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) return i;
+    }
+    return size;
+}
+
+// Walks the Annex B NAL units of one encoded packet
+NalSummary ScanNals(const uint8_t* data, size_t size) {
+    static const uint8_t kStartCode[] = { 0, 0, 0, 1 };
+    NalSummary summary;
+    size_t start = FindStartCode(data, size, 0);
+    while (start < size) {
+        size_t nal = start + 3;
+        size_t next = FindStartCode(data, size, nal);
+        // Zero bytes before the next start code are trailing_zero_8bits or the first
+        // byte of a 4-byte start code; a NAL unit never ends in zero
+        size_t end = next;
+        while (end > nal && data[end - 1] == 0) end--;
+        if (end > nal) {
+            uint8_t type = data[nal] & 0x1F;
+            if (type == kNalIdr) {
+                summary.idr = true;
+            }
+            else if (type == kNalSps || type == kNalPps) {
+                (type == kNalSps ? summary.sps : summary.pps) = true;
+                summary.parameterSets.insert(summary.parameterSets.end(), std::begin(kStartCode), std::end(kStartCode));
+                summary.parameterSets.insert(summary.parameterSets.end(), data + nal, data + end);
+            }
+        }
+        start = next;
+    }
+    return summary;
+}
+
+std::vector<uint8_t> FrameRecord(const uint8_t* payload, size_t size, uint32_t width, uint32_t height, uint32_t timestampMs) {
+    FrameHeader header;
+    header.timestamp_ms = timestampMs;
+    header.frame_size = static_cast<uint32_t>(size);
+    header.width = width;
+    header.height = height;
+    header.pixel_format = 2;  // H264
+
+    std::vector<uint8_t> bytes(sizeof(header) + size);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (size > 0) {
+        std::memcpy(bytes.data() + sizeof(header), payload, size);
+    }
+    return bytes;
+}
+
+MetricGauge& ClientsMetric() {
+    static MetricGauge& gauge = MetricsRegistry::instance().Gauge("vr_stream_clients", "Stream server clients connected");
+    return gauge;
+}
+
+MetricCounter& DroppedMetric() {
+    static MetricCounter& counter = MetricsRegistry::instance().Counter("vr_stream_packets_dropped_total",
+        "Packets stream server clients skipped to catch up to a keyframe");
+    return counter;
+}
+
+} // namespace
+
+StreamServer::~StreamServer() {
+    Stop();
+}
+
+bool StreamServer::Start(const std::string& path) {
+    if (running) return false;
+
+    listenSocket = ListenLocalSocket(path, static_cast<int>(kMaxClients), true);
+    if (listenSocket == kInvalidSocket || !OpenWakePair(wakeSockets)) {
+        VR_LOG_WARN(LogChannel::Frame, "Stream socket {} unavailable (error {})", path, LastSocketError());
+        if (listenSocket != kInvalidSocket) {
+            CloseSocket(listenSocket);
+            RemoveSocketPath(path);
+        }
+        listenSocket = kInvalidSocket;
+        return false;
+    }
+
+    socketPath = path;
+    running = true;
+    worker = std::thread(&StreamServer::Run, this);
+    VR_LOG_INFO(LogChannel::Frame, "Stream server listening on {}", socketPath);
+    return true;
+}
+
+void StreamServer::Stop() {
+    if (!running) return;
+    running = false;
+    SignalWake(wakeSockets[1]);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    CloseSocket(listenSocket);
+    listenSocket = kInvalidSocket;
+    for (SocketHandle& socket : wakeSockets) {
+        CloseSocket(socket);
+        socket = kInvalidSocket;
+    }
+    RemoveSocketPath(socketPath);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ring.fill(nullptr);
+    lastKeyframe.reset();
+    lastParameterSets.reset();
+}
+
+void StreamServer::Publish(const uint8_t* payload, size_t size, uint32_t width, uint32_t height, uint32_t timestampMs) {
+    if (!running || size == 0) return;
+
+    NalSummary nals = ScanNals(payload, size);
+    auto packet = std::make_shared<Packet>();
+    packet->keyframe = nals.idr;
+    packet->parameterSets = nals.sps && nals.pps;
+    packet->bytes = FrameRecord(payload, size, width, height, timestampMs);
+
+    std::shared_ptr<Packet> parameterSets;
+    if (packet->parameterSets) {
+        parameterSets = std::make_shared<Packet>();
+        parameterSets->keyframe = false;
+        parameterSets->parameterSets = true;
+        parameterSets->bytes = FrameRecord(nals.parameterSets.data(), nals.parameterSets.size(), width, height, timestampMs);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        packet->sequence = headSequence++;
+        ring[packet->sequence % kRingSize] = packet;
+        if (packet->keyframe) {
+            lastKeyframe = packet;
+        }
+        if (parameterSets) {
+            parameterSets->sequence = packet->sequence;
+            lastParameterSets = parameterSets;
+        }
+        stats.published++;
+    }
+
+    SignalWake(wakeSockets[1]);
+}
+
+StreamServer::Stats StreamServer::TakeStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    result.clients = clients.size();
+    stats = Stats();
+    return result;
+}
+
+StreamServer::PacketRef StreamServer::At(uint64_t sequence) const {
+    return ring[sequence % kRingSize];
+}
+
+void StreamServer::Refill(Client& client) {
+    if (client.current || client.closed) return;  // a record is always finished before the next
+    if (!client.preface.empty()) {
+        client.current = std::move(client.preface.front());
+        client.preface.pop_front();
+        return;
+    }
+
+    uint64_t oldest = headSequence > kRingSize ? headSequence - kRingSize : 0;
+    uint64_t backlog = headSequence - client.nextSequence;
+    if (!client.waitingForKeyframe && (client.nextSequence < oldest || backlog > client.maxBacklog)) {
+        if (client.policy == BackpressurePolicy::Disconnect) {
+            client.closed = true;
+            stats.disconnected++;
+            return;
+        }
+        // Skip to the newest keyframe still in the ring, or wait for the next one
+        uint64_t target = headSequence;
+        if (lastKeyframe && lastKeyframe->sequence >= client.nextSequence && lastKeyframe->sequence >= oldest) {
+            target = lastKeyframe->sequence;
+        }
+        stats.packetsDropped += target - client.nextSequence;
+        DroppedMetric().Add(target - client.nextSequence);
+        stats.resyncs++;
+        client.nextSequence = target;
+        client.waitingForKeyframe = true;
+    }
+
+    while (client.nextSequence < headSequence) {
+        PacketRef packet = At(client.nextSequence++);
+        if (client.waitingForKeyframe && !packet->keyframe) {
+            stats.packetsDropped++;
+            DroppedMetric().Add();
+            continue;
+        }
+        client.waitingForKeyframe = false;
+        client.current = std::move(packet);
+        return;
+    }
+}
+
+void StreamServer::Run() {
+    AsyncLogger::instance().registerThread();
+    ThreadTopology::Scope threadScope("stream");
+    std::vector<SocketPollEntry> polled;
+
+    while (running) {
+        polled.clear();
+        polled.push_back({ wakeSockets[0], true, false });
+        polled.push_back({ listenSocket, true, false });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& client : clients) {
+                Refill(*client);
+                polled.push_back({ client->socket, true, client->current != nullptr });
+            }
+        }
+
+        if (!PollSockets(polled, -1)) {
+            VR_LOG_ERROR(LogChannel::Frame, "Stream server poll failed (error {})", LastSocketError());
+            break;
+        }
+        if (polled[0].readable) DrainWake(wakeSockets[0]);
+
+        // Clients accepted below are polled from the next pass on
+        for (size_t i = 2; i < polled.size(); i++) {
+            Client& client = *clients[i - 2];
+            const SocketPollEntry& entry = polled[i];
+            if (entry.readable) ReadRequest(client);
+            if (!client.closed && entry.writable) SendPending(client);
+            if (entry.failed) client.closed = true;
+        }
+        if (polled[1].readable) Accept();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = clients.begin(); it != clients.end();) {
+            if ((*it)->closed) {
+                CloseClient(**it);
+                it = clients.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        ClientsMetric().Set(static_cast<double>(clients.size()));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& client : clients) {
+        CloseClient(*client);
+    }
+    clients.clear();
+    ClientsMetric().Set(0.0);
+}
+
+void StreamServer::Accept() {
+    SocketHandle socket = AcceptLocalSocket(listenSocket, true);
+    if (socket == kInvalidSocket) return;
+
+    size_t connected;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (clients.size() >= kMaxClients) {
+            CloseSocket(socket);
+            VR_LOG_WARN(LogChannel::Frame, "Stream server full ({} clients), refusing connection", kMaxClients);
+            return;
+        }
+
+        auto client = std::make_unique<Client>();
+        client->socket = socket;
+        // Start from the cached keyframe so the decoder has a picture at once
+        uint64_t oldest = headSequence > kRingSize ? headSequence - kRingSize : 0;
+        if (lastKeyframe) {
+            if (!lastKeyframe->parameterSets && lastParameterSets) {
+                client->preface.push_back(lastParameterSets);
+            }
+            client->preface.push_back(lastKeyframe);
+            client->nextSequence = lastKeyframe->sequence + 1;
+        }
+        if (!lastKeyframe || client->nextSequence < oldest) {
+            client->nextSequence = headSequence;
+            client->waitingForKeyframe = true;
+        }
+        clients.push_back(std::move(client));
+        stats.joined++;
+        connected = clients.size();
+    }
+    VR_LOG_INFO(LogChannel::Frame, "Stream client joined ({} connected)", connected);
+}
+
+void StreamServer::ReadRequest(Client& client) {
+    char buffer[kMaxRequestLine];
+    long received = ReceiveSocket(client.socket, buffer, sizeof(buffer));
+    if (received == 0 || (received < 0 && !SocketWouldBlock())) {
+        client.closed = true;
+        return;
+    }
+    if (received < 0) return;
+
+    client.request.append(buffer, static_cast<size_t>(received));
+    size_t newline;
+    while ((newline = client.request.find('\n')) != std::string::npos) {
+        std::string_view line(client.request.data(), newline);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        size_t space = line.find(' ');
+        std::string_view name = line.substr(0, space);
+        size_t backlog = client.maxBacklog;
+        bool valid = name == "drop" || name == "disconnect";
+        if (valid && space != std::string_view::npos) {
+            std::string_view number = line.substr(space + 1);
+            auto [next, ec] = std::from_chars(number.data(), number.data() + number.size(), backlog);
+            valid = ec == std::errc() && next == number.data() + number.size() && backlog >= 1 && backlog <= kRingSize;
+        }
+        if (valid) {
+            client.policy = name == "drop" ? BackpressurePolicy::DropToKeyframe : BackpressurePolicy::Disconnect;
+            client.maxBacklog = backlog;
+            VR_LOG_INFO(LogChannel::Frame, "Stream client policy: {} max_backlog={}", std::string(name), backlog);
+        }
+        else {
+            VR_LOG_WARN(LogChannel::Frame, "Stream client sent unknown request: {}", std::string(line));
+        }
+        client.request.erase(0, newline + 1);
+    }
+    if (client.request.size() > kMaxRequestLine) {
+        client.request.clear();
+    }
+}
+
+bool StreamServer::SendPending(Client& client) {
+    if (!client.current) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Refill(client);
+    }
+    while (client.current) {
+        const auto& bytes = client.current->bytes;
+        long sent = SendSocket(client.socket, bytes.data() + client.offset, bytes.size() - client.offset);
+        if (sent < 0) {
+            if (SocketWouldBlock()) return true;  // polled for writing again on the next pass
+            client.closed = true;
+            return false;
+        }
+        client.offset += static_cast<size_t>(sent);
+        if (client.offset < bytes.size()) continue;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.packetsSent++;
+        stats.bytesSent += bytes.size();
+        client.current.reset();
+        client.offset = 0;
+        Refill(client);
+    }
+    return !client.closed;
+}
+
+void StreamServer::CloseClient(Client& client) {
+    CloseSocket(client.socket);
+    client.socket = kInvalidSocket;
+    client.current.reset();
+    client.preface.clear();
+    stats.left++;
+}
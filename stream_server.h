@@ -0,0 +1,115 @@
+#pragma once
+
+// No raylib and no windows.h here
+#include "local_socket.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Fans the encoded H.264 stream out to any number of local consumers (a second
+ * viewer, a recorder) over a Unix domain socket, next to the single stdout
+ * consumer. Every client receives the same FrameHeader + payload records that
+ * stdout carries.
+ *
+ * Publish copies each packet once into a reference-counted buffer held by a ring
+ * of the last kRingSize packets; clients hold references while they send, so a
+ * slow client never copies and never blocks the encoder. One server thread
+ * multiplexes the listening socket and all clients with poll() (WSAPoll on
+ * Windows, where the socket is Winsock AF_UNIX).
+ *
+ * A client that joins is sent the cached SPS/PPS and the last keyframe, followed
+ * by the packets encoded since, so it decodes at once without forcing an IDR.
+ *
+ * Backpressure is per client. Once a client is more than its backlog limit
+ * behind (or the ring has overwritten its position), the drop policy skips it to
+ * the newest keyframe, or waits for the next one; the disconnect policy closes
+ * it. A client may pick its own by sending a line "drop <packets>" or
+ * "disconnect <packets>" after connecting.
+ */
+class StreamServer {
+public:
+    enum class BackpressurePolicy {
+        DropToKeyframe,
+        Disconnect
+    };
+
+    static constexpr size_t kRingSize = 256;
+    static constexpr size_t kMaxClients = 16;
+    static constexpr size_t kDefaultMaxBacklog = 30;   // packets, a quarter second at 120 fps
+
+    struct Stats {
+        uint64_t published = 0;
+        uint64_t joined = 0;
+        uint64_t left = 0;
+        uint64_t packetsSent = 0;
+        uint64_t bytesSent = 0;
+        uint64_t packetsDropped = 0;    // skipped by the drop policy, summed over clients
+        uint64_t resyncs = 0;           // times a client was skipped ahead to a keyframe
+        uint64_t disconnected = 0;      // closed by the disconnect policy
+        size_t clients = 0;             // connected now
+    };
+
+    ~StreamServer();
+
+    bool Start(const std::string& socketPath);
+    void Stop();
+    bool IsRunning() const { return running; }
+
+    // Encoder thread. Copies the Annex B payload once; a no-op while not running.
+    void Publish(const uint8_t* payload, size_t size, uint32_t width, uint32_t height, uint32_t timestampMs);
+
+    Stats TakeStats();
+
+private:
+    struct Packet {
+        uint64_t sequence;
+        bool keyframe;          // contains an IDR slice
+        bool parameterSets;     // contains SPS and PPS
+        std::vector<uint8_t> bytes;  // FrameHeader followed by the payload
+    };
+    using PacketRef = std::shared_ptr<const Packet>;
+
+    struct Client {
+        SocketHandle socket = kInvalidSocket;
+        BackpressurePolicy policy = BackpressurePolicy::DropToKeyframe;
+        size_t maxBacklog = kDefaultMaxBacklog;
+        std::deque<PacketRef> preface;  // parameter sets and keyframe for a joining client
+        PacketRef current;              // being written, from offset on
+        size_t offset = 0;
+        uint64_t nextSequence = 0;      // next ring packet to send
+        bool waitingForKeyframe = false;
+        std::string request;            // partial policy line
+        bool closed = false;
+    };
+
+    std::string socketPath;
+    std::atomic<bool> running{ false };
+    std::thread worker;
+    SocketHandle listenSocket = kInvalidSocket;
+    SocketHandle wakeSockets[2] = { kInvalidSocket, kInvalidSocket };
+
+    // Guards everything below; held briefly by Publish and by the worker between sends
+    std::mutex mutex;
+    std::array<PacketRef, kRingSize> ring;
+    uint64_t headSequence = 0;      // sequence the next published packet gets
+    PacketRef lastKeyframe;
+    PacketRef lastParameterSets;    // SPS and PPS alone, for keyframes that do not repeat them
+    std::vector<std::unique_ptr<Client>> clients;
+    Stats stats;
+
+    void Run();
+    void Accept();
+    void ReadRequest(Client& client);
+    bool SendPending(Client& client);
+    // Under mutex: applies the backpressure policy and picks the next packet to send
+    void Refill(Client& client);
+    PacketRef At(uint64_t sequence) const;
+    void CloseClient(Client& client);
+};
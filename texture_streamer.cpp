@@ -0,0 +1,525 @@
+// ONLY windows.h and raw GL in this file - NO RAYLIB
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#define STREAM_GLAPI __stdcall
+#else
+#include <dlfcn.h>
+#define STREAM_GLAPI
+#endif
+
+#include "texture_streamer.h"
+#include "async_logger.h"
+#include "thread_topology.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// The few GL entry points and enums the streaming path needs; raylib does not expose PBOs or fences
+typedef unsigned int GLenum;
+typedef unsigned int GLuint;
+typedef unsigned int GLbitfield;
+typedef int GLint;
+typedef int GLsizei;
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+typedef unsigned long long GLuint64;
+typedef void* GLsync;
+
+const GLenum GL_TEXTURE_2D = 0x0DE1;
+const GLenum GL_RGBA = 0x1908;
+const GLenum GL_RGBA8 = 0x8058;
+const GLenum GL_UNSIGNED_BYTE = 0x1401;
+const GLenum GL_TEXTURE_MIN_FILTER = 0x2801;
+const GLenum GL_TEXTURE_MAG_FILTER = 0x2800;
+const GLenum GL_TEXTURE_WRAP_S = 0x2802;
+const GLenum GL_TEXTURE_WRAP_T = 0x2803;
+const GLenum GL_TEXTURE_BASE_LEVEL = 0x813C;
+const GLenum GL_TEXTURE_MAX_LEVEL = 0x813D;
+const GLint GL_LINEAR = 0x2601;
+const GLint GL_LINEAR_MIPMAP_LINEAR = 0x2703;
+const GLint GL_REPEAT = 0x2901;
+const GLenum GL_UNPACK_ALIGNMENT = 0x0CF5;
+const GLenum GL_UNPACK_ROW_LENGTH = 0x0CF2;
+const GLenum GL_PIXEL_UNPACK_BUFFER = 0x88EC;
+const GLenum GL_STREAM_DRAW = 0x88E0;
+const GLbitfield GL_MAP_WRITE_BIT = 0x0002;
+const GLbitfield GL_MAP_INVALIDATE_BUFFER_BIT = 0x0008;
+const GLbitfield GL_MAP_UNSYNCHRONIZED_BIT = 0x0020;
+const GLbitfield GL_MAP_PERSISTENT_BIT = 0x0040;
+const GLbitfield GL_MAP_COHERENT_BIT = 0x0080;
+const GLenum GL_SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+const GLenum GL_ALREADY_SIGNALED = 0x911A;
+const GLenum GL_CONDITION_SATISFIED = 0x911C;
+const GLbitfield GL_SYNC_FLUSH_COMMANDS_BIT = 0x0001;
+
+struct StreamingGl {
+    void (STREAM_GLAPI* GenTextures)(GLsizei, GLuint*);
+    void (STREAM_GLAPI* DeleteTextures)(GLsizei, const GLuint*);
+    void (STREAM_GLAPI* BindTexture)(GLenum, GLuint);
+    void (STREAM_GLAPI* TexParameteri)(GLenum, GLenum, GLint);
+    void (STREAM_GLAPI* TexImage2D)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*);
+    void (STREAM_GLAPI* TexSubImage2D)(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*);
+    void (STREAM_GLAPI* PixelStorei)(GLenum, GLint);
+    void (STREAM_GLAPI* GenBuffers)(GLsizei, GLuint*);
+    void (STREAM_GLAPI* DeleteBuffers)(GLsizei, const GLuint*);
+    void (STREAM_GLAPI* BindBuffer)(GLenum, GLuint);
+    void (STREAM_GLAPI* BufferData)(GLenum, GLsizeiptr, const void*, GLenum);
+    void (STREAM_GLAPI* BufferStorage)(GLenum, GLsizeiptr, const void*, GLbitfield);   // GL 4.4, optional
+    void* (STREAM_GLAPI* MapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    unsigned char (STREAM_GLAPI* UnmapBuffer)(GLenum);
+    GLsync (STREAM_GLAPI* FenceSync)(GLenum, GLbitfield);
+    GLenum (STREAM_GLAPI* ClientWaitSync)(GLsync, GLbitfield, GLuint64);
+    void (STREAM_GLAPI* DeleteSync)(GLsync);
+};
+
+StreamingGl gl = {};
+bool glLoaded = false;
+
+void* LoadGlProc(const char* name) {
+#if defined(_WIN32)
+    void* proc = reinterpret_cast<void*>(wglGetProcAddress(name));
+    intptr_t value = reinterpret_cast<intptr_t>(proc);
+    if (value == 0 || value == 1 || value == 2 || value == 3 || value == -1) {
+        // GL 1.1 functions are only exported by opengl32.dll itself
+        static HMODULE opengl = LoadLibraryA("opengl32.dll");
+        proc = opengl ? reinterpret_cast<void*>(GetProcAddress(opengl, name)) : nullptr;
+    }
+    return proc;
+#else
+    return dlsym(RTLD_DEFAULT, name);
+#endif
+}
+
+template<typename T>
+bool Load(T& target, const char* name) {
+    target = reinterpret_cast<T>(LoadGlProc(name));
+    return target != nullptr;
+}
+
+bool LoadStreamingGl() {
+    if (glLoaded) return true;
+    bool ok = Load(gl.GenTextures, "glGenTextures") && Load(gl.DeleteTextures, "glDeleteTextures") &&
+        Load(gl.BindTexture, "glBindTexture") && Load(gl.TexParameteri, "glTexParameteri") &&
+        Load(gl.TexImage2D, "glTexImage2D") && Load(gl.TexSubImage2D, "glTexSubImage2D") &&
+        Load(gl.PixelStorei, "glPixelStorei") && Load(gl.GenBuffers, "glGenBuffers") &&
+        Load(gl.DeleteBuffers, "glDeleteBuffers") && Load(gl.BindBuffer, "glBindBuffer") &&
+        Load(gl.BufferData, "glBufferData") && Load(gl.MapBufferRange, "glMapBufferRange") &&
+        Load(gl.UnmapBuffer, "glUnmapBuffer") && Load(gl.FenceSync, "glFenceSync") &&
+        Load(gl.ClientWaitSync, "glClientWaitSync") && Load(gl.DeleteSync, "glDeleteSync");
+    Load(gl.BufferStorage, "glBufferStorage");
+    glLoaded = ok;
+    return ok;
+}
+
+bool FenceSignaled(GLsync fence, GLuint64 timeoutNs) {
+    GLenum result = gl.ClientWaitSync(fence, timeoutNs > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeoutNs);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+} // namespace
+
+TextureStreamer::TextureStreamer() {
+    texture = 0;
+    width = 0;
+    height = 0;
+    levels = 0;
+    baseLevel = 0;
+    chainBytes = 0;
+    chainValid = false;
+    chainLevel = 0;
+    ready = false;
+    persistent = false;
+    hasContent = false;
+    nextSequence = 0;
+    stopWorker = false;
+    fillMicros = 0;
+}
+
+TextureStreamer::~TextureStreamer() {
+    Unload();
+}
+
+bool TextureStreamer::Init(int frameWidth, int frameHeight) {
+    Unload();
+    if (frameWidth <= 0 || frameHeight <= 0) return false;
+    if (!LoadStreamingGl()) {
+        VR_LOG_WARN(LogChannel::Frame, "Pixel buffers or fences unavailable, desktop panel uploads stay synchronous");
+        return false;
+    }
+
+    width = frameWidth;
+    height = frameHeight;
+    baseLevel = 0;
+
+    // Full mip chain down to 1x1; every buffer holds all levels back to back
+    levels = 0;
+    chainBytes = 0;
+    while (levels < kMaxLevels) {
+        levelOffsets[levels] = chainBytes;
+        chainBytes += static_cast<size_t>(LevelWidth(levels)) * LevelHeight(levels) * 4;
+        levels++;
+        if (LevelWidth(levels - 1) == 1 && LevelHeight(levels - 1) == 1) break;
+    }
+    chain.assign(chainBytes, 0);
+    chainValid = false;
+    chainLevel = 0;
+
+    // Trilinear so the large, distant panel minifies without aliasing
+    gl.GenTextures(1, &texture);
+    gl.BindTexture(GL_TEXTURE_2D, texture);
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int level = 0; level < levels; level++) {
+        gl.TexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, LevelWidth(level), LevelHeight(level), 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl.BindTexture(GL_TEXTURE_2D, 0);
+
+    persistent = gl.BufferStorage != nullptr;
+    const GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    bool buffersOk = texture != 0;
+    for (Slot& slot : slots) {
+        gl.GenBuffers(1, &slot.buffer);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        if (persistent) {
+            gl.BufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(chainBytes), nullptr, persistentFlags);
+            slot.mapped = gl.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(chainBytes), persistentFlags);
+        }
+        else {
+            gl.BufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(chainBytes), nullptr, GL_STREAM_DRAW);
+        }
+        slot.state = SlotState::Free;
+        buffersOk = buffersOk && slot.buffer != 0 && (!persistent || slot.mapped != nullptr);
+    }
+    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!buffersOk) {
+        VR_LOG_ERROR(LogChannel::Frame, "Failed to create desktop panel upload buffers");
+        ready = true;   // lets Unload release what was created
+        Unload();
+        return false;
+    }
+
+    stopWorker = false;
+    worker = std::thread(&TextureStreamer::WorkerLoop, this);
+    ready = true;
+    VR_LOG_INFO(LogChannel::Frame, "Desktop panel streaming: {}x{} with {} mip levels through {} {} pixel buffers",
+        width, height, levels, kSlots, persistent ? "persistently mapped" : "mapped-per-frame");
+    return true;
+}
+
+void TextureStreamer::Unload() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopWorker = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+    pending.clear();
+
+    if (!ready) return;
+    // No fence waits: GL keeps a deleted buffer alive until the copies reading it have run
+    for (Slot& slot : slots) {
+        if (slot.fence) {
+            gl.DeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.buffer != 0) {
+            if (slot.mapped) {
+                gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+                gl.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+            gl.DeleteBuffers(1, &slot.buffer);
+        }
+        slot.buffer = 0;
+        slot.mapped = nullptr;
+        slot.state = SlotState::Free;
+        slot.frame = CapturedFrame();
+    }
+    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (texture != 0) gl.DeleteTextures(1, &texture);
+    texture = 0;
+    chain.clear();
+    chainValid = false;
+    ready = false;
+    hasContent = false;
+}
+
+int TextureStreamer::LevelForFrame(int frameWidth, int frameHeight, int downscale) const {
+    int level = 0;
+    while ((1 << level) < downscale) level++;
+    if ((1 << level) != downscale || level >= levels) return -1;
+    return frameWidth == LevelWidth(level) && frameHeight == LevelHeight(level) ? level : -1;
+}
+
+bool TextureStreamer::Submit(CapturedFrame&& frame) {
+    if (!ready) return false;
+    auto start = std::chrono::steady_clock::now();
+    stats.submitted++;
+
+    int level = LevelForFrame(frame.width, frame.height, frame.downscale);
+    if (level < 0 || frame.pixels.size() < LevelBytes(level)) {
+        stats.dropped++;
+        AddRenderTime(start);
+        return false;
+    }
+
+    RecycleCompleted();
+    int free = -1;
+    for (int i = 0; i < kSlots; i++) {
+        if (slots[i].state.load(std::memory_order_acquire) == SlotState::Free) {
+            free = i;
+            break;
+        }
+    }
+    if (free < 0) {
+        stats.dropped++;
+        AddRenderTime(start);
+        return false;
+    }
+
+    Slot& slot = slots[free];
+    if (!persistent) {
+        // Mapping must happen on the GL thread; the fence already proved the GPU is done with it
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        slot.mapped = gl.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(chainBytes),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!slot.mapped) {
+            stats.dropped++;
+            AddRenderTime(start);
+            return false;
+        }
+    }
+
+    slot.frame = std::move(frame);
+    slot.level = level;
+    slot.sequence = ++nextSequence;
+    slot.state.store(SlotState::Filling, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(free);
+    }
+    wake.notify_one();
+    AddRenderTime(start);
+    return true;
+}
+
+bool TextureStreamer::Update() {
+    if (!ready) return false;
+    auto start = std::chrono::steady_clock::now();
+
+    RecycleCompleted();
+
+    // Each slot only carries the region that changed since the one before it, so every filled
+    // slot is copied, oldest first
+    int order[kSlots];
+    int filled = 0;
+    for (int i = 0; i < kSlots; i++) {
+        if (slots[i].state.load(std::memory_order_acquire) == SlotState::Filled) order[filled++] = i;
+    }
+    std::sort(order, order + filled, [this](int a, int b) { return slots[a].sequence < slots[b].sequence; });
+
+    bool changed = false;
+    for (int n = 0; n < filled; n++) {
+        Slot& slot = slots[order[n]];
+        if (slot.dirty.width <= 0 || slot.dirty.height <= 0) {
+            ReleaseSlot(slot);
+            stats.unchanged++;
+            continue;
+        }
+
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        if (!persistent) {
+            gl.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            slot.mapped = nullptr;
+        }
+        gl.BindTexture(GL_TEXTURE_2D, texture);
+        gl.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (int level = slot.level; level < levels; level++) {
+            // Sources are offsets into the bound unpack buffer; the copies run on the GPU timeline
+            Rect rect = LevelRect(slot.dirty, slot.level, level);
+            int levelWidth = LevelWidth(level);
+            size_t offset = levelOffsets[level] + (static_cast<size_t>(rect.y) * levelWidth + rect.x) * 4;
+            gl.PixelStorei(GL_UNPACK_ROW_LENGTH, levelWidth);
+            gl.TexSubImage2D(GL_TEXTURE_2D, level, rect.x, rect.y, rect.width, rect.height,
+                GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+            stats.uploadedBytes += static_cast<uint64_t>(rect.width) * rect.height * 4;
+        }
+        gl.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        if (slot.level != baseLevel) {
+            // The first frame at a new downscale fills its whole level, so sampling can start
+            // there right after these copies; the levels above keep their old contents
+            gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, slot.level);
+            baseLevel = slot.level;
+        }
+        gl.BindTexture(GL_TEXTURE_2D, 0);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slot.fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.state.store(SlotState::Copying, std::memory_order_release);
+        stats.uploaded++;
+        hasContent = true;
+        changed = true;
+    }
+    AddRenderTime(start);
+    return changed;
+}
+
+void TextureStreamer::RecycleCompleted() {
+    for (Slot& slot : slots) {
+        if (slot.state.load(std::memory_order_acquire) != SlotState::Copying) continue;
+        if (slot.fence && !FenceSignaled(slot.fence, 0)) continue;
+        if (slot.fence) gl.DeleteSync(slot.fence);
+        slot.fence = nullptr;
+        slot.state.store(SlotState::Free, std::memory_order_release);
+    }
+}
+
+void TextureStreamer::ReleaseSlot(Slot& slot) {
+    if (!persistent && slot.mapped) {
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        gl.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        slot.mapped = nullptr;
+    }
+    slot.state.store(SlotState::Free, std::memory_order_release);
+}
+
+void TextureStreamer::WorkerLoop() {
+    ThreadTopology::Scope threadScope("upload");
+    while (true) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopWorker || !pending.empty(); });
+            if (stopWorker) return;
+            index = pending.front();
+            pending.pop_front();
+        }
+
+        Slot& slot = slots[index];
+        auto start = std::chrono::steady_clock::now();
+        if (slot.level != chainLevel) {
+            chainValid = false;   // nothing to diff against at the new level
+            chainLevel = slot.level;
+        }
+        slot.dirty = UpdateChain(slot.frame.pixels.data(), slot.level);
+        CopyToBuffer(slot);
+        slot.frame = CapturedFrame();   // the capture side allocates a fresh buffer per frame anyway
+        fillMicros += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        slot.state.store(SlotState::Filled, std::memory_order_release);
+    }
+}
+
+TextureStreamer::Rect TextureStreamer::UpdateChain(const uint8_t* pixels, int fromLevel) {
+    Rect dirty;
+    const int levelWidth = LevelWidth(fromLevel);
+    const int levelHeight = LevelHeight(fromLevel);
+    const size_t rowBytes = static_cast<size_t>(levelWidth) * 4;
+    uint8_t* base = chain.data() + levelOffsets[fromLevel];
+
+    if (!chainValid) {
+        memcpy(base, pixels, LevelBytes(fromLevel));
+        dirty = { 0, 0, levelWidth, levelHeight };
+        chainValid = true;
+    }
+    else {
+        // Bounding box of the pixels that differ from the previous frame
+        int left = levelWidth, right = -1, top = -1, bottom = -1;
+        for (int y = 0; y < levelHeight; y++) {
+            const uint8_t* src = pixels + y * rowBytes;
+            const uint8_t* old = base + y * rowBytes;
+            if (memcmp(src, old, rowBytes) == 0) continue;
+            if (top < 0) top = y;
+            bottom = y;
+            for (int x = 0; x < left; x++) {
+                if (memcmp(src + x * 4, old + x * 4, 4) != 0) { left = x; break; }
+            }
+            for (int x = levelWidth - 1; x > right; x--) {
+                if (memcmp(src + x * 4, old + x * 4, 4) != 0) { right = x; break; }
+            }
+        }
+        if (top < 0) return dirty;
+
+        dirty = { left, top, right - left + 1, bottom - top + 1 };
+        for (int y = top; y <= bottom; y++) {
+            size_t offset = y * rowBytes + static_cast<size_t>(left) * 4;
+            memcpy(base + offset, pixels + offset, static_cast<size_t>(dirty.width) * 4);
+        }
+    }
+
+    // 2x2 box filter, level by level, only over the texels the change can reach
+    for (int level = fromLevel + 1; level < levels; level++) {
+        Rect rect = LevelRect(dirty, fromLevel, level);
+        int srcWidth = LevelWidth(level - 1);
+        int srcHeight = LevelHeight(level - 1);
+        const uint8_t* src = chain.data() + levelOffsets[level - 1];
+        uint8_t* dst = chain.data() + levelOffsets[level];
+        int dstWidth = LevelWidth(level);
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            int y0 = std::min(y * 2, srcHeight - 1);
+            int y1 = std::min(y * 2 + 1, srcHeight - 1);
+            for (int x = rect.x; x < rect.x + rect.width; x++) {
+                int x0 = std::min(x * 2, srcWidth - 1);
+                int x1 = std::min(x * 2 + 1, srcWidth - 1);
+                const uint8_t* a = src + (static_cast<size_t>(y0) * srcWidth + x0) * 4;
+                const uint8_t* b = src + (static_cast<size_t>(y0) * srcWidth + x1) * 4;
+                const uint8_t* c = src + (static_cast<size_t>(y1) * srcWidth + x0) * 4;
+                const uint8_t* d = src + (static_cast<size_t>(y1) * srcWidth + x1) * 4;
+                uint8_t* out = dst + (static_cast<size_t>(y) * dstWidth + x) * 4;
+                for (int channel = 0; channel < 4; channel++) {
+                    out[channel] = static_cast<uint8_t>((a[channel] + b[channel] + c[channel] + d[channel] + 2) >> 2);
+                }
+            }
+        }
+    }
+    return dirty;
+}
+
+void TextureStreamer::CopyToBuffer(const Slot& slot) const {
+    if (slot.dirty.width <= 0 || slot.dirty.height <= 0) return;
+    uint8_t* mapped = static_cast<uint8_t*>(slot.mapped);
+    for (int level = slot.level; level < levels; level++) {
+        Rect rect = LevelRect(slot.dirty, slot.level, level);
+        size_t rowBytes = static_cast<size_t>(LevelWidth(level)) * 4;
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            size_t offset = levelOffsets[level] + y * rowBytes + static_cast<size_t>(rect.x) * 4;
+            memcpy(mapped + offset, chain.data() + offset, static_cast<size_t>(rect.width) * 4);
+        }
+    }
+}
+
+TextureStreamer::Rect TextureStreamer::LevelRect(const Rect& rect, int fromLevel, int level) const {
+    // Every texel of this level whose 2^shift footprint touches the rectangle
+    int shift = level - fromLevel;
+    int x0 = rect.x >> shift;
+    int y0 = rect.y >> shift;
+    int x1 = std::min(LevelWidth(level), (rect.x + rect.width + (1 << shift) - 1) >> shift);
+    int y1 = std::min(LevelHeight(level), (rect.y + rect.height + (1 << shift) - 1) >> shift);
+    return { x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0) };
+}
+
+void TextureStreamer::AddRenderTime(std::chrono::steady_clock::time_point start) {
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats.renderMs += ms;
+    if (ms > stats.maxRenderMs) stats.maxRenderMs = ms;
+}
+
+TextureStreamer::Stats TextureStreamer::TakeStats() {
+    Stats result = stats;
+    result.fillMs = fillMicros.exchange(0) / 1000.0;
+    stats = Stats();
+    return result;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+// Raw GL on purpose: this pairs with a windows.h translation unit, so no raylib here
+#include "screen_capture.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Streams captured desktop frames into a mipmapped RGBA8 texture through a ring
+ * of pixel-unpack buffers. A worker thread diffs each frame against the previous
+ * one, rebuilds the mip chain only inside the changed rectangle and copies that
+ * rectangle of every level into a mapped buffer (persistently mapped when GL 4.4
+ * buffer storage is available); the render thread only issues the
+ * buffer-to-texture copies, which the driver runs asynchronously. A fence per
+ * copy keeps a buffer out of the ring until the GPU has finished reading it, and
+ * a slot is only copied once the worker has written all of it, so the panel
+ * never samples a partially written frame.
+ *
+ * The texture is sized for the full desktop. A frame captured at a reduced
+ * resolution (a power-of-two downscale) fills the matching mip level and the
+ * levels below it, and GL_TEXTURE_BASE_LEVEL moves to that level with the same
+ * copy, so a downscale change never reallocates the texture or stalls on fences.
+ *
+ * Init, Submit, Update and Unload must be called on the thread that owns the GL context.
+ */
+class TextureStreamer {
+public:
+    static constexpr int kSlots = 3;
+    static constexpr int kMaxLevels = 16;
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t uploaded = 0;      // frames whose changed region was copied to the texture
+        uint64_t unchanged = 0;     // frames identical to the previous one, nothing uploaded
+        uint64_t dropped = 0;       // wrong size or no free slot
+        uint64_t uploadedBytes = 0; // texels sent across all mip levels
+        double renderMs = 0.0;      // render-thread time spent in Submit and Update
+        double maxRenderMs = 0.0;
+        double fillMs = 0.0;        // worker time diffing, filtering and copying frames
+    };
+
+    TextureStreamer();
+    ~TextureStreamer();
+
+    // Creates the texture and buffer ring; false if the context lacks PBOs or fences
+    bool Init(int width, int height);
+    void Unload();
+
+    bool IsReady() const { return ready; }
+    bool IsPersistent() const { return persistent; }
+    // True once a frame has been copied in; before that the texture contents are undefined
+    bool HasContent() const { return hasContent; }
+    unsigned int GetTextureId() const { return texture; }
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    int GetMipmapCount() const { return levels; }
+    int GetBaseLevel() const { return baseLevel; }
+    // Mip level a frame captured at 1/downscale fills, or -1 if it does not fit this texture
+    int LevelForFrame(int frameWidth, int frameHeight, int downscale) const;
+
+    // Hands a frame to the worker; false if it was dropped (wrong size or no free slot)
+    bool Submit(CapturedFrame&& frame);
+    // Once per rendered frame: recycles slots whose copy completed and uploads the filled ones in order.
+    // True when the texture contents changed.
+    bool Update();
+
+    Stats TakeStats();
+
+private:
+    enum class SlotState : uint8_t {
+        Free,      // owned by the render thread, buffer not in use by the GPU
+        Filling,   // owned by the worker
+        Filled,    // ready for the buffer-to-texture copy
+        Copying    // copy issued, waiting on its fence
+    };
+
+    struct Rect {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    struct Slot {
+        Rect dirty;                 // rectangle of `level` written by the worker
+        int level = 0;              // mip level the frame fills
+        unsigned int buffer = 0;
+        void* mapped = nullptr;
+        void* fence = nullptr;
+        std::atomic<SlotState> state{ SlotState::Free };
+        uint64_t sequence = 0;
+        CapturedFrame frame;
+    };
+
+    Slot slots[kSlots];
+    unsigned int texture;
+    int width;
+    int height;
+    int levels;
+    int baseLevel;              // GL_TEXTURE_BASE_LEVEL, render thread
+    size_t levelOffsets[kMaxLevels];
+    size_t chainBytes;
+    bool ready;
+    bool persistent;
+    bool hasContent;
+    uint64_t nextSequence;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<int> pending;
+    bool stopWorker;
+
+    // Worker-owned copy of the last frame and its mip chain, laid out like the buffers
+    std::vector<uint8_t> chain;
+    bool chainValid;
+    int chainLevel;             // level the chain was last built from
+
+    Stats stats;
+    std::atomic<uint64_t> fillMicros;
+
+    void WorkerLoop();
+    Rect UpdateChain(const uint8_t* pixels, int fromLevel);
+    void CopyToBuffer(const Slot& slot) const;
+    // Texels of `level` covered by a rectangle of `fromLevel`
+    Rect LevelRect(const Rect& rect, int fromLevel, int level) const;
+    size_t LevelBytes(int level) const { return static_cast<size_t>(LevelWidth(level)) * LevelHeight(level) * 4; }
+    int LevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int LevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    void RecycleCompleted();
+    void ReleaseSlot(Slot& slot);
+    void AddRenderTime(std::chrono::steady_clock::time_point start);
+};
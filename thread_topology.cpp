@@ -0,0 +1,403 @@
+#if defined(_WIN32)
+// ONLY platform headers here - NO RAYLIB
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include "thread_topology.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+#if !defined(_WIN32)
+const int kRealtimePriority = 10;   // SCHED_FIFO level: above normal threads, below kernel helpers
+const int kHighNice = -5;
+const int kLowNice = 5;
+#endif
+
+const char* PriorityName(ThreadPriority priority) {
+    switch (priority) {
+    case ThreadPriority::Low: return "low";
+    case ThreadPriority::Normal: return "normal";
+    case ThreadPriority::High: return "high";
+    case ThreadPriority::Realtime: return "realtime";
+    default: return "default";
+    }
+}
+
+bool ParsePriority(const std::string& text, ThreadPriority& priority) {
+    for (ThreadPriority candidate : { ThreadPriority::Low, ThreadPriority::Normal, ThreadPriority::High, ThreadPriority::Realtime }) {
+        if (text == PriorityName(candidate)) {
+            priority = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "2,3", "4-7" or "0-1,6"
+bool ParseCpus(const std::string& text, std::vector<int>& cpus) {
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find(',', start);
+        std::string part = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        int first = 0;
+        int last = 0;
+        char dash = 0;
+        int fields = std::sscanf(part.c_str(), "%d%c%d", &first, &dash, &last);
+        if (fields == 1) {
+            last = first;
+        }
+        else if (fields != 3 || dash != '-') {
+            return false;
+        }
+        if (first < 0 || last < first || last >= 1024) return false;
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+std::string FormatCpus(const std::vector<int>& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (!text.empty()) text += ',';
+        text += std::to_string(cpus[i]);
+        if (j > i) text += '-' + std::to_string(cpus[j]);
+        i = j;
+    }
+    return text;
+}
+
+#if defined(_WIN32)
+
+uintptr_t CurrentThreadHandle() {
+    HANDLE handle = nullptr;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle,
+        0, FALSE, DUPLICATE_SAME_ACCESS);
+    return reinterpret_cast<uintptr_t>(handle);
+}
+
+uint64_t CurrentThreadOsId() {
+    return GetCurrentThreadId();
+}
+
+void CloseThreadHandle(uintptr_t handle) {
+    if (handle) CloseHandle(reinterpret_cast<HANDLE>(handle));
+}
+
+void NameThread(uintptr_t handle, const std::string& name) {
+    // Windows 10 1607+; looked up at runtime so older systems just skip naming
+    using SetThreadDescriptionProc = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+    static auto setDescription = reinterpret_cast<SetThreadDescriptionProc>(
+        GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+    if (!setDescription) return;
+    std::wstring wide(name.begin(), name.end());
+    setDescription(reinterpret_cast<HANDLE>(handle), wide.c_str());
+}
+
+bool SetAffinity(uintptr_t handle, const std::vector<int>& cpus) {
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+    return mask != 0 && SetThreadAffinityMask(reinterpret_cast<HANDLE>(handle), mask) != 0;
+}
+
+std::string SetPriority(uintptr_t handle, uint64_t, ThreadPriority priority) {
+    int level = THREAD_PRIORITY_NORMAL;
+    const char* name = "normal";
+    switch (priority) {
+    case ThreadPriority::Low: level = THREAD_PRIORITY_LOWEST; name = "lowest"; break;
+    case ThreadPriority::High: level = THREAD_PRIORITY_HIGHEST; name = "highest"; break;
+    case ThreadPriority::Realtime: level = THREAD_PRIORITY_TIME_CRITICAL; name = "time-critical"; break;
+    default: break;
+    }
+    if (!SetThreadPriority(reinterpret_cast<HANDLE>(handle), level)) {
+        return std::string(name) + " refused (error " + std::to_string(GetLastError()) + ")";
+    }
+    return name;
+}
+
+std::vector<int> ProcessCpus() {
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    std::vector<int> cpus;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) return cpus;
+    for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); cpu++) {
+        if (processMask & (static_cast<DWORD_PTR>(1) << cpu)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+int CurrentNice() {
+    return 0;
+}
+
+std::string RestorePriority(uintptr_t handle, uint64_t, int) {
+    if (!SetThreadPriority(reinterpret_cast<HANDLE>(handle), THREAD_PRIORITY_NORMAL)) {
+        return "default refused (error " + std::to_string(GetLastError()) + ")";
+    }
+    return "default";
+}
+
+bool ReadCounters(uintptr_t handle, uint64_t, uint64_t& cpuNs, int64_t& involuntary) {
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(reinterpret_cast<HANDLE>(handle), &created, &exited, &kernel, &user)) return false;
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    cpuNs = (ticks(kernel) + ticks(user)) * 100;
+    involuntary = -1;   // Windows only counts all context switches, not preemptions
+    return true;
+}
+
+#else
+
+uintptr_t CurrentThreadHandle() {
+    return static_cast<uintptr_t>(pthread_self());
+}
+
+uint64_t CurrentThreadOsId() {
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+}
+
+void CloseThreadHandle(uintptr_t) {
+}
+
+void NameThread(uintptr_t handle, const std::string& name) {
+    // The kernel keeps 15 characters
+    pthread_setname_np(static_cast<pthread_t>(handle), name.substr(0, 15).c_str());
+}
+
+bool SetAffinity(uintptr_t handle, const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(static_cast<pthread_t>(handle), sizeof(set), &set) == 0;
+}
+
+std::string SetPriority(uintptr_t handle, uint64_t tid, ThreadPriority priority) {
+    pthread_t thread = static_cast<pthread_t>(handle);
+    if (priority == ThreadPriority::Realtime) {
+        sched_param param = {};
+        param.sched_priority = kRealtimePriority;
+        if (pthread_setschedparam(thread, SCHED_FIFO, &param) == 0) {
+            return "SCHED_FIFO/" + std::to_string(kRealtimePriority);
+        }
+        // Needs CAP_SYS_NICE or an RLIMIT_RTPRIO allowance; the best unprivileged fallback is nice
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), kHighNice) == 0) {
+            return "nice " + std::to_string(kHighNice) + " (SCHED_FIFO not permitted)";
+        }
+        return "unchanged (SCHED_FIFO not permitted)";
+    }
+
+    // Leaving SCHED_FIFO first, in case an earlier spec made the thread real-time
+    sched_param param = {};
+    pthread_setschedparam(thread, SCHED_OTHER, &param);
+    int nice = priority == ThreadPriority::High ? kHighNice : priority == ThreadPriority::Low ? kLowNice : 0;
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice) != 0) {
+        return "nice " + std::to_string(nice) + " not permitted";
+    }
+    return "nice " + std::to_string(nice);
+}
+
+std::vector<int> ProcessCpus() {
+    // The calling thread's mask; the topology is created at startup, before anything is pinned
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+int CurrentNice() {
+    return getpriority(PRIO_PROCESS, 0);   // the calling thread on Linux
+}
+
+std::string RestorePriority(uintptr_t handle, uint64_t tid, int baselineNice) {
+    sched_param param = {};
+    pthread_setschedparam(static_cast<pthread_t>(handle), SCHED_OTHER, &param);
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), baselineNice) != 0) {
+        return "default (nice " + std::to_string(baselineNice) + " not permitted)";
+    }
+    return "default";
+}
+
+bool ReadCounters(uintptr_t handle, uint64_t tid, uint64_t& cpuNs, int64_t& involuntary) {
+    clockid_t clock;
+    timespec time;
+    if (pthread_getcpuclockid(static_cast<pthread_t>(handle), &clock) != 0 || clock_gettime(clock, &time) != 0) {
+        return false;
+    }
+    cpuNs = static_cast<uint64_t>(time.tv_sec) * 1000000000ull + static_cast<uint64_t>(time.tv_nsec);
+
+    involuntary = -1;
+    std::ifstream status("/proc/self/task/" + std::to_string(tid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("nonvoluntary_ctxt_switches:", 0) == 0) {
+            involuntary = std::strtoll(line.c_str() + line.find(':') + 1, nullptr, 10);
+            break;
+        }
+    }
+    return true;
+}
+
+#endif
+
+} // namespace
+
+ThreadTopology::Scope::Scope(const std::string& name) {
+    id = ThreadTopology::instance().Register(name);
+}
+
+ThreadTopology::Scope::~Scope() {
+    ThreadTopology::instance().Unregister(id);
+}
+
+ThreadTopology& ThreadTopology::instance() {
+    static ThreadTopology topology;
+    return topology;
+}
+
+ThreadTopology::ThreadTopology() {
+    baselineCpus = ProcessCpus();
+    baselineNice = CurrentNice();
+}
+
+bool ThreadTopology::Configure(const std::string& spec) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos || equals == 0) return false;
+
+    NamedConfig named;
+    named.name = spec.substr(0, equals);
+    std::string rest = spec.substr(equals + 1);
+    size_t colon = rest.find(':');
+    if (!ParseCpus(rest.substr(0, colon), named.config.cpus)) return false;
+    if (colon != std::string::npos && !ParsePriority(rest.substr(colon + 1), named.config.priority)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto existing = std::find_if(configs.begin(), configs.end(),
+        [&](const NamedConfig& config) { return config.name == named.name; });
+    if (existing != configs.end()) {
+        *existing = named;
+    }
+    else {
+        configs.push_back(named);
+    }
+    for (auto& entry : entries) {
+        if (const ThreadConfig* config = FindConfig(entry.name)) {
+            Apply(entry, *config);
+        }
+    }
+    return true;
+}
+
+uint64_t ThreadTopology::Register(const std::string& name) {
+    Entry entry;
+    entry.name = name;
+    entry.handle = CurrentThreadHandle();
+    entry.osId = CurrentThreadOsId();
+    entry.cpus = "all";
+    entry.policy = "default";
+    entry.pinned = false;
+    entry.prioritized = false;
+    entry.lastCpuNs = 0;
+    entry.lastInvoluntary = 0;
+    NameThread(entry.handle, name);
+    // Whatever the creating thread was pinned to or scheduled as is not this thread's to keep
+    if (!baselineCpus.empty()) SetAffinity(entry.handle, baselineCpus);
+    entry.policy = RestorePriority(entry.handle, entry.osId, baselineNice);
+    ReadCounters(entry.handle, entry.osId, entry.lastCpuNs, entry.lastInvoluntary);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entry.id = nextId++;
+    if (const ThreadConfig* config = FindConfig(name)) {
+        Apply(entry, *config);
+    }
+    entries.push_back(entry);
+    return entry.id;
+}
+
+void ThreadTopology::Unregister(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(entries.begin(), entries.end(), [id](const Entry& entry) { return entry.id == id; });
+    if (it != entries.end()) {
+        CloseThreadHandle(it->handle);
+        entries.erase(it);
+    }
+}
+
+const ThreadConfig* ThreadTopology::FindConfig(const std::string& name) const {
+    const ThreadConfig* fallback = nullptr;
+    for (const auto& named : configs) {
+        if (named.name == name) return &named.config;
+        if (named.name == "default") fallback = &named.config;
+    }
+    return fallback;
+}
+
+void ThreadTopology::Apply(Entry& entry, const ThreadConfig& config) {
+    if (!config.cpus.empty()) {
+        entry.pinned = SetAffinity(entry.handle, config.cpus);
+        entry.cpus = entry.pinned ? FormatCpus(config.cpus) : "all (" + FormatCpus(config.cpus) + " refused)";
+    }
+    else if (entry.pinned && !baselineCpus.empty()) {
+        // An earlier spec pinned it; this one does not
+        entry.pinned = !SetAffinity(entry.handle, baselineCpus);
+        entry.cpus = entry.pinned ? entry.cpus + " (unpin refused)" : "all";
+    }
+    if (config.priority != ThreadPriority::Default) {
+        entry.policy = SetPriority(entry.handle, entry.osId, config.priority);
+        entry.prioritized = true;
+    }
+    else if (entry.prioritized) {
+        entry.policy = RestorePriority(entry.handle, entry.osId, baselineNice);
+        entry.prioritized = false;
+    }
+    VR_LOG_INFO(LogChannel::Main, "Thread {} configured: cpus={} policy={}", entry.name, entry.cpus, entry.policy);
+}
+
+std::vector<ThreadTopology::ThreadReport> ThreadTopology::TakeReport() {
+    std::vector<ThreadReport> report;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : entries) {
+        uint64_t cpuNs = 0;
+        int64_t involuntary = -1;
+        if (!ReadCounters(entry.handle, entry.osId, cpuNs, involuntary)) continue;
+        ThreadReport thread;
+        thread.name = entry.name;
+        thread.cpus = entry.cpus;
+        thread.policy = entry.policy;
+        thread.cpuMs = (cpuNs - entry.lastCpuNs) / 1e6;
+        thread.involuntarySwitches = involuntary >= 0 ? involuntary - entry.lastInvoluntary : -1;
+        entry.lastCpuNs = cpuNs;
+        entry.lastInvoluntary = involuntary;
+        report.push_back(thread);
+    }
+    return report;
+}
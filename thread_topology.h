@@ -0,0 +1,104 @@
+#pragma once
+
+// No raylib and no windows.h here: pipeline threads on both sides of that split register
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class ThreadPriority {
+    Default,    // the process's own priority, as it was at startup
+    Low,
+    Normal,
+    High,
+    Realtime    // SCHED_FIFO on Linux when permitted, time-critical on Windows
+};
+
+struct ThreadConfig {
+    std::vector<int> cpus;  // empty means every CPU the process started with
+    ThreadPriority priority = ThreadPriority::Default;
+};
+
+/**
+ * Names the pipeline threads (render, capture, io, upload, input) for profilers
+ * and applies a per-name CPU set and priority to them. Configuration is given as
+ * "name=cpus[:priority]" specs and may arrive before or after a thread
+ * registers; the entry named "default" covers registered threads that have no
+ * entry of their own, which together with pinned pipeline threads keeps cores
+ * free of everything else this process schedules.
+ *
+ * A thread registers for its lifetime by constructing a Scope at the top of its
+ * entry function. Registering first drops the affinity and scheduling policy the
+ * thread inherited from its creator (a pinned, real-time render thread passes both
+ * on) and returns it to the process baseline captured when the topology was first
+ * used; an entry set back to empty CPUs or default priority restores that baseline
+ * as well.
+ *
+ * Threads the process does not register (drivers, runtime pools) keep whatever
+ * they inherit. The x264 pool is started from a thread registered as "encoder",
+ * so it gets that entry's configuration, or "default".
+ */
+class ThreadTopology {
+public:
+    struct ThreadReport {
+        std::string name;
+        std::string cpus;           // affinity as applied, "all" if untouched
+        std::string policy;         // scheduling policy as applied, with the reason if refused
+        double cpuMs;               // CPU time since the previous report
+        int64_t involuntarySwitches; // preemptions since the previous report; -1 where the OS does not count them
+    };
+
+    class Scope {
+    public:
+        explicit Scope(const std::string& name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint64_t id;
+    };
+
+    static ThreadTopology& instance();
+
+    // Parses one "name=cpus[:priority]" spec, cpus like "2,3" or "4-7" (may be empty),
+    // priority one of low, normal, high, realtime. Applies it to threads already registered.
+    bool Configure(const std::string& spec);
+
+    // One entry per live registered thread, counters relative to the previous call
+    std::vector<ThreadReport> TakeReport();
+
+private:
+    struct Entry {
+        uint64_t id;
+        std::string name;
+        uintptr_t handle;           // pthread_t, or a duplicated thread HANDLE on Windows
+        uint64_t osId;              // kernel thread id
+        std::string cpus;
+        std::string policy;
+        bool pinned;                // affinity set from a config
+        bool prioritized;           // priority set from a config
+        uint64_t lastCpuNs;
+        int64_t lastInvoluntary;
+    };
+
+    struct NamedConfig {
+        std::string name;
+        ThreadConfig config;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<NamedConfig> configs;
+    uint64_t nextId = 1;
+
+    // What a thread gets back when no config pins it or sets its priority
+    std::vector<int> baselineCpus;
+    int baselineNice = 0;
+
+    ThreadTopology();
+    uint64_t Register(const std::string& name);
+    void Unregister(uint64_t id);
+    const ThreadConfig* FindConfig(const std::string& name) const;
+    void Apply(Entry& entry, const ThreadConfig& config);
+};
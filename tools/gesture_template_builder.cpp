@@ -0,0 +1,264 @@
+// Builds the gesture template file from labelled hand captures and compares the
+// template classifier against the rule-based recognizer.
+//
+//   gesture_template_builder build <out.json> [--label NAME] [--min-spacing D] [--max-per-class N] <capture>...
+//   gesture_template_builder compare <templates.json> [--label NAME] <capture>...
+//
+// A capture is JSON lines, one frame per line: {"label": "POINT", "hands": [...]},
+// where "hands" uses the same objects as Shared/hands.dat. --label applies to
+// frames without their own label. Build the templates and compare on different
+// captures, otherwise the accuracy figure is meaningless.
+//
+// Compiled as a separate console program (tools/gesture_template_builder.vcxproj)
+// together with gesture_recognition.cpp, gesture_templates.cpp, motion_history.cpp,
+// thread_topology.cpp and async_logger.cpp.
+
+#include "../gesture_recognition.h"
+#include "../gesture_templates.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct LabelledHand {
+    GestureType label;
+    HandLandmarks hand;
+};
+
+struct Options {
+    std::string labelOverride;
+    float minSpacing = 0.002f;
+    size_t maxPerClass = 200;
+    std::vector<std::string> captures;
+};
+
+bool ToHandLandmarks(const nlohmann::json& json, HandLandmarks& hand) {
+    if (!json.contains("landmarks") || json["landmarks"].size() != 21) return false;
+    int i = 0;
+    for (const auto& lm : json["landmarks"]) {
+        hand.landmarks[i] = { lm.value("x", 0.0f), lm.value("y", 0.0f), lm.value("z", 0.0f) };
+        hand.active[i] = true;
+        i++;
+    }
+    hand.handedness = json.value("handedness", "");
+    hand.confidence = json.value("confidence", 0.7f);
+    return true;
+}
+
+size_t LoadCapture(const std::string& path, const std::string& labelOverride, std::vector<LabelledHand>& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 0;
+    }
+
+    size_t added = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        try {
+            nlohmann::json frame = nlohmann::json::parse(line);
+            std::string labelName = frame.value("label", labelOverride);
+            GestureType label;
+            if (labelName.empty() || !ParseGestureType(labelName, label) || !frame.contains("hands")) continue;
+
+            for (const auto& handJson : frame["hands"]) {
+                LabelledHand sample;
+                sample.label = label;
+                if (ToHandLandmarks(handJson, sample.hand)) {
+                    out.push_back(sample);
+                    added++;
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            fprintf(stderr, "%s: skipping bad line (%s)\n", path.c_str(), e.what());
+        }
+    }
+    return added;
+}
+
+bool ParseOptions(int argc, char** argv, int first, Options& options) {
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--label" && i + 1 < argc) {
+            options.labelOverride = argv[++i];
+        }
+        else if (arg == "--min-spacing" && i + 1 < argc) {
+            options.minSpacing = static_cast<float>(atof(argv[++i]));
+        }
+        else if (arg == "--max-per-class" && i + 1 < argc) {
+            options.maxPerClass = static_cast<size_t>(atoi(argv[++i]));
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+        else {
+            options.captures.push_back(arg);
+        }
+    }
+    return !options.captures.empty();
+}
+
+int Build(const std::string& outPath, const Options& options) {
+    std::vector<LabelledHand> samples;
+    for (const auto& capture : options.captures) {
+        LoadCapture(capture, options.labelOverride, samples);
+    }
+
+    // Greedy thinning: a sample only becomes a template if no template of the same
+    // class is already within minSpacing, which drops runs of near-identical frames
+    GestureTemplateClassifier classifier;
+    std::map<GestureType, std::vector<GestureFeatureVector>> kept;
+    size_t skipped = 0;
+    for (const auto& sample : samples) {
+        GestureFeatureVector features;
+        if (!NormalizeHandLandmarks(sample.hand, features)) {
+            skipped++;
+            continue;
+        }
+
+        auto& classTemplates = kept[sample.label];
+        if (classTemplates.size() >= options.maxPerClass) continue;
+
+        GestureTemplateClassifier same;
+        for (const auto& t : classTemplates) same.AddTemplate(sample.label, t);
+        if (same.HasTemplates() && same.NearestDistance(features) < options.minSpacing) continue;
+
+        classTemplates.push_back(features);
+        classifier.AddTemplate(sample.label, features);
+    }
+
+    if (!classifier.SaveTemplates(outPath)) {
+        fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+
+    printf("%zu hands read, %zu unusable, %zu templates written to %s\n",
+        samples.size(), skipped, classifier.GetTemplateCount(), outPath.c_str());
+    for (const auto& [type, templates] : kept) {
+        printf("  %-12s %zu\n", GestureTypeName(type), templates.size());
+    }
+    return 0;
+}
+
+struct Score {
+    size_t total = 0;
+    size_t ruleCorrect = 0;
+    size_t templateCorrect = 0;
+};
+
+double Percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1));
+    return values[index];
+}
+
+double Mean(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return sum / values.size();
+}
+
+int Compare(const std::string& templatePath, const Options& options) {
+    GestureTemplateClassifier classifier;
+    if (!classifier.LoadTemplates(templatePath) || !classifier.HasTemplates()) {
+        fprintf(stderr, "cannot load templates from %s\n", templatePath.c_str());
+        return 1;
+    }
+
+    std::vector<LabelledHand> samples;
+    for (const auto& capture : options.captures) {
+        LoadCapture(capture, options.labelOverride, samples);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    GestureRecognizer recognizer;
+    std::map<GestureType, Score> scores;
+    std::vector<double> ruleMicros, templateMicros;
+    ruleMicros.reserve(samples.size());
+    templateMicros.reserve(samples.size());
+
+    double timestamp = 0.0;
+    for (const auto& sample : samples) {
+        // Timestamps further apart than the motion history's max gap keep each
+        // hand independent, so only static poses are compared
+        timestamp += 1.0;
+
+        auto start = Clock::now();
+        HandFeatures features;
+        ComputeHandFeatures(sample.hand, features);
+        GestureData rule = recognizer.RecognizeGesture(sample.hand, features, timestamp);
+        auto middle = Clock::now();
+        GestureData matched = classifier.Classify(sample.hand);
+        auto end = Clock::now();
+
+        ruleMicros.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+        templateMicros.push_back(std::chrono::duration<double, std::micro>(end - middle).count());
+
+        Score& score = scores[sample.label];
+        score.total++;
+        if (rule.type == sample.label) score.ruleCorrect++;
+        if (matched.type == sample.label) score.templateCorrect++;
+    }
+
+    Score overall;
+    printf("%-12s %8s %8s %10s\n", "gesture", "hands", "rules", "templates");
+    for (const auto& [type, score] : scores) {
+        printf("%-12s %8zu %7.1f%% %9.1f%%\n", GestureTypeName(type), score.total,
+            100.0 * score.ruleCorrect / score.total, 100.0 * score.templateCorrect / score.total);
+        overall.total += score.total;
+        overall.ruleCorrect += score.ruleCorrect;
+        overall.templateCorrect += score.templateCorrect;
+    }
+    if (overall.total > 0) {
+        printf("%-12s %8zu %7.1f%% %9.1f%%\n", "overall", overall.total,
+            100.0 * overall.ruleCorrect / overall.total, 100.0 * overall.templateCorrect / overall.total);
+    }
+
+    printf("\nlatency per hand (us)   mean     p50     p99\n");
+    printf("rules               %7.2f %7.2f %7.2f\n", Mean(ruleMicros),
+        Percentile(ruleMicros, 0.5), Percentile(ruleMicros, 0.99));
+    printf("templates (%5zu)    %7.2f %7.2f %7.2f\n", classifier.GetTemplateCount(), Mean(templateMicros),
+        Percentile(templateMicros, 0.5), Percentile(templateMicros, 0.99));
+    return 0;
+}
+
+void PrintUsage() {
+    fprintf(stderr,
+        "usage:\n"
+        "  gesture_template_builder build <out.json> [--label NAME] [--min-spacing D] [--max-per-class N] <capture>...\n"
+        "  gesture_template_builder compare <templates.json> [--label NAME] <capture>...\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+    Options options;
+    if (!ParseOptions(argc, argv, 3, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    if (command == "build") return Build(argv[2], options);
+    if (command == "compare") return Compare(argv[2], options);
+
+    PrintUsage();
+    return 2;
+}
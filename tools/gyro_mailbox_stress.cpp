@@ -0,0 +1,217 @@
+// Stress test for the gyro mailbox: a synthetic producer pushes samples at a high
+// rate while a slower consumer drains it once per frame, the way the render loop does.
+//
+//   gyro_mailbox_stress [--seconds S] [--rate-hz R] [--consumer-hz F] [--work-ms W] [--queue]
+//
+// The defaults are a 1 kHz producer against a 60 Hz consumer that spends 12 ms of
+// every frame busy. Prints pushed, consumed and overwritten (coalesced) samples, the
+// deepest backlog, and the lag of the newest and oldest sample of every drain. Fails
+// when memory grew past the mailbox capacity, a sample arrived out of order, the
+// counts do not add up, or the newest sample was older than one consumer frame.
+//
+// --queue runs the old pattern for comparison: an unbounded ThreadSafeQueue popped
+// once per frame, which grows for as long as the producer outpaces the consumer.
+//
+// Compiled as a separate console program (tools/gyro_mailbox_stress.vcxproj, or
+// CMakeLists.txt on Linux); the mailbox is header-only, so no other sources are needed.
+
+#include "../gyro_thread.h"
+#include "../thread_safe_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using msd = std::chrono::duration<double, std::milli>;
+
+struct Options {
+    double seconds = 5.0;
+    double rateHz = 1000.0;
+    double consumerHz = 60.0;
+    double workMs = 12.0;
+    bool queue = false;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seconds" && hasValue) {
+            options.seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--rate-hz" && hasValue) {
+            options.rateHz = std::atof(argv[++i]);
+        }
+        else if (arg == "--consumer-hz" && hasValue) {
+            options.consumerHz = std::atof(argv[++i]);
+        }
+        else if (arg == "--work-ms" && hasValue) {
+            options.workMs = std::atof(argv[++i]);
+        }
+        else if (arg == "--queue") {
+            options.queue = true;
+        }
+        else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return options.seconds > 0.0 && options.rateHz > 0.0 && options.consumerHz > 0.0 && options.workMs >= 0.0;
+}
+
+Clock::duration Period(double hz) {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+// Stands in for rendering and encoding a frame
+void Busy(double ms) {
+    auto until = Clock::now() + std::chrono::duration_cast<Clock::duration>(msd(ms));
+    while (Clock::now() < until) {
+    }
+}
+
+double Percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Sample i carries its sequence number in yaw, so order and loss can be checked
+template<typename PushFn>
+std::thread StartProducer(const Options& options, std::atomic<bool>& stop, PushFn push) {
+    return std::thread([&options, &stop, push] {
+        auto interval = Period(options.rateHz);
+        auto next = Clock::now();
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+            push(GyroData{ static_cast<float>(i), 0.0f, 0.0f, Clock::now() });
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+    });
+}
+
+int RunMailbox(const Options& options) {
+    GyroMailbox mailbox;
+    std::atomic<bool> stop{ false };
+    std::thread producer = StartProducer(options, stop, [&mailbox](const GyroData& sample) { mailbox.push(sample); });
+
+    std::vector<GyroData> batch;
+    batch.reserve(GyroMailbox::capacity());
+    const size_t reserved = batch.capacity();
+    std::vector<double> newestLagMs;
+    std::vector<double> oldestLagMs;
+    size_t maxBatch = 0;
+    float lastSequence = -1.0f;
+    bool orderOk = true;
+
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    auto frame = Period(options.consumerHz);
+    auto next = start;
+    while (Clock::now() < end) {
+        batch.clear();
+        mailbox.drain(batch);
+        auto now = Clock::now();
+        if (!batch.empty()) {
+            newestLagMs.push_back(msd(now - batch.back().timestamp).count());
+            oldestLagMs.push_back(msd(now - batch.front().timestamp).count());
+            maxBatch = std::max(maxBatch, batch.size());
+            for (const auto& sample : batch) {
+                if (sample.yaw <= lastSequence) orderOk = false;
+                lastSequence = sample.yaw;
+            }
+        }
+        Busy(options.workMs);
+        next += frame;
+        std::this_thread::sleep_until(next);
+    }
+    stop = true;
+    producer.join();
+
+    auto stats = mailbox.stats();
+    uint64_t pending = mailbox.size();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    bool countsOk = stats.pushed == stats.consumed + stats.overwritten + pending;
+    bool boundedOk = batch.capacity() == reserved && stats.maxBacklog <= GyroMailbox::capacity();
+    double frameMs = 1000.0 / options.consumerHz;
+    double newestMax = newestLagMs.empty() ? 0.0 : *std::max_element(newestLagMs.begin(), newestLagMs.end());
+    // The newest sample can be at most one producer interval old when the frame starts
+    // plus whatever the consumer itself overran; a frame's worth is the limit.
+    bool lagOk = !newestLagMs.empty() && Percentile(newestLagMs, 0.99) < frameMs;
+
+    std::printf("producer:       %llu samples, %.0f Hz achieved\n",
+        static_cast<unsigned long long>(stats.pushed), stats.pushed / seconds);
+    std::printf("consumer:       %zu frames, %llu samples consumed, max batch %zu\n",
+        newestLagMs.size(), static_cast<unsigned long long>(stats.consumed), maxBatch);
+    std::printf("coalesced:      %llu overwritten before they were drained (%.1f%%)\n",
+        static_cast<unsigned long long>(stats.overwritten),
+        stats.pushed > 0 ? 100.0 * stats.overwritten / stats.pushed : 0.0);
+    std::printf("memory:         capacity %zu samples (%zu bytes), max backlog %zu, batch buffer %s\n",
+        GyroMailbox::capacity(), sizeof(GyroMailbox), stats.maxBacklog, batch.capacity() == reserved ? "never grew" : "GREW");
+    std::printf("newest lag ms:  p50 %.3f, p99 %.3f, max %.3f\n",
+        Percentile(newestLagMs, 0.5), Percentile(newestLagMs, 0.99), newestMax);
+    std::printf("oldest lag ms:  p50 %.3f, p99 %.3f\n", Percentile(oldestLagMs, 0.5), Percentile(oldestLagMs, 0.99));
+    std::printf("order:          %s\n", orderOk ? "ok" : "OUT OF ORDER");
+    std::printf("counts:         %s\n", countsOk ? "ok" : "MISMATCH");
+    std::printf("bounded:        %s\n", boundedOk ? "ok" : "NO");
+    std::printf("lag:            %s\n", lagOk ? "ok" : "BEHIND");
+    return orderOk && countsOk && boundedOk && lagOk ? 0 : 1;
+}
+
+// The pre-mailbox pattern: one sample popped per frame from an unbounded queue
+int RunQueue(const Options& options) {
+    ThreadSafeQueue<GyroData> queue;
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> pushed{ 0 };
+    std::thread producer = StartProducer(options, stop, [&queue, &pushed](const GyroData& sample) {
+        queue.push(sample);
+        pushed.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<double> lagMs;
+    size_t maxBacklog = 0;
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    auto frame = Period(options.consumerHz);
+    auto next = start;
+    while (Clock::now() < end) {
+        maxBacklog = std::max(maxBacklog, queue.size());
+        if (auto sample = queue.tryPop()) {
+            lagMs.push_back(msd(Clock::now() - sample->timestamp).count());
+        }
+        Busy(options.workMs);
+        next += frame;
+        std::this_thread::sleep_until(next);
+    }
+    stop = true;
+    producer.join();
+
+    std::printf("producer:       %llu samples\n", static_cast<unsigned long long>(pushed.load()));
+    std::printf("consumer:       %zu samples consumed, %zu still queued, max backlog %zu\n",
+        lagMs.size(), queue.size(), maxBacklog);
+    std::printf("memory:         %zu bytes of samples queued at the end and growing\n", queue.size() * sizeof(GyroData));
+    std::printf("lag ms:         p50 %.3f, last %.3f\n", Percentile(lagMs, 0.5), lagMs.empty() ? 0.0 : lagMs.back());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: gyro_mailbox_stress [--seconds S] [--rate-hz R] [--consumer-hz F] [--work-ms W] [--queue]\n");
+        return 2;
+    }
+    std::printf("%.0f Hz producer, %.0f Hz consumer busy %.1f ms per frame, %.1f s, %s\n",
+        options.rateHz, options.consumerHz, options.workMs, options.seconds,
+        options.queue ? "unbounded queue" : "mailbox");
+    return options.queue ? RunQueue(options) : RunMailbox(options);
+}
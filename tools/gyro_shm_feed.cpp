@@ -0,0 +1,145 @@
+// Feeds the shared-memory gyro channel, for senders that can pipe into a program
+// but cannot map the file themselves, and for testing the reader without a phone.
+//
+//   gyro_shm_feed <gyro.dat> [--capacity N]                  (records on stdin)
+//   gyro_shm_feed <gyro.dat> --synthetic <Hz> [--seconds S] [--capacity N]
+//
+// Stdin carries the same protocol the VR program reads (JSON lines or binary
+// 'GYRO' frames, see gyro_parser.h); every record is written to the ring stamped
+// with this process's steady clock. --synthetic writes a slow head sweep at the
+// given rate instead, for --seconds (0 = until killed).
+//
+// Starting the feed resets the ring in place, so a running VR program sees a new
+// producer and re-synchronises rather than replaying the old samples.
+//
+// Compiled as a separate console program (tools/gyro_shm_feed.vcxproj, or
+// CMakeLists.txt on Linux) together with gyro_shm.cpp and gyro_parser.cpp.
+
+#include "../gyro_shm.h"
+#include "../gyro_parser.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string path;
+    uint32_t capacity = 256;
+    double syntheticHz = 0.0;
+    double seconds = 0.0;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--capacity" && hasValue) {
+            options.capacity = static_cast<uint32_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--synthetic" && hasValue) {
+            options.syntheticHz = std::atof(argv[++i]);
+        }
+        else if (arg == "--seconds" && hasValue) {
+            options.seconds = std::atof(argv[++i]);
+        }
+        else if (options.path.empty() && arg[0] != '-') {
+            options.path = arg;
+        }
+        else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return !options.path.empty() && options.capacity > 0 && options.syntheticHz >= 0.0 && options.seconds >= 0.0;
+}
+
+uint64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+long ReadStdin(char* buffer, size_t size) {
+#ifdef _WIN32
+    return _read(_fileno(stdin), buffer, static_cast<unsigned>(size));
+#else
+    return static_cast<long>(read(STDIN_FILENO, buffer, size));
+#endif
+}
+
+uint64_t RunStdin(GyroSharedWriter& writer) {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    GyroStreamParser parser;
+    uint64_t written = 0;
+    while (true) {
+        long bytes = ReadStdin(parser.WritePtr(), parser.WriteCapacity());
+        if (bytes <= 0) break;
+        parser.Commit(static_cast<size_t>(bytes));
+
+        GyroRecord record;
+        GyroStreamParser::Result result;
+        while ((result = parser.Next(record)) != GyroStreamParser::Result::NeedMore) {
+            if (result != GyroStreamParser::Result::Record) continue;
+            writer.Write(record.alpha, record.beta, record.gamma, NowUs());
+            written++;
+        }
+    }
+    if (parser.GetErrorCount() > 0) {
+        std::fprintf(stderr, "%llu malformed records skipped\n", static_cast<unsigned long long>(parser.GetErrorCount()));
+    }
+    return written;
+}
+
+// Yaw sweeps +-60 degrees every 4 s with a little pitch, roughly a person looking around
+uint64_t RunSynthetic(GyroSharedWriter& writer, const Options& options) {
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.syntheticHz));
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    auto next = start;
+    uint64_t written = 0;
+    while (options.seconds == 0.0 || Clock::now() < end) {
+        double t = std::chrono::duration<double>(Clock::now() - start).count();
+        float alpha = static_cast<float>(60.0 * std::sin(t * 3.14159265 / 2.0));
+        float beta = static_cast<float>(90.0 + 10.0 * std::sin(t * 3.14159265 / 3.0));
+        writer.Write(alpha, beta, 0.0f, NowUs());
+        written++;
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+    return written;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: gyro_shm_feed <gyro.dat> [--synthetic <Hz>] [--seconds S] [--capacity N]\n");
+        return 2;
+    }
+
+    GyroSharedWriter writer;
+    if (!writer.Create(options.path, options.capacity)) {
+        std::fprintf(stderr, "cannot create %s\n", options.path.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "writing %s, %u slots, from %s\n", options.path.c_str(), options.capacity,
+        options.syntheticHz > 0.0 ? "a synthetic sweep" : "stdin");
+
+    uint64_t written = options.syntheticHz > 0.0 ? RunSynthetic(writer, options) : RunStdin(writer);
+    std::fprintf(stderr, "%llu samples written\n", static_cast<unsigned long long>(written));
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Measures the input injection queue against the in-memory mock backend, so no
+// desktop or input permissions are needed.
+//
+//   input_injection_bench [--events N] [--rate-hz R] [--click-every N] [--call-cost-us C] [--no-coalesce]
+//
+// A producer thread pushes pointer moves at --rate-hz (0 = as fast as possible),
+// with a click every --click-every moves, the way the render loop drives the
+// panel pointer. --call-cost-us makes every backend call spin for that long, standing
+// in for one SendInput/write syscall. Prints backend calls, coalescing, throughput and
+// push-to-inject latency, and checks that every button event arrived in order and
+// whether the pointer ended where it was last sent.
+//
+// Compiled as a separate console program (tools/input_injection_bench.vcxproj)
+// together with input_injector.cpp, windows_input.cpp (on Windows) or
+// linux_input.cpp (on Linux), thread_topology.cpp and async_logger.cpp.
+
+#include "../input_injector.h"
+#include "../async_logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int events = 100000;
+    double rateHz = 0.0;
+    int clickEvery = 100;
+    int callCostUs = 20;
+    bool coalesce = true;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--events" && hasValue) {
+            options.events = std::atoi(argv[++i]);
+        }
+        else if (arg == "--rate-hz" && hasValue) {
+            options.rateHz = std::atof(argv[++i]);
+        }
+        else if (arg == "--click-every" && hasValue) {
+            options.clickEvery = std::atoi(argv[++i]);
+        }
+        else if (arg == "--call-cost-us" && hasValue) {
+            options.callCostUs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-coalesce") {
+            options.coalesce = false;
+        }
+        else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return options.events > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: input_injection_bench [--events N] [--rate-hz R] [--click-every N] [--call-cost-us C] [--no-coalesce]\n");
+        return 2;
+    }
+    AsyncLogger::instance().start();
+
+    auto ownedBackend = std::make_unique<MockInputBackend>();
+    MockInputBackend* backend = ownedBackend.get();
+    backend->SetCallCost(std::chrono::microseconds(options.callCostUs));
+
+    InputInjector injector;
+    injector.SetCoalescing(options.coalesce);
+    injector.Start(std::move(ownedBackend));
+
+    // The producer pattern: a pointer sweeping across the screen, clicking now and then
+    std::vector<InputEvent::Type> expectedButtons;
+    int lastX = 0;
+    int lastY = 0;
+    auto interval = options.rateHz > 0.0
+        ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / options.rateHz))
+        : std::chrono::steady_clock::duration::zero();
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    for (int i = 0; i < options.events; i++) {
+        lastX = i % 1920;
+        lastY = (i / 1920) % 1080;
+        injector.MoveTo(lastX, lastY);
+        if (options.clickEvery > 0 && i % options.clickEvery == options.clickEvery - 1) {
+            injector.Click(InputButton::Left, lastX, lastY);
+            expectedButtons.push_back(InputEvent::Type::ButtonDown);
+            expectedButtons.push_back(InputEvent::Type::ButtonUp);
+        }
+        if (interval.count() > 0) {
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+    }
+    auto pushed = std::chrono::steady_clock::now();
+    injector.Flush();
+    auto drained = std::chrono::steady_clock::now();
+    auto stats = injector.TakeStats();
+
+    // Button events are never dropped; moves may be when the queue overflows without coalescing
+    std::vector<InputEvent::Type> seenButtons;
+    const auto& records = backend->GetRecords();
+    for (const auto& record : records) {
+        if (record.event.type != InputEvent::Type::Move) {
+            seenButtons.push_back(record.event.type);
+        }
+    }
+    bool orderOk = seenButtons == expectedButtons;
+    bool positionOk = !records.empty() && records.back().event.x == lastX && records.back().event.y == lastY;
+
+    using msd = std::chrono::duration<double, std::milli>;
+    double pushMs = msd(pushed - start).count();
+    double totalMs = msd(drained - start).count();
+    std::printf("backend calls:  %llu (%.2f events per call, max batch %zu)\n",
+        static_cast<unsigned long long>(backend->GetCalls()),
+        stats.batches > 0 ? static_cast<double>(stats.injected) / stats.batches : 0.0, stats.maxBatch);
+    std::printf("events:         queued %llu, coalesced %llu, dropped %llu, injected %llu\n",
+        static_cast<unsigned long long>(stats.queued), static_cast<unsigned long long>(stats.coalesced),
+        static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.injected));
+    std::printf("throughput:     %.0f events/s pushed, %.3f ms total (%.3f ms pushing)\n",
+        stats.queued / (totalMs / 1000.0), totalMs, pushMs);
+    std::printf("latency:        avg %.3f ms, max %.3f ms\n",
+        stats.injected > 0 ? stats.latencyMs / stats.injected : 0.0, stats.maxLatencyMs);
+    std::printf("buttons:        %s\n", orderOk ? "ok" : "MISMATCH");
+    std::printf("final position: %s\n", positionOk ? "ok" : "lost (moves dropped)");
+
+    // Stopping destroys the backend, so only after its records were read
+    injector.Stop();
+
+    AsyncLogger::instance().stop();
+    return orderOk ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// Headless replay of a session recorded with `--record <file>`.
+//
+//   session_replay <session> [--realtime] [--speed X] [--templates file] [--events] [--repeat N] [--json file]
+//
+// By default records are processed as fast as possible and throughput is
+// reported; --realtime keeps the recorded pacing (scaled by --speed). --events
+// prints one line per hands payload, which is stable across runs and can be
+// diffed against a known-good replay. --json writes throughput and per-stage
+// timings (hand JSON parsing, Player hand update, batched gesture recognition
+// and both pointers) averaged over the repeats, for tracking regressions between builds.
+//
+// Compiled as a separate console program (tools/session_replay.vcxproj) together
+// with session_recording.cpp, session_replay.cpp, hand_tracking_data.cpp, player.cpp,
+// head_pose_predictor.cpp, stereo_scene.cpp, gesture_recognition.cpp, gesture_templates.cpp,
+// motion_history.cpp, vr_mouse.cpp, thread_topology.cpp and async_logger.cpp; only
+// raymath is needed from raylib.
+
+#include "../session_replay.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+void PrintUsage() {
+    fprintf(stderr, "usage: session_replay <session> [--realtime] [--speed X] [--templates file] [--events] [--repeat N] [--json file]\n");
+}
+
+double MicrosPer(double seconds, uint64_t count) {
+    return count > 0 ? seconds * 1e6 / count : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 2;
+    }
+
+    SessionReplay replay;
+    bool printEvents = false;
+    int repeat = 1;
+    std::string jsonPath;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--realtime") {
+            replay.SetPacing(SessionReplay::Pacing::Original);
+        }
+        else if (arg == "--speed" && i + 1 < argc) {
+            replay.SetSpeed(static_cast<float>(atof(argv[++i])));
+        }
+        else if (arg == "--templates" && i + 1 < argc) {
+            if (!replay.LoadGestureTemplates(argv[++i])) {
+                fprintf(stderr, "cannot load templates %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (arg == "--events") {
+            printEvents = true;
+        }
+        else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat < 1) repeat = 1;
+        }
+        else {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (!replay.Open(argv[1])) {
+        fprintf(stderr, "cannot open session %s\n", argv[1]);
+        return 1;
+    }
+
+    if (printEvents) {
+        replay.SetHandsCallback([](const ReplayHandsEvent& event) {
+            printf("%.6f left=%s right=%s mouse=%d uv=%.4f,%.4f click=%d drag=%d scroll=%d %.4f\n", event.time,
+                GestureTypeName(event.leftGesture.type), GestureTypeName(event.rightGesture.type),
+                event.mouseActive ? 1 : 0, event.mouseUV.x, event.mouseUV.y,
+                event.mouseClicking ? 1 : 0, event.mouseDragging ? 1 : 0,
+                event.scrolling ? 1 : 0, event.scrollDelta);
+        });
+    }
+
+    const SessionFileHeader& header = replay.GetHeader();
+    fprintf(stderr, "session: %u records, %.2f s, %s\n", header.recordCount, header.durationUs / 1e6,
+        header.indexOffset != 0 ? "indexed" : "unindexed (recorder did not close)");
+
+    ReplayStats stats;
+    double wallTotal = 0.0;
+    double parseTotal = 0.0, playerTotal = 0.0, handsControllerTotal = 0.0;
+    for (int run = 0; run < repeat; run++) {
+        stats = replay.Run();
+        wallTotal += stats.wallSeconds;
+        parseTotal += stats.parseSeconds;
+        playerTotal += stats.playerSeconds;
+        handsControllerTotal += stats.handsSeconds;
+    }
+
+    uint64_t records = stats.handRecords + stats.gyroRecords + stats.frameRecords;
+    fprintf(stderr, "hands=%llu gyro=%llu frames=%llu (%llu bytes) parse_errors=%llu\n",
+        static_cast<unsigned long long>(stats.handRecords), static_cast<unsigned long long>(stats.gyroRecords),
+        static_cast<unsigned long long>(stats.frameRecords), static_cast<unsigned long long>(stats.frameBytes),
+        static_cast<unsigned long long>(stats.parseErrors));
+    for (size_t i = 0; i < sizeof(stats.gestureCounts) / sizeof(stats.gestureCounts[0]); i++) {
+        if (stats.gestureCounts[i] == 0) continue;
+        fprintf(stderr, "  %-12s %llu\n", GestureTypeName(static_cast<GestureType>(i)),
+            static_cast<unsigned long long>(stats.gestureCounts[i]));
+    }
+
+    double wallPerRun = wallTotal / repeat;
+    if (wallPerRun > 0.0) {
+        fprintf(stderr, "replayed %.2f s of input in %.4f s (%.1fx), %.0f records/s, %.0f hand payloads/s\n",
+            stats.sessionSeconds, wallPerRun, stats.sessionSeconds / wallPerRun,
+            records / wallPerRun, stats.handRecords / wallPerRun);
+    }
+
+    uint64_t handsTotal = stats.handRecords * static_cast<uint64_t>(repeat);
+    fprintf(stderr, "per hand payload (us): parse=%.2f player=%.2f hands_controller=%.2f\n",
+        MicrosPer(parseTotal, handsTotal), MicrosPer(playerTotal, handsTotal),
+        MicrosPer(handsControllerTotal, handsTotal));
+
+    if (!jsonPath.empty()) {
+        nlohmann::json result;
+        result["session"] = argv[1];
+        result["repeat"] = repeat;
+        result["session_seconds"] = stats.sessionSeconds;
+        result["wall_seconds_per_run"] = wallPerRun;
+        result["records_per_second"] = wallPerRun > 0.0 ? records / wallPerRun : 0.0;
+        result["hand_payloads_per_second"] = wallPerRun > 0.0 ? stats.handRecords / wallPerRun : 0.0;
+        result["stages_us_per_hand_payload"] = {
+            { "parse_hand_json", MicrosPer(parseTotal, handsTotal) },
+            { "player_update_hands", MicrosPer(playerTotal, handsTotal) },
+            { "hands_controller_update", MicrosPer(handsControllerTotal, handsTotal) }
+        };
+        result["counts"] = {
+            { "hands", stats.handRecords },
+            { "gyro", stats.gyroRecords },
+            { "frames", stats.frameRecords },
+            { "parse_errors", stats.parseErrors }
+        };
+
+        std::ofstream out(jsonPath);
+        out << result.dump(2) << "\n";
+        if (!out.good()) {
+            fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Google Benchmark suite for the hot paths of the streaming pipeline.
+//
+//   vr_bench [--benchmark_filter=REGEX] [--benchmark_out=FILE --benchmark_out_format=json]
+//
+// The CMake target vr_bench_json runs the whole suite and writes vr_bench.json
+// in the build directory, for comparing one release against the next.
+//
+// This file holds the paths with no raylib or ffmpeg dependency: the capture
+// queue, the BGRA swizzle and the stdout frame writer. vr_bench_hands.cpp (hand
+// parsing, Player, gesture recognition, pointer) and vr_bench_encoder.cpp (H.264
+// encoding) are linked in when CMake finds raylib and ffmpeg respectively, and
+// vr_bench_gyro.cpp (gyro stdin parsing, new and old) when it finds nlohmann/json.
+//
+// Built by CMakeLists.txt (Linux) together with thread_topology.cpp,
+// async_logger.cpp, pixel_convert.cpp and frame_output.cpp.
+
+#include "../screen_capture.h"
+#include "../pixel_convert.h"
+#include "../frame_output.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// -------- ThreadSafeQueue --------
+
+ThreadSafeQueue<CapturedFrame> sharedQueue;
+
+// Every thread takes a frame and puts it back, so all of them fight over the one
+// mutex the way the capture thread and the render loop do
+void BM_ThreadSafeQueue_Contended(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        for (int i = 0; i < 64; i++) {
+            CapturedFrame frame;
+            frame.pixels.resize(64);
+            sharedQueue.push(std::move(frame));
+        }
+    }
+    for (auto _ : state) {
+        auto frame = sharedQueue.tryPop();
+        if (frame) sharedQueue.push(std::move(*frame));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        while (sharedQueue.tryPop()) {
+        }
+    }
+}
+BENCHMARK(BM_ThreadSafeQueue_Contended)->ThreadRange(1, 8)->UseRealTime();
+
+// One producer thread pushing frames, the benchmark thread blocking in waitAndPop
+void BM_ThreadSafeQueue_ProducerConsumer(benchmark::State& state) {
+    ThreadSafeQueue<CapturedFrame> queue;
+    ThreadSafeQueue<CapturedFrame> recycled;
+    const int64_t batch = state.range(0);
+    for (int i = 0; i < 256; i++) {
+        CapturedFrame frame;
+        frame.pixels.resize(64);
+        recycled.push(std::move(frame));
+    }
+
+    for (auto _ : state) {
+        std::thread producer([&] {
+            for (int64_t i = 0; i < batch; i++) {
+                queue.push(recycled.waitAndPop());
+            }
+        });
+        for (int64_t i = 0; i < batch; i++) {
+            recycled.push(queue.waitAndPop());
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_ThreadSafeQueue_ProducerConsumer)->Arg(1024)->UseRealTime();
+
+// -------- BGRA swizzle --------
+
+void BM_SwizzleBgraToRgba(benchmark::State& state) {
+    const size_t pixelCount = static_cast<size_t>(state.range(0)) * state.range(1);
+    std::vector<uint8_t> pixels(pixelCount * 4);
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] = static_cast<uint8_t>(i * 31);
+
+    for (auto _ : state) {
+        SwizzleBgraToRgba(pixels.data(), pixelCount);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pixels.size()));
+}
+BENCHMARK(BM_SwizzleBgraToRgba)->Args({ 960, 540 })->Args({ 1920, 1080 })->Args({ 3840, 2160 });
+
+// The per-byte std::swap loop captureDesktopInternal used before the helper, as a baseline
+void BM_SwizzleBgraToRgba_ByteSwap(benchmark::State& state) {
+    const size_t pixelCount = static_cast<size_t>(state.range(0)) * state.range(1);
+    std::vector<uint8_t> pixels(pixelCount * 4);
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] = static_cast<uint8_t>(i * 31);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            std::swap(pixels[i], pixels[i + 2]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pixels.size()));
+}
+BENCHMARK(BM_SwizzleBgraToRgba_ByteSwap)->Args({ 1920, 1080 });
+
+// -------- SendH264Frame --------
+
+// Writes frames of range(0) bytes into a pipe that a second thread drains, as
+// the consumer of vr_main's stdout would
+void BM_SendH264Frame(benchmark::State& state) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        state.SkipWithError("pipe failed");
+        return;
+    }
+    std::thread drain([fd = fds[0]] {
+        char buffer[1 << 16];
+        while (read(fd, buffer, sizeof(buffer)) > 0) {
+        }
+    });
+
+    {
+        std::ofstream out("/dev/fd/" + std::to_string(fds[1]), std::ios::binary);
+        std::vector<uint8_t> frame(static_cast<size_t>(state.range(0)), 0x5A);
+        for (auto _ : state) {
+            if (!SendH264Frame(out, frame, 1920, 1080)) {
+                state.SkipWithError("write failed");
+                break;
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    close(fds[1]);
+    drain.join();
+    close(fds[0]);
+}
+BENCHMARK(BM_SendH264Frame)->Arg(4 << 10)->Arg(32 << 10)->Arg(256 << 10)->UseRealTime();
+
+} // namespace
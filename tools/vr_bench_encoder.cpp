@@ -0,0 +1,56 @@
+// H264Encoder::encodeFrame benchmarks for vr_bench, at the encoder sizes the
+// resolution governor steps through. The input is a full-size RGBA frame with a
+// moving region, so x264 codes a realistic mix of changed and static macroblocks
+// and every GOP's IDR frame is included in the average.
+//
+// Linked into vr_bench when CMake finds libavcodec, libavutil and libswscale,
+// together with h264_encoder.cpp.
+
+#include "../h264_encoder.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+void BM_H264Encoder_EncodeFrame(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < rgba.size(); i++) rgba[i] = static_cast<uint8_t>((i / 4) % width);
+
+    try {
+        H264Encoder encoder(width, height, 60, EncoderSettings());
+        int frameIndex = 0;
+        int64_t bytes = 0;
+        for (auto _ : state) {
+            // A block the size of a dragged window moves a few pixels per frame
+            state.PauseTiming();
+            int blockX = (frameIndex * 8) % (width / 2);
+            for (int y = height / 4; y < height / 2; y++) {
+                uint8_t* row = rgba.data() + (static_cast<size_t>(y) * width + blockX) * 4;
+                for (int x = 0; x < width / 4 * 4; x++) row[x] = static_cast<uint8_t>(frameIndex + x);
+            }
+            frameIndex++;
+            state.ResumeTiming();
+
+            auto packet = encoder.encodeFrame(rgba.data(), width, height);
+            bytes += static_cast<int64_t>(packet.size());
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.counters["bytes_per_frame"] = benchmark::Counter(
+            static_cast<double>(bytes) / std::max<int64_t>(1, state.iterations()));
+    }
+    catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+    }
+}
+BENCHMARK(BM_H264Encoder_EncodeFrame)
+    ->Args({ 960, 540 })
+    ->Args({ 1280, 720 })
+    ->Args({ 1920, 1080 })
+    ->Args({ 2560, 1440 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
@@ -0,0 +1,104 @@
+// Gyro stdin parsing benchmarks for vr_bench: GyroStreamParser against the
+// std::getline + nlohmann::json path it replaced, over the same input.
+//
+// The new parser gets kRecords records as either JSON lines or binary 'GYRO'
+// frames, fed in 4 KiB chunks the way the reactor reads stdin. The old one reads
+// the JSON lines from a std::istringstream; it cannot decode binary frames, so it
+// has no binary case. Items per second are samples per second.
+//
+// Linked into vr_bench when CMake finds nlohmann/json, together with gyro_parser.cpp.
+
+#include "../gyro_parser.h"
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr int kRecords = 10000;
+
+enum InputFormat { Json = 0, Binary = 1 };
+
+const std::string& Input(int format) {
+    static const std::array<std::string, 2> inputs = [] {
+        std::string json;
+        std::string binary;
+        for (int i = 0; i < kRecords; i++) {
+            float alpha = static_cast<float>(i % 360) + 0.125f;
+            float beta = -45.0f + static_cast<float>(i % 90);
+            float gamma = 12.75f - static_cast<float>(i % 25);
+            char line[96];
+            std::snprintf(line, sizeof(line), "{\"alpha\":%.3f,\"beta\":%.3f,\"gamma\":%.3f}\n", alpha, beta, gamma);
+            json += line;
+
+            char frame[GyroStreamParser::kBinaryRecordSize];
+            uint32_t magic = GyroStreamParser::kBinaryMagic;
+            std::memcpy(frame, &magic, sizeof(magic));
+            std::memcpy(frame + 4, &alpha, sizeof(float));
+            std::memcpy(frame + 8, &beta, sizeof(float));
+            std::memcpy(frame + 12, &gamma, sizeof(float));
+            binary.append(frame, sizeof(frame));
+        }
+        return std::array<std::string, 2>{ json, binary };
+    }();
+    return inputs[format];
+}
+
+void BM_GyroStreamParser(benchmark::State& state) {
+    const std::string& input = Input(static_cast<int>(state.range(0)));
+    int64_t decoded = 0;
+    for (auto _ : state) {
+        GyroStreamParser parser;
+        GyroRecord record;
+        size_t offset = 0;
+        while (offset < input.size()) {
+            size_t chunk = std::min(parser.WriteCapacity(), input.size() - offset);
+            std::memcpy(parser.WritePtr(), input.data() + offset, chunk);
+            parser.Commit(chunk);
+            offset += chunk;
+            GyroStreamParser::Result result;
+            while ((result = parser.Next(record)) != GyroStreamParser::Result::NeedMore) {
+                if (result == GyroStreamParser::Result::Record) {
+                    benchmark::DoNotOptimize(record);
+                    decoded++;
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+    state.counters["decoded"] = benchmark::Counter(static_cast<double>(decoded) / std::max<int64_t>(1, state.iterations()));
+}
+BENCHMARK(BM_GyroStreamParser)->ArgName("binary")->Arg(Json)->Arg(Binary);
+
+// The replaced ReadGyroData loop, without its per-sample log write
+void BM_GyroGetlineNlohmann(benchmark::State& state) {
+    const std::string& input = Input(static_cast<int>(state.range(0)));
+    int64_t decoded = 0;
+    for (auto _ : state) {
+        std::istringstream in(input);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            try {
+                auto j = nlohmann::json::parse(line);
+                GyroRecord record = { j.value("alpha", 0.0f), j.value("beta", 0.0f), j.value("gamma", 0.0f) };
+                benchmark::DoNotOptimize(record);
+                decoded++;
+            }
+            catch (const nlohmann::json::exception&) {
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+    state.counters["decoded"] = benchmark::Counter(static_cast<double>(decoded) / std::max<int64_t>(1, state.iterations()));
+}
+BENCHMARK(BM_GyroGetlineNlohmann)->ArgName("binary")->Arg(Json);
+
+} // namespace
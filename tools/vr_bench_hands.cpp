@@ -0,0 +1,125 @@
+// Hand path benchmarks for vr_bench: hands.dat parsing, Player::UpdateVRHand,
+// GestureRecognizer::RecognizeGesture and VRMouseController::Update.
+//
+// Linked into vr_bench when CMake finds raylib, together with hand_tracking_data.cpp,
+// player.cpp, head_pose_predictor.cpp, stereo_scene.cpp, gesture_recognition.cpp,
+// gesture_templates.cpp, motion_history.cpp and vr_mouse.cpp.
+
+#include "../hand_tracking_data.h"
+#include "../vr_mouse.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr int kPoseFrames = 64;
+
+// One hand in the tracker's hands.dat form, fingers curling with phase 0..1
+std::string HandJson(const char* handedness, float baseX, float phase) {
+    std::string json = std::string("{\"handedness\":\"") + handedness +
+        "\",\"confidence\":0.93,\"depth_scale\":1.0,\"distance_factor\":1.0,\"shoulder_calibrated\":true,\"landmarks\":[";
+    for (int i = 0; i < 21; i++) {
+        int finger = i == 0 ? 0 : (i - 1) / 4;
+        int joint = i == 0 ? 0 : (i - 1) % 4 + 1;
+        float curl = phase * joint * 0.03f;
+        float x = baseX + (finger - 2) * 0.04f;
+        float y = 0.7f - joint * 0.06f + curl;
+        float z = -0.02f * joint - curl;
+        char point[96];
+        std::snprintf(point, sizeof(point), "%s{\"x\":%.6f,\"y\":%.6f,\"z\":%.6f}", i ? "," : "", x, y, z);
+        json += point;
+    }
+    return json + "]}";
+}
+
+// Payloads of both hands opening and closing, as the tracker writes them
+const std::vector<std::string>& Payloads() {
+    static std::vector<std::string> payloads = [] {
+        std::vector<std::string> result;
+        for (int i = 0; i < kPoseFrames; i++) {
+            float phase = 0.5f + 0.5f * std::sin(i * 0.2f);
+            result.push_back("[" + HandJson("Left", 0.3f, phase) + "," + HandJson("Right", 0.7f, 1.0f - phase) + "]");
+        }
+        return result;
+    }();
+    return payloads;
+}
+
+// World-space right hands for every payload, as the gesture code receives them
+const std::vector<HandLandmarks>& RightHands() {
+    static std::vector<HandLandmarks> hands = [] {
+        std::vector<HandLandmarks> result;
+        Player player;
+        player.Update();
+        for (const auto& payload : Payloads()) {
+            auto parsed = ParseHandTrackingJson(payload.data(), payload.size());
+            player.UpdateVRHand(player.rightHand, parsed[1]);
+            HandLandmarks landmarks;
+            ToHandLandmarks(player.rightHand, landmarks);
+            result.push_back(landmarks);
+        }
+        return result;
+    }();
+    return hands;
+}
+
+void BM_ParseHandTrackingJson(benchmark::State& state) {
+    const auto& payloads = Payloads();
+    size_t index = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const std::string& payload = payloads[index++ % payloads.size()];
+        auto hands = ParseHandTrackingJson(payload.data(), payload.size());
+        benchmark::DoNotOptimize(hands.data());
+        bytes += static_cast<int64_t>(payload.size());
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_ParseHandTrackingJson);
+
+void BM_PlayerUpdateVRHand(benchmark::State& state) {
+    std::vector<HandTrackingData> hands;
+    for (const auto& payload : Payloads()) {
+        auto parsed = ParseHandTrackingJson(payload.data(), payload.size());
+        hands.push_back(parsed[1]);
+    }
+    Player player;
+    player.Update();
+    size_t index = 0;
+    for (auto _ : state) {
+        player.UpdateVRHand(player.rightHand, hands[index++ % hands.size()]);
+        benchmark::DoNotOptimize(player.rightHand.landmarks.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PlayerUpdateVRHand);
+
+void BM_GestureRecognizer_RecognizeGesture(benchmark::State& state) {
+    const auto& hands = RightHands();
+    GestureRecognizer recognizer;
+    size_t index = 0;
+    for (auto _ : state) {
+        GestureData gesture = recognizer.RecognizeGesture(hands[index++ % hands.size()]);
+        benchmark::DoNotOptimize(gesture);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GestureRecognizer_RecognizeGesture);
+
+void BM_VRMouseController_Update(benchmark::State& state) {
+    const auto& hands = RightHands();
+    VRMouseController mouse;
+    mouse.SetPanelInfo({ 0.0f, 1.8f, 4.0f }, { 17.60f, 5.0f, 0.1f });
+    size_t index = 0;
+    double time = 0.0;
+    for (auto _ : state) {
+        time += 1.0 / 60.0;
+        mouse.Update(hands[index++ % hands.size()], 1.0f / 60.0f, time);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VRMouseController_Update);
+
+} // namespace
@@ -1,8 +1,27 @@
 #pragma once
 #include "raylib.h"
 #include "screen_capture.h"
-#include "windows_input.h" // Include our wrapper instead
+#include "input_injector.h"
+#include "texture_streamer.h"
 #include <chrono>
+#include <memory>
+
+class StereoSceneBatch;
+struct StereoEye;
+
+// Render-thread time spent getting desktop frames into the panel texture
+struct DesktopUploadStats {
+    uint64_t frames = 0;        // captured frames taken from the queue
+    uint64_t uploads = 0;       // texture updates that reached the GPU
+    uint64_t unchanged = 0;     // streaming only: frames identical to the previous one
+    uint64_t dropped = 0;       // frames the streaming ring had no room for
+    uint64_t uploadedBytes = 0; // texels sent, all mip levels included
+    double stallMs = 0.0;       // total render-thread stall
+    double maxStallMs = 0.0;    // worst single frame
+    double workerMs = 0.0;      // streaming only: time the helper thread spent filling buffers
+    bool streaming = false;
+    int downscale = 1;          // capture resolution divisor in effect
+};
 
 class VRDesktopRenderer {
 private:
@@ -11,6 +30,28 @@ private:
     std::chrono::steady_clock::time_point lastUpdate;
     float maxUpdateRate;
 
+    std::unique_ptr<TextureStreamer> streamer;
+    // After a desktop resolution change: the ring whose texture stays on the panel
+    // until the new one has content
+    std::unique_ptr<TextureStreamer> retiringStreamer;
+    bool streamingUploads;
+    DesktopUploadStats uploadStats;
+
+    // Desktop resolution and the capture divisor chosen from the panel's on-screen size
+    int nativeWidth;
+    int nativeHeight;
+    int panelDownscale;
+    Vector2 panelFootprint;
+
+    uint64_t contentRevision;
+
+    // Pointer events go out on the injector's thread, batched and coalesced
+    InputInjector inputInjector;
+
+    void uploadSynchronous(const CapturedFrame& frame);
+    bool uploadStreaming(CapturedFrame&& frame);
+    void addStall(std::chrono::steady_clock::time_point start);
+
 public:
     VRDesktopRenderer();
     ~VRDesktopRenderer();
@@ -19,15 +60,29 @@ public:
     void cleanup();
     void update();
     void renderDesktopPanel(Vector3 panelPosition, Vector3 panelSize);
+    void appendDesktopPanel(StereoSceneBatch& batch, Vector3 panelPosition, Vector3 panelSize) const;
     void setMaxUpdateRate(float fps);
+    float getMaxUpdateRate() const { return 1.0f / maxUpdateRate; }
+    // Projects the panel into both eyes and lowers the capture resolution when it covers fewer pixels
+    void updatePanelFootprint(const StereoEye eyes[2], int targetWidth, int targetHeight,
+        Vector3 panelPosition, Vector3 panelSize);
+    int getPanelDownscale() const { return panelDownscale; }
+    Vector2 getPanelFootprint() const { return panelFootprint; }
+    // Streams frames through a pixel buffer ring (default) instead of a blocking UpdateTexture
+    void setStreamingUploads(bool enabled) { streamingUploads = enabled; }
+    DesktopUploadStats takeUploadStats();
     bool isTextureReady() const;
+    unsigned int getTextureId() const { return textureInitialized ? desktopTexture.id : 0; }
+    // Bumped whenever the panel texture gets new contents
+    uint64_t getContentRevision() const { return contentRevision; }
     size_t getQueueSize() const;
 
-    // VR Mouse interaction methods
+    // VR Mouse interaction methods; they queue the event and return immediately
     void sendLeftClick(int x, int y);
     void sendRightClick(int x, int y);
     void sendMouseMove(int x, int y);
     void sendMousePosition(int x, int y);
     void sendMouseDown(int x, int y);
     void sendMouseUp(int x, int y);
+    InputInjector::Stats takeInputStats() { return inputInjector.TakeStats(); }
 };
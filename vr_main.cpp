@@ -15,19 +15,35 @@
 #include <fcntl.h>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <memory>
 #include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
 #include "gyro_thread.h"
-extern "C" {
-#include <libavcodec/avcodec.h>
-#include <libavutil/imgutils.h>
-#include <libavutil/opt.h>
-#include <libswscale/swscale.h>
-}
+#include "head_pose_predictor.h"
+#include "gyro_shm.h"
+#include "async_logger.h"
+#include "session_recording.h"
+#include "hand_tracking_data.h"
+#include "stereo_renderer.h"
+#include "hand_renderer.h"
+#include "frame_change_tracker.h"
+#include "pose_reprojector.h"
+#include "resolution_governor.h"
+#include "thread_topology.h"
+#include "control_channel.h"
+#include "metrics_registry.h"
+#include "frame_header.h"
+#include "stream_server.h"
+#include "h264_encoder.h"
+#include "frame_output.h"
 
 namespace fs = std::filesystem;
-ThreadSafeQueue<GyroData> gyroQueue;
+GyroMailbox gyroMailbox;
 GyroData latestGyro = { 0.0f, 0.0f, 0.0f };
+HeadPosePredictor headPredictor;
 
 // Define missing functions
 template<typename T>
@@ -38,152 +54,25 @@ T Clamp(T value, T minVal, T maxVal) {
 static boost::interprocess::mapped_region* handRegion = nullptr;
 static std::unique_ptr<boost::interprocess::file_mapping> handFile;
 
-// Updated header structure to match Python expectations
-struct FrameHeader {
-    uint32_t magic = 0xDEADBEEF;
-    uint32_t timestamp_ms;
-    uint32_t frame_size;
-    uint32_t width;
-    uint32_t height;
-    uint32_t pixel_format;  // 0=RGBA, 1=RGB, 2=H264
-}; 
-
-std::vector<HandTrackingData> ReadHandTrackingData(const std::string& filename);
+std::vector<HandTrackingData> ReadHandTrackingData(const std::string& filename, std::string* rawJson = nullptr);
 bool isStdoutPiped();
-uint32_t GetCurrentTimeMs();
-bool SendH264Frame(const std::vector<uint8_t>& frameData, int width, int height);
-
-// -------- H264 Encoder Class --------
-class H264Encoder {
-public:
-    H264Encoder(int width, int height, int fps)
-        : width(width), height(height), fps(fps) {
-
-        codec = avcodec_find_encoder(AV_CODEC_ID_H264);
-        if (!codec) {
-            throw std::runtime_error("H.264 codec not found");
-        }
-
-        ctx = avcodec_alloc_context3(codec);
-        if (!ctx) {
-            throw std::runtime_error("Failed to allocate codec context");
-        }
-
-        ctx->bit_rate = 2000000;
-        ctx->width = width;
-        ctx->height = height;
-        ctx->time_base = AVRational{ 1, fps };
-        ctx->framerate = AVRational{ fps, 1 };
-        ctx->pix_fmt = AV_PIX_FMT_YUV420P;
-        ctx->gop_size = 10;
-        ctx->max_b_frames = 0;
-
-        // Ultra-fast preset for real-time streaming
-        // Add these for better rate control:
-        av_opt_set(ctx->priv_data, "crf", "23", 0);  // Constant rate factor
-        av_opt_set(ctx->priv_data, "rc-lookahead", "0", 0);  // No lookahead for real-time
-        av_opt_set(ctx->priv_data, "preset", "ultrafast", 0);
-        av_opt_set(ctx->priv_data, "tune", "zerolatency", 0);
-        av_opt_set(ctx->priv_data, "profile", "baseline", 0);
-
-        if (avcodec_open2(ctx, codec, nullptr) < 0) {
-            avcodec_free_context(&ctx);
-            throw std::runtime_error("Failed to open codec");
-        }
-
-        frame = av_frame_alloc();
-        if (!frame) {
-            avcodec_free_context(&ctx);
-            throw std::runtime_error("Failed to allocate frame");
-        }
-
-        frame->format = ctx->pix_fmt;
-        frame->width = width;
-        frame->height = height;
-
-        if (av_frame_get_buffer(frame, 32) < 0) {
-            av_frame_free(&frame);
-            avcodec_free_context(&ctx);
-            throw std::runtime_error("Failed to allocate frame buffer");
-        }
-
-        packet = av_packet_alloc();
-        if (!packet) {
-            av_frame_free(&frame);
-            avcodec_free_context(&ctx);
-            throw std::runtime_error("Failed to allocate packet");
-        }
-
-        swsCtx = sws_getContext(
-            width, height, AV_PIX_FMT_RGBA,
-            width, height, AV_PIX_FMT_YUV420P,
-            SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+Image ReadFrameRegion(const RenderTexture2D& source, int width, int height);
 
-        if (!swsCtx) {
-            av_packet_free(&packet);
-            av_frame_free(&frame);
-            avcodec_free_context(&ctx);
-            throw std::runtime_error("Failed to create SWS context");
-        }
-    }
-
-    ~H264Encoder() {
-        if (ctx) avcodec_free_context(&ctx);
-        if (frame) av_frame_free(&frame);
-        if (packet) av_packet_free(&packet);
-        if (swsCtx) sws_freeContext(swsCtx);
-    }
-
-    std::vector<uint8_t> encodeFrame(const uint8_t* rgba) {
-        const uint8_t* inData[1] = { rgba };
-        int inStride[1] = { 4 * width };
-
-        sws_scale(
-            swsCtx,
-            inData, inStride,
-            0, height,
-            frame->data, frame->linesize);
-
-        frame->pts = frameIndex++;
-
-        int ret = avcodec_send_frame(ctx, frame);
-        if (ret < 0) {
-            throw std::runtime_error("Error sending frame for encoding");
-        }
-
-        std::vector<uint8_t> outData;
-
-        while ((ret = avcodec_receive_packet(ctx, packet)) == 0) {
-            outData.insert(outData.end(), packet->data, packet->data + packet->size);
-            av_packet_unref(packet);
-        }
-
-        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
-            throw std::runtime_error("Error receiving packet from encoder");
-        }
-
-        return outData;
-    }
-
-private:
-    int width, height, fps;
-    const AVCodec* codec = nullptr;
-    AVCodecContext* ctx = nullptr;
-    AVFrame* frame = nullptr;
-    AVPacket* packet = nullptr;
-    SwsContext* swsCtx = nullptr;
-    int64_t frameIndex = 0;
-};
 // -------- Main Function --------
 int main(void) {
-    std::ofstream debugLog("debug.log", std::ios::app);
-    debugLog << "[START] VR process launched with H.264 encoding\n";
-    std::thread gyroThread(GyroStdinReaderThread, std::ref(gyroQueue));
-    gyroThread.detach();
-    debugLog << "[INFO] Started GyroStdinReaderThread\n";
+    AsyncLogger::instance().start();
+    AsyncLogger::instance().registerThread();
+    ThreadTopology::Scope renderThreadScope("render");
+    VR_LOG_INFO(LogChannel::Main, "VR process launched with H.264 encoding");
+    IoReactor ioReactor;
+    ControlChannel controlChannel;
+    int gyroSourceId = AttachGyroStdinSource(ioReactor, gyroMailbox, &controlChannel);
+    if (gyroSourceId < 0) {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to attach gyro stdin source");
+    }
 
     if (!isStdoutPiped()) {
-        debugLog << "[ERROR] Stdout is not piped. Exiting.\n";
+        VR_LOG_ERROR(LogChannel::Main, "Stdout is not piped. Exiting.");
 		//return 1; temporary fix to allow piping without waiting for stdout to be piped for go side
     }
     const int screenWidth = 1920;
@@ -216,12 +105,279 @@ int main(void) {
     std::string handFilePath = (sharedDir / "hands.dat").string();
     std::string gyroFilePath = (sharedDir / "gyro.dat").string();
 
-    debugLog << "[INFO] Hand file path: " << handFilePath << std::endl;
-    debugLog << "[INFO] Gyro file path: " << gyroFilePath << std::endl;
+    VR_LOG_INFO(LogChannel::Main, "Hand file path: {}", handFilePath);
+    VR_LOG_INFO(LogChannel::Main, "Gyro file path: {}", gyroFilePath);
+
+    // --record <file> captures hand and gyro input for replay; --record-frames adds the encoded output.
+    // --two-pass draws the scene once per eye instead of the instanced single-pass path.
+    // --sync-upload updates the desktop panel with a blocking UpdateTexture instead of the pixel buffer ring.
+    // --always-render renders and encodes every frame; otherwise unchanged frames are skipped and
+    // --keep-alive-ms <ms> (0 disables) bounds the silence, re-sending the last picture, or with
+    // --repeat-marker just a header telling the receiver to show its previous frame again.
+    // --no-reproject sends frames as rendered instead of re-warping them to the newest head pose;
+    // --scene-interval-ms <ms> caps how often the scene renders, re-emitting the last one re-warped in between.
+    // --frame-budget-ms <ms> is the render + readback + encode time the resolution governor holds
+    // frames to by lowering the render and encoder resolution (0 keeps full resolution).
+    // At runtime, "!list", "!get <name>" and "!set <name> <value>" lines on stdin read and change the
+    // parameters registered on controlChannel below; answers come back as pixel_format 4 frames.
+    // --thread <name>=<cpus>[:<priority>] pins a pipeline thread (render, capture, io, io-gyro, upload,
+    // input, metrics, stream, recorder, logger, encoder for x264's pool, or default for the rest) to CPUs
+    // like 2,3 or 4-7 at low|normal|high|realtime priority.
+    // --metrics-file <path> rewrites a Prometheus text file every --metrics-interval-ms (default 5000);
+    // --metrics-socket <path> serves the same text to every connection on a Unix socket
+    // (AF_UNIX, Windows 10 1803 or later).
+    // --stream-socket <path> also publishes the encoded stream to any number of local clients
+    // on a Unix socket.
+    SessionRecorder recorder;
+    bool twoPassStereo = false;
+    FrameChangeTracker frameTracker;
+    bool repeatMarker = false;
+    bool reproject = true;
+    std::chrono::milliseconds sceneInterval{ 0 };
+    const int encodeFps = 120;
+    ResolutionGovernor resolutionGovernor;
+    resolutionGovernor.SetBudget(std::chrono::microseconds(1000000 / encodeFps));
+    std::string metricsFile;
+    std::string metricsSocket;
+    std::chrono::milliseconds metricsInterval{ 5000 };
+    std::string streamSocket;
+    for (int i = 1; i < __argc; i++) {
+        std::string arg = __argv[i];
+        if (arg == "--record" && i + 1 < __argc) {
+            std::string recordPath = __argv[++i];
+            if (recorder.Open(recordPath)) {
+                VR_LOG_INFO(LogChannel::Main, "Recording session to {}", recordPath);
+            }
+        }
+        else if (arg == "--record-frames") {
+            recorder.SetRecordFrames(true);
+        }
+        else if (arg == "--two-pass") {
+            twoPassStereo = true;
+        }
+        else if (arg == "--sync-upload") {
+            desktopRenderer.setStreamingUploads(false);
+        }
+        else if (arg == "--always-render") {
+            frameTracker.SetEnabled(false);
+        }
+        else if (arg == "--keep-alive-ms" && i + 1 < __argc) {
+            frameTracker.SetKeepAlive(std::chrono::milliseconds(std::max(0, std::atoi(__argv[++i]))));
+        }
+        else if (arg == "--repeat-marker") {
+            repeatMarker = true;
+        }
+        else if (arg == "--no-reproject") {
+            reproject = false;
+        }
+        else if (arg == "--scene-interval-ms" && i + 1 < __argc) {
+            sceneInterval = std::chrono::milliseconds(std::max(0, std::atoi(__argv[++i])));
+        }
+        else if (arg == "--thread" && i + 1 < __argc) {
+            std::string spec = __argv[++i];
+            if (!ThreadTopology::instance().Configure(spec)) {
+                VR_LOG_WARN(LogChannel::Main, "Ignoring thread spec {}", spec);
+            }
+        }
+        else if (arg == "--frame-budget-ms" && i + 1 < __argc) {
+            double budgetMs = std::max(0.0, std::atof(__argv[++i]));
+            resolutionGovernor.SetBudget(std::chrono::microseconds(static_cast<int64_t>(budgetMs * 1000.0)));
+        }
+        else if (arg == "--metrics-file" && i + 1 < __argc) {
+            metricsFile = __argv[++i];
+        }
+        else if (arg == "--metrics-socket" && i + 1 < __argc) {
+            metricsSocket = __argv[++i];
+        }
+        else if (arg == "--metrics-interval-ms" && i + 1 < __argc) {
+            metricsInterval = std::chrono::milliseconds(std::max(0, std::atoi(__argv[++i])));
+        }
+        else if (arg == "--stream-socket" && i + 1 < __argc) {
+            streamSocket = __argv[++i];
+        }
+    }
+
+    StereoRenderer stereoRenderer;
+    StereoSceneBatch stereoScene;
+    StereoSceneBatch staticScene;
+    if (!twoPassStereo && !stereoRenderer.Init()) {
+        twoPassStereo = true;
+    }
+    VR_LOG_INFO(LogChannel::Main, "Stereo rendering: {}", twoPassStereo ? "two-pass" : "single-pass instanced");
+    VR_LOG_INFO(LogChannel::Main, "Render on demand: {} keep_alive_ms={} keep_alive_frame={}",
+        frameTracker.IsEnabled() ? "on" : "off", static_cast<int>(frameTracker.GetKeepAlive().count()),
+        repeatMarker ? "repeat marker" : "re-encode");
+    VR_LOG_INFO(LogChannel::Main, "Resolution governor: {} budget_ms={}",
+        resolutionGovernor.IsEnabled() ? "on" : "off", resolutionGovernor.GetBudget().count() / 1000.0);
+    HandRenderer handRenderer;
+    bool instancedHands = handRenderer.Init();
+    PoseReprojector reprojector;
+    if (reproject && reprojector.Init(screenWidth, screenHeight)) {
+        // The warp samples between texels
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+    uint64_t stereoFrames = 0;
+    double stereoCpuMs = 0.0;
+    std::string handJson;
+
+    // Hand file change notifications only feed the latency stats; the file is still
+    // read every frame because writes through a mapping are not always reported.
+    std::atomic<std::chrono::steady_clock::rep> handChangedAt{ 0 };
+    int handSourceId = ioReactor.AddFileWatch("hands", handFilePath,
+        [&handChangedAt](IoReactor::Clock::time_point arrival) {
+            handChangedAt.store(arrival.time_since_epoch().count());
+        });
+
+    if (ioReactor.Start()) {
+        VR_LOG_INFO(LogChannel::Main, "Started I/O reactor");
+    }
+    else {
+        VR_LOG_ERROR(LogChannel::Main, "Failed to start I/O reactor");
+    }
+
+    // How far ahead of the render the frame is expected to reach the headset
+    const float headPredictionHorizon = 0.030f;
+    headPredictor.SetPredictionHorizon(headPredictionHorizon);
+    auto predictedDisplayTime = std::chrono::steady_clock::now();
+
+    // Looked up once here; the frame loop only touches their atomics
+    auto& metrics = MetricsRegistry::instance();
+    auto msBounds = MetricHistogram::ExponentialBounds(0.25, 2.0, 10);  // 0.25 .. 128 ms
+    MetricHistogram& renderMetric = metrics.Histogram("vr_render_ms", "Scene render CPU time", msBounds);
+    MetricHistogram& readbackMetric = metrics.Histogram("vr_readback_ms", "Late latch, reprojection and readback time", msBounds);
+    MetricHistogram& encodeMetric = metrics.Histogram("vr_encode_ms", "H.264 encode time", msBounds);
+    MetricHistogram& frameBytesMetric = metrics.Histogram("vr_encoded_frame_bytes", "Encoded frame size",
+        MetricHistogram::ExponentialBounds(1024.0, 2.0, 12));  // 1 KiB .. 2 MiB
+    MetricHistogram& pipeWriteMetric = metrics.Histogram("vr_pipe_write_ms",
+        "Time stdout took to accept an encoded frame; the tail is the consumer stalling us", msBounds);
+    MetricHistogram& gyroLagMetric = metrics.Histogram("vr_gyro_lag_ms", "Oldest gyro sample age when consumed", msBounds);
+    MetricCounter& framesSentMetric = metrics.Counter("vr_frames_sent_total", "Encoded frames written to stdout");
+    MetricCounter& repeatMarkerMetric = metrics.Counter("vr_repeat_markers_total", "Repeat-previous-frame markers written to stdout");
+    MetricCounter& framesSkippedMetric = metrics.Counter("vr_frames_skipped_total", "Frames not rendered because nothing visible changed");
+    MetricGauge& captureQueueMetric = metrics.Gauge("vr_capture_queue_size", "Captured frames waiting for the panel texture");
+    MetricGauge& renderScaleMetric = metrics.Gauge("vr_render_scale", "Resolution governor render scale");
+    MetricGauge& encoderScaleMetric = metrics.Gauge("vr_encoder_scale", "Resolution governor encoder scale");
+    renderScaleMetric.Set(resolutionGovernor.GetRenderScale());
+    encoderScaleMetric.Set(resolutionGovernor.GetEncoderScale());
+
+    MetricsExporter metricsExporter;
+    if ((!metricsFile.empty() || !metricsSocket.empty()) &&
+        !metricsExporter.Start(metricsFile, metricsSocket, metricsInterval)) {
+        VR_LOG_WARN(LogChannel::Main, "Metrics export disabled");
+    }
+
+    StreamServer streamServer;
+    if (!streamSocket.empty() && !streamServer.Start(streamSocket)) {
+        VR_LOG_WARN(LogChannel::Main, "Stream server disabled");
+    }
+
+    std::vector<GyroData> gyroBatch;
+    gyroBatch.reserve(256);  // also swapped with shmBatch below
+    float gyroMaxLagMs = 0.0f;
+    // Pose latency per frame sent, reported with the gyro stats
+    uint64_t poseFrames = 0;
+    double poseSampleToSendMs = 0.0;
+    float poseMaxSampleToSendMs = 0.0f;
+    double posePredictedAheadMs = 0.0;
+    double posePredictionErrorMs = 0.0;    // absolute
+    auto lastGyroReport = std::chrono::high_resolution_clock::now();
+
+    // Shared-memory gyro ring; stdin remains the fallback while it is absent or idle
+    GyroSharedReader gyroShm;
+    std::vector<GyroData> shmBatch;
+    shmBatch.reserve(256);
+    auto lastShmOpenAttempt = std::chrono::high_resolution_clock::time_point{};
+    auto lastShmSample = std::chrono::high_resolution_clock::time_point{};
+
+    // Drains the gyro sources into the predictor. Called at the top of each frame and
+    // again right before readback so the reprojection sees the freshest pose.
+    auto pollGyro = [&](std::chrono::high_resolution_clock::time_point currentTime) -> size_t {
+        gyroBatch.clear();
+        size_t gyroCount = gyroMailbox.drain(gyroBatch);
+        bool gyroFromShm = false;
+        if (gyroShm.IsOpen()) {
+            shmBatch.clear();
+            if (gyroShm.ReadNew(shmBatch) > 0) {
+                lastShmSample = currentTime;
+            }
+            if (currentTime - lastShmSample < std::chrono::milliseconds(500)) {
+                gyroBatch.swap(shmBatch);
+                gyroCount = gyroBatch.size();
+                gyroFromShm = true;
+            }
+        }
+        if (gyroCount > 0) {
+            latestGyro = gyroBatch.back();
+            VR_LOG_DEBUG(LogChannel::Gyro, "Gyro: {} samples from {}, latest yaw={} pitch={} roll={}",
+                gyroCount, gyroFromShm ? "shm" : "stdin", latestGyro.yaw, latestGyro.pitch, latestGyro.roll);
+
+            auto consumedAt = std::chrono::steady_clock::now();
+            for (const auto& sample : gyroBatch) {
+                headPredictor.AddSample(sample);
+                recorder.RecordGyro(sample);
+                if (!gyroFromShm) {
+                    ioReactor.ReportConsumed(gyroSourceId, sample.timestamp);
+                }
+            }
+            float lagMs = std::chrono::duration<float, std::milli>(consumedAt - gyroBatch.front().timestamp).count();
+            gyroMaxLagMs = std::max(gyroMaxLagMs, lagMs);
+            gyroLagMetric.Observe(lagMs);
+        }
+        return gyroCount;
+    };
 
     std::unique_ptr<H264Encoder> encoder;
+    bool frameReady = false;    // rendered but not yet encoded
+    bool sceneFresh = false;    // frameReady holds a new render rather than a re-warp of the last one
+    bool sceneRendered = false;
+    StereoEye renderedEyes[2] = {};
+    int renderedWidth = screenWidth;    // region of the target the last render covered
+    int renderedHeight = screenHeight;
+    auto lastSceneRender = std::chrono::steady_clock::time_point{};
+    const auto idleWait = std::chrono::milliseconds(2);
     auto lastFrameTime = std::chrono::high_resolution_clock::now();
-    const auto targetFrameTime = std::chrono::microseconds(1000000 / 300); // 300 FPS
+    std::chrono::microseconds targetFrameTime{ 1000000 / 300 }; // 300 FPS
+    EncoderSettings encoderSettings;
+
+    // Live tuning. Setters run on this thread between frames (ControlChannel::Poll below);
+    // the capture thread reads its rate through an atomic.
+    controlChannel.AddFloat("capture.fps", "desktop capture rate", 1.0f, 240.0f,
+        [] { return ScreenCapture::getCaptureRate(); },
+        [](float fps) { ScreenCapture::setCaptureRate(fps); });
+    controlChannel.AddFloat("panel.update_fps", "how often the panel texture takes a new capture", 1.0f, 240.0f,
+        [&] { return desktopRenderer.getMaxUpdateRate(); },
+        [&](float fps) { desktopRenderer.setMaxUpdateRate(fps); });
+    controlChannel.AddInt("encoder.bitrate_kbps", "H.264 target bitrate, restarts the encoder", 100, 100000,
+        [&] { return encoderSettings.bitrate / 1000; },
+        [&](int kbps) { encoderSettings.bitrate = kbps * 1000; });
+    controlChannel.AddInt("encoder.crf", "H.264 constant rate factor, restarts the encoder", 0, 51,
+        [&] { return encoderSettings.crf; },
+        [&](int crf) { encoderSettings.crf = crf; });
+    controlChannel.AddInt("encoder.gop", "frames between key frames, restarts the encoder", 1, 1000,
+        [&] { return encoderSettings.gop; },
+        [&](int gop) { encoderSettings.gop = gop; });
+    controlChannel.AddInt("frame.target_us", "minimum time between encoded frames", 0, 1000000,
+        [&] { return static_cast<int>(targetFrameTime.count()); },
+        [&](int us) { targetFrameTime = std::chrono::microseconds(us); });
+    controlChannel.AddFloat("frame.budget_ms", "resolution governor budget, 0 keeps full resolution", 0.0f, 1000.0f,
+        [&] { return resolutionGovernor.GetBudget().count() / 1000.0f; },
+        [&](float ms) { resolutionGovernor.SetBudget(std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0f))); });
+    controlChannel.AddInt("frame.keep_alive_ms", "longest silence before a keep-alive frame, 0 disables", 0, 60000,
+        [&] { return static_cast<int>(frameTracker.GetKeepAlive().count()); },
+        [&](int ms) { frameTracker.SetKeepAlive(std::chrono::milliseconds(ms)); });
+    controlChannel.AddInt("frame.scene_interval_ms", "minimum time between scene renders when reprojecting", 0, 10000,
+        [&] { return static_cast<int>(sceneInterval.count()); },
+        [&](int ms) { sceneInterval = std::chrono::milliseconds(ms); });
+    controlChannel.AddFloat("panel.x", "panel center", -100.0f, 100.0f,
+        [&] { return panelPosition.x; }, [&](float v) { panelPosition.x = v; });
+    controlChannel.AddFloat("panel.y", "panel center", -100.0f, 100.0f,
+        [&] { return panelPosition.y; }, [&](float v) { panelPosition.y = v; });
+    controlChannel.AddFloat("panel.z", "panel center", -100.0f, 100.0f,
+        [&] { return panelPosition.z; }, [&](float v) { panelPosition.z = v; });
+    controlChannel.AddFloat("panel.width", "panel width in meters", 0.1f, 100.0f,
+        [&] { return panelSize.x; }, [&](float v) { panelSize.x = v; });
+    controlChannel.AddFloat("panel.height", "panel height in meters", 0.1f, 100.0f,
+        [&] { return panelSize.y; }, [&](float v) { panelSize.y = v; });
 
     while (!WindowShouldClose()) {
         auto currentTime = std::chrono::high_resolution_clock::now();
@@ -234,96 +390,381 @@ int main(void) {
         Vector2 delta = { mousePos.x - lastMousePos.x, mousePos.y - lastMousePos.y };
         lastMousePos = mousePos;
         player.HandleMouseLook(delta);
-        debugLog << "[DEBUG] Start of if \n";
-        auto gyroOpt = gyroQueue.tryPop();
-		debugLog << "[DEBUG] gyroOpt: " << (gyroOpt.has_value() ? "true" : "false") << "\n";
-        if((gyroOpt.has_value()?true:false)) {
-        latestGyro = gyroOpt.value();
-        debugLog << "[DEBUG] Entered \n";
-		//for debugging purposes
-                if (latestGyro.yaw != 0.0f || latestGyro.pitch != 0.0f || latestGyro.roll != 0.0f) {  
-                    debugLog << "[DEBUG]latestGyro values not 0 \n";
-                    debugLog << "[INFO] Gyro data received: Yaw=" << latestGyro.yaw << ", Pitch=" << latestGyro.pitch << ", Roll=" << latestGyro.roll << std::endl;  
-                } else {  
-                    debugLog << "[INFO] No new gyro data available, using last known values." << std::endl;  
+        if (!gyroShm.IsOpen() && currentTime - lastShmOpenAttempt >= std::chrono::seconds(1)) {
+            lastShmOpenAttempt = currentTime;
+            if (gyroShm.Open(gyroFilePath)) {
+                VR_LOG_INFO(LogChannel::Main, "Gyro shared memory channel opened");
+            }
+        }
+
+        // Take every sample that arrived since the last frame; the newest drives the
+        // pose and the rest feed the predictor's velocity estimate.
+        pollGyro(currentTime);
+
+        // Parameter changes land here, between two frames; the next one is drawn with them
+        if (controlChannel.Poll([](const std::string& reply) {
+                if (!SendControlReply(std::cout, reply)) {
+                    VR_LOG_ERROR(LogChannel::Main, "Failed to send control reply");
                 }
-            
-        player.SetYawPitchRoll(latestGyro.yaw, latestGyro.pitch, latestGyro.roll);
+            }) > 0) {
+            frameTracker.Invalidate();
         }
 
-        auto handData = ReadHandTrackingData(handFilePath);
+        // Report mailbox health every 5 seconds
+        if (currentTime - lastGyroReport >= std::chrono::seconds(5)) {
+            auto stats = gyroMailbox.stats();
+            VR_LOG_INFO(LogChannel::Main, "Gyro mailbox: pushed={} consumed={} overwritten={} max_backlog={} max_lag_ms={}",
+                stats.pushed, stats.consumed, stats.overwritten, stats.maxBacklog, gyroMaxLagMs);
+            VR_LOG_INFO(LogChannel::Main, "Gyro shm: {} torn_reads={} stale_samples={} producer_resets={}",
+                gyroShm.IsOpen() ? "open" : "closed", gyroShm.GetTornReads(), gyroShm.GetStaleSamples(),
+                gyroShm.GetProducerResets());
+            gyroMailbox.resetStats();
+            gyroMaxLagMs = 0.0f;
+
+            if (poseFrames > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Pose latency: frames={} sample_to_send_ms={} max_sample_to_send_ms={} predicted_ahead_ms={} abs_prediction_error_ms={}",
+                    poseFrames, poseSampleToSendMs / poseFrames, poseMaxSampleToSendMs,
+                    posePredictedAheadMs / poseFrames, posePredictionErrorMs / poseFrames);
+                poseFrames = 0;
+                poseSampleToSendMs = 0.0;
+                poseMaxSampleToSendMs = 0.0f;
+                posePredictedAheadMs = 0.0;
+                posePredictionErrorMs = 0.0;
+            }
+
+            if (stereoFrames > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Stereo {}: frames={} cpu_ms_per_frame={}",
+                    twoPassStereo ? "two-pass" : "single-pass", stereoFrames, stereoCpuMs / stereoFrames);
+                auto stereoStats = stereoRenderer.TakeStats();
+                if (stereoStats.frames > 0) {
+                    double frames = static_cast<double>(stereoStats.frames);
+                    VR_LOG_INFO(LogChannel::Main, "Stereo single-pass: build_ms={} submit_ms={} draw_calls_per_frame={} vertices_per_frame={} uploaded_per_frame={} static_bakes={}",
+                        stereoStats.buildMs / frames, stereoStats.submitMs / frames,
+                        stereoStats.drawCalls / frames, stereoStats.vertices / frames,
+                        stereoStats.uploadedVertices / frames, stereoStats.staticBakes);
+                }
+                stereoFrames = 0;
+                stereoCpuMs = 0.0;
+            }
+
+            auto frameStats = frameTracker.TakeStats();
+            VR_LOG_INFO(LogChannel::Main, "Render on demand: rendered={} keep_alive={} skipped={}",
+                frameStats.rendered, frameStats.keepAlives, frameStats.skipped);
+
+            auto warpStats = reprojector.TakeStats();
+            uint64_t warpPasses = warpStats.warps + warpStats.rewarps;
+            if (warpPasses > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Reprojection: warps={} rewarps={} avg_correction_deg={} max_correction_deg={} ms_per_pass={}",
+                    warpStats.warps, warpStats.rewarps, warpStats.correctionDeg / warpPasses,
+                    warpStats.maxCorrectionDeg, warpStats.warpMs / warpPasses);
+            }
+
+            auto governorStats = resolutionGovernor.TakeStats();
+            if (governorStats.frames > 0) {
+                double frames = static_cast<double>(governorStats.frames);
+                VR_LOG_INFO(LogChannel::Main, "Frame stages: render_ms={} readback_ms={} encode_ms={} budget_ms={} over_budget={}",
+                    governorStats.renders > 0 ? governorStats.renderMs / governorStats.renders : 0.0,
+                    governorStats.readbackMs / frames, governorStats.encodeMs / frames,
+                    resolutionGovernor.GetBudget().count() / 1000.0, governorStats.overBudget);
+                VR_LOG_INFO(LogChannel::Main, "Resolution: render_scale={} encoder_scale={} render_steps={} encoder_steps={}",
+                    resolutionGovernor.GetRenderScale(), resolutionGovernor.GetEncoderScale(),
+                    governorStats.renderSteps, governorStats.encoderSteps);
+            }
+
+            auto uploadStats = desktopRenderer.takeUploadStats();
+            if (uploadStats.frames > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Desktop upload {}: frames={} uploads={} unchanged={} dropped={} worker_ms={}",
+                    uploadStats.streaming ? "streaming" : "sync", uploadStats.frames, uploadStats.uploads,
+                    uploadStats.unchanged, uploadStats.dropped, uploadStats.workerMs);
+                VR_LOG_INFO(LogChannel::Main, "Desktop upload bandwidth: mb={} downscale=1/{}",
+                    uploadStats.uploadedBytes / (1024.0 * 1024.0), uploadStats.downscale);
+                VR_LOG_INFO(LogChannel::Main, "Desktop upload stall: avg_ms={} max_ms={}",
+                    uploadStats.stallMs / uploadStats.frames, uploadStats.maxStallMs);
+            }
+
+            auto controlStats = controlChannel.TakeStats();
+            if (controlStats.commands > 0 || controlStats.dropped > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Control: commands={} changes={} rejected={} dropped={}",
+                    controlStats.commands, controlStats.changes, controlStats.rejected, controlStats.dropped);
+            }
+
+            auto inputStats = desktopRenderer.takeInputStats();
+            if (inputStats.queued > 0) {
+                VR_LOG_INFO(LogChannel::Main, "Input injection: queued={} coalesced={} dropped={} batches={} max_batch={} failed={}",
+                    inputStats.queued, inputStats.coalesced, inputStats.dropped, inputStats.batches,
+                    inputStats.maxBatch, inputStats.failedBatches);
+                if (inputStats.injected > 0) {
+                    VR_LOG_INFO(LogChannel::Main, "Input injection latency: avg_ms={} max_ms={}",
+                        inputStats.latencyMs / inputStats.injected, inputStats.maxLatencyMs);
+                }
+            }
+
+            if (streamServer.IsRunning()) {
+                auto streamStats = streamServer.TakeStats();
+                VR_LOG_INFO(LogChannel::Main, "Stream server: clients={} joined={} left={} sent={} bytes={} published={}",
+                    streamStats.clients, streamStats.joined, streamStats.left, streamStats.packetsSent,
+                    streamStats.bytesSent, streamStats.published);
+                if (streamStats.packetsDropped > 0 || streamStats.disconnected > 0) {
+                    VR_LOG_INFO(LogChannel::Main, "Stream server backpressure: dropped={} resyncs={} disconnected={}",
+                        streamStats.packetsDropped, streamStats.resyncs, streamStats.disconnected);
+                }
+            }
+
+            for (const auto& thread : ThreadTopology::instance().TakeReport()) {
+                VR_LOG_INFO(LogChannel::Main, "Thread {}: cpu_ms={} involuntary_switches={} cpus={} policy={}",
+                    thread.name, thread.cpuMs, thread.involuntarySwitches, thread.cpus, thread.policy);
+            }
+
+            for (const auto& source : ioReactor.GetStats(true)) {
+                VR_LOG_INFO(LogChannel::Main, "I/O source {}: events={} bytes={} max_dispatch_ms={}",
+                    source.name, source.events, source.bytes, source.maxDispatchMs);
+                VR_LOG_INFO(LogChannel::Main, "I/O source {}: consumed={} avg_consume_ms={} max_consume_ms={}",
+                    source.name, source.consumed, source.avgConsumeMs, source.maxConsumeMs);
+            }
+            lastGyroReport = currentTime;
+        }
+
+        // Render with the pose the head will have when this frame is displayed
+        if (headPredictor.HasSamples()) {
+            auto horizon = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<float>(headPredictor.GetPredictionHorizon()));
+            predictedDisplayTime = std::chrono::steady_clock::now() + horizon;
+            player.SetOrientation(headPredictor.Predict(predictedDisplayTime));
+        }
+
+        handJson.clear();
+        auto handData = ReadHandTrackingData(handFilePath, recorder.IsOpen() ? &handJson : nullptr);
+        if (!handJson.empty()) {
+            recorder.RecordHands(std::chrono::steady_clock::now(), handJson);
+        }
+        if (auto changed = handChangedAt.exchange(0)) {
+            ioReactor.ReportConsumed(handSourceId,
+                std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(changed)));
+        }
 
 
         player.Update();
         desktopRenderer.update();
+        captureQueueMetric.Set(static_cast<double>(desktopRenderer.getQueueSize()));
         player.SetPanelInfo(panelPosition, panelSize);
 
-        BeginTextureMode(target);
-        ClearBackground(BLACK);
-
+        // Under the governor both eyes shrink into the bottom-left corner of the fixed-size target,
+        // so a resolution step never reallocates it
+        float renderScale = resolutionGovernor.GetRenderScale();
+        int regionWidth = static_cast<int>(screenWidth * renderScale) & ~1;
+        int regionHeight = static_cast<int>(screenHeight * renderScale) & ~1;
         float gap = 30.0f;
+        StereoEye eyes[2] = {
+            { player.GetLeftEyeCamera(eyeSeparation), 0, 0, regionWidth / 2, regionHeight },
+            { player.GetRightEyeCamera(eyeSeparation), (regionWidth / 2) + (int)(gap * renderScale), 0, regionWidth / 2, regionHeight }
+        };
+        desktopRenderer.updatePanelFootprint(eyes, screenWidth, screenHeight, panelPosition, panelSize);
+        player.UpdateHands(handData);
+
+        // Render, read back and encode only when something visible changed since the last frame
+        FrameChangeTracker::Inputs frameInputs = {
+            eyes[0].camera, eyes[1].camera, player.GetHandRevision(),
+            desktopRenderer.getContentRevision(), player.GetPanelRevision()
+        };
+        auto frameDecision = frameTracker.Evaluate(frameInputs, std::chrono::steady_clock::now());
+        bool renderFrame = frameDecision == FrameChangeTracker::Decision::Render ||
+            (frameDecision == FrameChangeTracker::Decision::KeepAlive && !repeatMarker);
+        bool sceneDue = !reprojector.IsReady() || !sceneRendered || sceneInterval.count() == 0 ||
+            std::chrono::steady_clock::now() - lastSceneRender >= sceneInterval;
+        if (renderFrame && !sceneDue) {
+            // The next scene render is not due yet: re-emit the last one, re-warped to the newest pose.
+            // Invalidating makes the changes that were not drawn count again next frame.
+            frameTracker.Invalidate();
+            frameReady = true;
+        }
+        else if (renderFrame) {
+            auto renderStart = std::chrono::steady_clock::now();
+            BeginTextureMode(target);
+            ClearBackground(BLACK);
+
+            auto stereoStart = std::chrono::steady_clock::now();
+            if (instancedHands) {
+                handRenderer.SetHands(player.leftHand, player.rightHand);
+            }
+            if (!twoPassStereo) {
+                // Grid and panel stay on the GPU until the panel moves or its texture changes
+                uint64_t staticKey = (static_cast<uint64_t>(player.GetPanelRevision()) << 32) | desktopRenderer.getTextureId();
+                if (!stereoRenderer.IsStaticCurrent(staticKey)) {
+                    staticScene.Clear();
+                    staticScene.Grid(20, 1.0f);
+                    desktopRenderer.appendDesktopPanel(staticScene, panelPosition, panelSize);
+                    stereoRenderer.BakeStatic(staticScene, staticKey);
+                    VR_LOG_INFO(LogChannel::Main, "Baked static scene: {} vertices",
+                        staticScene.GetColored().size() + staticScene.GetTextured().size());
+                }
 
-        // Left eye
-        rlViewport(0, 0, screenWidth / 2, screenHeight);
-        BeginMode3D(player.GetLeftEyeCamera(eyeSeparation));
-        DrawGrid(20, 1.0f);
-        desktopRenderer.renderDesktopPanel(panelPosition, panelSize);
-        player.DrawHands(handData);
-        player.DrawLaserPointer();
-        EndMode3D();
-
-        // Right eye
-        rlViewport((screenWidth / 2) + (int)gap, 0, screenWidth / 2, screenHeight);
-        BeginMode3D(player.GetRightEyeCamera(eyeSeparation));
-        DrawGrid(20, 1.0f);
-        desktopRenderer.renderDesktopPanel(panelPosition, panelSize);
-        player.DrawHands(handData);
-        player.DrawLaserPointer();
-        EndMode3D();
-
-        rlViewport(0, 0, screenWidth, screenHeight);
-        EndTextureMode();
-
-        BeginDrawing();
-        EndDrawing();
+                // Per-frame geometry is built once; both eyes come out of one instanced draw per texture
+                stereoScene.Clear();
+                if (!instancedHands) {
+                    player.AppendHands(stereoScene);
+                }
+                player.AppendLaserPointer(stereoScene);
+                stereoRenderer.AddBuildTime(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - stereoStart).count());
+                stereoRenderer.Render(stereoScene, eyes, screenWidth, screenHeight);
+                if (instancedHands) {
+                    handRenderer.DrawStereo(eyes, screenWidth, screenHeight);
+                }
+            }
+            else {
+                for (const auto& eye : eyes) {
+                    rlViewport(eye.viewportX, eye.viewportY, eye.viewportWidth, eye.viewportHeight);
+                    BeginMode3D(eye.camera);
+                    DrawGrid(20, 1.0f);
+                    desktopRenderer.renderDesktopPanel(panelPosition, panelSize);
+                    if (instancedHands) {
+                        handRenderer.Draw();
+                    }
+                    else {
+                        player.DrawVRHand(player.leftHand);
+                        player.DrawVRHand(player.rightHand);
+                    }
+                    player.DrawLaserPointer();
+                    EndMode3D();
+                }
+            }
+            stereoCpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stereoStart).count();
+            stereoFrames++;
+
+            rlViewport(0, 0, screenWidth, screenHeight);
+            EndTextureMode();
+
+            BeginDrawing();
+            EndDrawing();
+            frameReady = true;
+            sceneFresh = true;
+            sceneRendered = true;
+            renderedEyes[0] = eyes[0];
+            renderedEyes[1] = eyes[1];
+            renderedWidth = regionWidth;
+            renderedHeight = regionHeight;
+            lastSceneRender = std::chrono::steady_clock::now();
+            double renderMs = std::chrono::duration<double, std::milli>(lastSceneRender - renderStart).count();
+            resolutionGovernor.AddRender(renderMs);
+            renderMetric.Observe(renderMs);
+        }
+        else {
+            PollInputEvents();  // EndDrawing normally does this
+            // The marker repeats the last encoded frame, so it carries that frame's size; with
+            // no encoder yet there is nothing to repeat
+            if (frameDecision == FrameChangeTracker::Decision::KeepAlive && encoder) {
+                if (!SendRepeatMarker(std::cout, encoder->getWidth(), encoder->getHeight())) {
+                    VR_LOG_ERROR(LogChannel::Main, "Failed to send repeat marker");
+                    break;
+                }
+                repeatMarkerMetric.Add();
+            }
+            else {
+                framesSkippedMetric.Add();
+            }
+        }
 
         // Frame Rate Control
         auto elapsedTime = std::chrono::high_resolution_clock::now() - lastFrameTime;
-        if (elapsedTime >= targetFrameTime) {
+        if (frameReady && elapsedTime >= targetFrameTime) {
             lastFrameTime = currentTime;
+            frameReady = false;
+
+            // Late latch: pick up gyro samples that arrived while rendering and warp the
+            // frame to the orientation predicted from them
+            auto readbackStart = std::chrono::steady_clock::now();
+            RenderTexture2D outputTarget = target;
+            if (reprojector.IsReady() && headPredictor.HasSamples()) {
+                pollGyro(std::chrono::high_resolution_clock::now());
+                player.SetOrientation(headPredictor.Predict(predictedDisplayTime));
+                player.Update();
+                StereoEye lateEyes[2] = { renderedEyes[0], renderedEyes[1] };
+                lateEyes[0].camera = player.GetLeftEyeCamera(eyeSeparation);
+                lateEyes[1].camera = player.GetRightEyeCamera(eyeSeparation);
+                reprojector.Warp(target.texture, renderedEyes, lateEyes, !sceneFresh);
+                outputTarget = reprojector.GetOutputTarget();
+            }
+            sceneFresh = false;
 
             // Grab Frame and Encode
-            Image frame = LoadImageFromTexture(target.texture);
-            ImageFlipVertical(&frame);
-
-            if (!encoder) {
+            Image frame = ReadFrameRegion(outputTarget, renderedWidth, renderedHeight);
+            double readbackMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - readbackStart).count();
+            resolutionGovernor.AddReadback(readbackMs);
+            readbackMetric.Observe(readbackMs);
+
+            // The encoder only restarts when the governor changes its scale
+            int encodeWidth = static_cast<int>(screenWidth * resolutionGovernor.GetEncoderScale()) & ~1;
+            int encodeHeight = static_cast<int>(screenHeight * resolutionGovernor.GetEncoderScale()) & ~1;
+            if (!encoder || encoder->getWidth() != encodeWidth || encoder->getHeight() != encodeHeight ||
+                encoder->getSettings() != encoderSettings) {
                 try {
-                    encoder = std::make_unique<H264Encoder>(frame.width, frame.height, 120);
-                    debugLog << "[INFO] H.264 encoder initialized: " << frame.width << "x" << frame.height << std::endl;
+                    encoder.reset();
+                    encoder = std::make_unique<H264Encoder>(encodeWidth, encodeHeight, encodeFps, encoderSettings);
+                    VR_LOG_INFO(LogChannel::Main, "H.264 encoder initialized: {}x{}", encodeWidth, encodeHeight);
                 }
                 catch (const std::exception& e) {
-                    debugLog << "[ERROR] Failed to initialize encoder: " << e.what() << std::endl;
+                    VR_LOG_ERROR(LogChannel::Main, "Failed to initialize encoder: {}", e.what());
                     UnloadImage(frame);
                     break;
                 }
             }
 
             try {
-                auto encoded = encoder->encodeFrame((uint8_t*)frame.data);
+                auto encodeStart = std::chrono::steady_clock::now();
+                auto encoded = encoder->encodeFrame((uint8_t*)frame.data, frame.width, frame.height);
+                auto encodeEnd = std::chrono::steady_clock::now();
+                double encodeMs = std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count();
+                resolutionGovernor.AddEncode(encodeMs);
+                encodeMetric.Observe(encodeMs);
 
                 if (!encoded.empty()) {
-                    if (!SendH264Frame(encoded, frame.width, frame.height)) {
-                        debugLog << "[ERROR] Failed to send H.264 frame" << std::endl;
+                    if (!SendH264Frame(std::cout, encoded, encodeWidth, encodeHeight)) {
+                        VR_LOG_ERROR(LogChannel::Main, "Failed to send H.264 frame");
                         UnloadImage(frame);
                         break;
                     }
+                    pipeWriteMetric.Observe(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - encodeEnd).count());
+                    frameBytesMetric.Observe(static_cast<double>(encoded.size()));
+                    framesSentMetric.Add();
+                    streamServer.Publish(encoded.data(), encoded.size(), encodeWidth, encodeHeight, GetCurrentTimeMs());
+                    recorder.RecordFrame(std::chrono::steady_clock::now(), encodeWidth, encodeHeight, encoded);
+
+                    // Pose latency: sample -> send, and how far the prediction was off from it
+                    if (headPredictor.HasSamples()) {
+                        using msf = std::chrono::duration<float, std::milli>;
+                        auto sentAt = std::chrono::steady_clock::now();
+                        auto sampledAt = headPredictor.GetLatestTimestamp();
+                        float sampleToSendMs = msf(sentAt - sampledAt).count();
+                        poseFrames++;
+                        poseSampleToSendMs += sampleToSendMs;
+                        poseMaxSampleToSendMs = std::max(poseMaxSampleToSendMs, sampleToSendMs);
+                        posePredictedAheadMs += msf(predictedDisplayTime - sampledAt).count();
+                        posePredictionErrorMs += std::abs(msf(sentAt - predictedDisplayTime).count());
+                    }
                 }
             }
             catch (const std::exception& e) {
-                debugLog << "[ERROR] Encoding error: " << e.what() << std::endl;
+                VR_LOG_ERROR(LogChannel::Main, "Encoding error: {}", e.what());
             }
 
             UnloadImage(frame);
+
+            if (resolutionGovernor.Update(std::chrono::steady_clock::now())) {
+                VR_LOG_INFO(LogChannel::Main, "Resolution: render_scale={} encoder_scale={}",
+                    resolutionGovernor.GetRenderScale(), resolutionGovernor.GetEncoderScale());
+                renderScaleMetric.Set(resolutionGovernor.GetRenderScale());
+                encoderScaleMetric.Set(resolutionGovernor.GetEncoderScale());
+                if (resolutionGovernor.GetRenderScale() != renderScale) {
+                    // The last render covers the old region; draw the next frame anew instead of re-warping it
+                    frameTracker.Invalidate();
+                    sceneRendered = false;
+                }
+            }
+        }
+        else if (!frameReady) {
+            // Idle: nothing to encode, so wait for the next gyro sample instead of spinning
+            gyroMailbox.waitPending(idleWait);
         }
         else {
             // Sleep for remaining time to maintain frame rate
@@ -332,6 +773,10 @@ int main(void) {
     }
 
     // Cleanup
+    ioReactor.Stop();
+    metricsExporter.Stop();
+    streamServer.Stop();
+    recorder.Close();
     if (handRegion) {
         delete handRegion;
         handRegion = nullptr;
@@ -341,48 +786,25 @@ int main(void) {
     desktopRenderer.cleanup();
     UnloadRenderTexture(target);
     CloseWindow();
-    debugLog << "[END] VR process terminated\n";
+    VR_LOG_INFO(LogChannel::Main, "VR process terminated");
+    AsyncLogger::instance().stop();
     return 0;
 }
 
+// Reads the bottom-left width x height of a render target, top row first
+Image ReadFrameRegion(const RenderTexture2D& source, int width, int height) {
+    BeginTextureMode(source);
+    Image image = { rlReadScreenPixels(width, height), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    EndTextureMode();
+    return image;
+}
+
 bool isStdoutPiped() {
     return !_isatty(_fileno(stdout));
 	
 }
 
-uint32_t GetCurrentTimeMs() {
-    using namespace std::chrono;
-    return static_cast<uint32_t>(duration_cast<milliseconds>(high_resolution_clock::now().time_since_epoch()).count());
-}
-
-bool SendH264Frame(const std::vector<uint8_t>& frameData, int width, int height) {
-    try {
-        FrameHeader header;
-        header.timestamp_ms = GetCurrentTimeMs();
-        header.frame_size = static_cast<uint32_t>(frameData.size());
-        header.width = static_cast<uint32_t>(width);
-        header.height = static_cast<uint32_t>(height);
-        header.pixel_format = 2;  // H264 format
-
-        // Write header
-        std::cout.write(reinterpret_cast<const char*>(&header), sizeof(header));
-        if (!std::cout.good()) return false;
-
-        // Write frame data
-        std::cout.write(reinterpret_cast<const char*>(frameData.data()), frameData.size());
-        if (!std::cout.good()) return false;
-
-        std::cout.flush();
-        return std::cout.good();
-    }
-    catch (const std::exception& e) {
-        std::ofstream errorLog("frame_error.log", std::ios::app);
-        errorLog << "Error sending H.264 frame: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-std::vector<HandTrackingData> ReadHandTrackingData(const std::string& filename) {
+std::vector<HandTrackingData> ReadHandTrackingData(const std::string& filename, std::string* rawJson) {
     namespace bip = boost::interprocess;
     std::vector<HandTrackingData> handData;
 
@@ -410,33 +832,17 @@ std::vector<HandTrackingData> ReadHandTrackingData(const std::string& filename)
             return handData;
         }
 
-        std::string json_data(mem + sizeof(uint32_t), size);
-        auto parsed = nlohmann::json::parse(json_data);
-
-        for (const auto& hand : parsed) {
-            HandTrackingData tracked;
-            tracked.handedness = hand.value("handedness", "");
-            tracked.distance_factor = hand.value("distance_factor", 1.0f);
-            tracked.depth_scale = hand.value("depth_scale", 1.0f);
-            tracked.shoulder_calibrated = hand.value("shoulder_calibrated", false);
-            tracked.confidence = hand.value("confidence", 0.7f);
-
-            if (hand.contains("landmarks")) {
-                for (const auto& lm : hand["landmarks"]) {
-                    Vector3 pt = {
-                        lm.value("x", 0.0f),
-                        lm.value("y", 0.0f),
-                        lm.value("z", 0.0f)
-                    };
-                    tracked.landmarks.push_back(pt);
-                }
-            }
-            handData.push_back(tracked);
+        const char* json = mem + sizeof(uint32_t);
+        if (rawJson) {
+            rawJson->assign(json, size);
         }
+        handData = ParseHandTrackingJson(json, size);
     }
     catch (const std::exception& e) {
-        std::ofstream errorLog("hand_error.log", std::ios::app);
-        errorLog << "Error reading hand tracking data: " << e.what() << std::endl;
+        static MetricCounter& handFailures = MetricsRegistry::instance().Counter(
+            "vr_hand_parse_failures_total", "hands.dat payloads that could not be read or parsed");
+        handFailures.Add();
+        VR_LOG_ERROR(LogChannel::Hand, "Error reading hand tracking data: {}", e.what());
     }
 
     return handData;
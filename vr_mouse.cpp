@@ -1,11 +1,16 @@
 #include "vr_mouse.h"
-#include <fstream>
+#include "async_logger.h"
 #include "raymath.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-VRMouseController::VRMouseController() {
+VRMouseController::VRMouseController(VRPointerRole role) : role(role) {
     vrMouse.isActive = false;
     vrMouse.isClicking = false;
     vrMouse.isDragging = false;
+    vrMouse.isScrolling = false;
+    vrMouse.scrollDelta = 0.0f;
+    vrMouse.lastScrollUV = { 0.5f, 0.5f };
     vrMouse.clickCooldown = 0.0f;
     vrMouse.dragThreshold = 0.02f;
     vrMouse.position = { 0, 0, 0 };
@@ -14,41 +19,79 @@ VRMouseController::VRMouseController() {
     clickThreshold = 0.03f;
 }
 
+bool VRMouseController::LoadGestureTemplates(const std::string& path) {
+    if (!gestureTemplates.LoadTemplates(path)) {
+        gestureRecognizer.SetTemplateClassifier(nullptr);
+        return false;
+    }
+    gestureRecognizer.SetTemplateClassifier(&gestureTemplates);
+    VR_LOG_INFO(LogChannel::Hand, "Loaded {} gesture templates from {}", gestureTemplates.GetTemplateCount(), path);
+    return true;
+}
+
 void VRMouseController::SetPanelInfo(const Vector3& position, const Vector3& size) {
     panelPosition = position;
     panelSize = size;
 }
 
 void VRMouseController::Update(const HandLandmarks& rightHand, float deltaTime) {
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    Update(rightHand, deltaTime, now);
+}
+
+void VRMouseController::Update(const HandLandmarks& rightHand, float deltaTime, double timestamp) {
+    // Measure the hand once; the recognizer and the pointer logic share it
+    HandFeatures features;
+    GestureData gesture = {};
+    gesture.type = GestureType::NONE;
+    if (rightHand.active[0]) {
+        ComputeHandFeatures(rightHand, features);
+        gesture = gestureRecognizer.RecognizeGesture(rightHand, features, timestamp);
+    }
+    Update(rightHand, features, gesture, deltaTime);
+}
+
+void VRMouseController::Update(const HandLandmarks& hand, const HandFeatures& features, const GestureData& gesture, float deltaTime) {
     // Update cooldowns
     if (vrMouse.clickCooldown > 0.0f) {
         vrMouse.clickCooldown -= deltaTime;
     }
 
-    if (!rightHand.active[0]) {
+    if (!hand.active[0]) {
         vrMouse.isActive = false;
+        vrMouse.isScrolling = false;
         vrMouse.activeGesture = GestureType::NONE;
         return;
     }
 
-    // Recognize current gesture
-    GestureData gesture = gestureRecognizer.RecognizeGesture(rightHand);
     vrMouse.activeGesture = gesture.type;
 
     // Check if pointing at panel
-    if (IsPointingAtPanel(rightHand)) {
+    if (IsPointingAtPanel(features)) {
         vrMouse.isActive = true;
-        UpdateMousePosition(rightHand);
-        UpdateClickState(rightHand);
-        UpdateDragState(rightHand);
+        UpdateMousePosition(hand);
+        if (role == VRPointerRole::Scroll) {
+            UpdateScrollState(features);
+        }
+        else {
+            UpdateClickState(features);
+            UpdateDragState(hand);
+        }
     }
     else {
         vrMouse.isActive = false;
         vrMouse.isClicking = false;
         vrMouse.isDragging = false;
+        vrMouse.isScrolling = false;
     }
 }
 
+float VRMouseController::TakeScrollDelta() {
+    float delta = vrMouse.scrollDelta;
+    vrMouse.scrollDelta = 0.0f;
+    return delta;
+}
+
 void VRMouseController::Draw() {
     if (!vrMouse.isActive) return;
 
@@ -83,16 +126,16 @@ Vector2 VRMouseController::GetPanelUVFromWorldPos(const Vector3& worldPos) {
     return uv;
 }
 
-bool VRMouseController::IsPointingAtPanel(const HandLandmarks& hand) {
-    if (!hand.active[8]) return false; // Index fingertip
+bool VRMouseController::IsPointingAtPanel(const HandFeatures& features) {
+    if (!features.tipActive[1]) return false; // Index fingertip
 
     // Check if index finger is extended and pointing toward panel
-    bool indexExtended = gestureRecognizer.IsIndexFingerExtended(hand);
+    bool indexExtended = gestureRecognizer.IsIndexFingerExtended(features);
 
     if (!indexExtended) return false;
 
     // Check if fingertip is within reasonable distance to panel
-    Vector3 indexTip = hand.landmarks[8];
+    Vector3 indexTip = features.indexTip;
     float distanceToPanel = fabsf(indexTip.z - panelPosition.z);
 
     return distanceToPanel < 0.5f; // Within 50cm of panel
@@ -106,8 +149,8 @@ void VRMouseController::UpdateMousePosition(const HandLandmarks& hand) {
     vrMouse.panelUV = GetPanelUVFromWorldPos(indexTip);
 }
 
-void VRMouseController::UpdateClickState(const HandLandmarks& hand) {
-    bool isPinching = gestureRecognizer.IsPinchGesture(hand, clickThreshold);
+void VRMouseController::UpdateClickState(const HandFeatures& features) {
+    bool isPinching = gestureRecognizer.IsPinchGesture(features, clickThreshold);
 
     if (isPinching && vrMouse.clickCooldown <= 0.0f && !vrMouse.isClicking) {
         vrMouse.isClicking = true;
@@ -115,8 +158,7 @@ void VRMouseController::UpdateClickState(const HandLandmarks& hand) {
         vrMouse.lastClickUV = vrMouse.panelUV;
 
         // Log click for debugging
-        std::ofstream debug("vr_mouse_clicks.log", std::ios::app);
-        debug << "VR Click at UV: " << vrMouse.panelUV.x << ", " << vrMouse.panelUV.y << std::endl;
+        VR_LOG_INFO(LogChannel::Mouse, "VR Click at UV: {}, {}", vrMouse.panelUV.x, vrMouse.panelUV.y);
     }
     else if (!isPinching) {
         vrMouse.isClicking = false;
@@ -139,12 +181,31 @@ void VRMouseController::UpdateDragState(const HandLandmarks& hand) {
     }
 }
 
+void VRMouseController::UpdateScrollState(const HandFeatures& features) {
+    bool isPinching = gestureRecognizer.IsPinchGesture(features, clickThreshold);
+
+    if (!isPinching) {
+        vrMouse.isScrolling = false;
+        return;
+    }
+
+    // Pinch grabs the page; vertical travel of the pointer scrolls it
+    if (vrMouse.isScrolling) {
+        vrMouse.scrollDelta += vrMouse.panelUV.y - vrMouse.lastScrollUV.y;
+    }
+    vrMouse.isScrolling = true;
+    vrMouse.lastScrollUV = vrMouse.panelUV;
+}
+
 void VRMouseController::DrawCursor() {
     Color cursorColor = YELLOW;
 
     if (vrMouse.isClicking) {
         cursorColor = GREEN;
     }
+    else if (vrMouse.isScrolling) {
+        cursorColor = SKYBLUE;
+    }
     else if (vrMouse.isDragging) {
         cursorColor = ORANGE;
     }
@@ -172,3 +233,111 @@ void VRMouseController::DrawRayToPanel() {
     Color rayColor = vrMouse.isClicking ? GREEN : YELLOW;
     DrawLine3D(vrMouse.position, panelHitPoint, rayColor);
 }
+
+VRHandsController::VRHandsController(VRPointerRole leftRole, VRPointerRole rightRole)
+    : left(leftRole), right(rightRole) {
+    leftGesture = {};
+    rightGesture = {};
+    handednessCollisions = 0;
+    collidedLastFrame = false;
+}
+
+float VRHandsController::SlotDistance(const HandLandmarks& hand, int slot) const {
+    const MotionHistory& history = recognizer.GetMotionHistory(slot);
+    return history.Empty() ? 0.0f : Vector3Distance(hand.landmarks[0], history.Latest().position);
+}
+
+bool VRHandsController::LoadGestureTemplates(const std::string& path) {
+    if (!gestureTemplates.LoadTemplates(path)) {
+        recognizer.SetTemplateClassifier(nullptr);
+        return false;
+    }
+    recognizer.SetTemplateClassifier(&gestureTemplates);
+    VR_LOG_INFO(LogChannel::Hand, "Loaded {} gesture templates from {}", gestureTemplates.GetTemplateCount(), path);
+    return true;
+}
+
+void VRHandsController::SetPanelInfo(const Vector3& position, const Vector3& size) {
+    left.SetPanelInfo(position, size);
+    right.SetPanelInfo(position, size);
+}
+
+void VRHandsController::Update(std::span<const HandLandmarks> hands, float deltaTime, double timestamp) {
+    int claimed[2] = { -1, -1 };    // by slot: 0 = left, 1 = right
+    int duplicate[2] = { -1, -1 };  // a second hand reporting the same side
+    for (size_t i = 0; i < hands.size(); i++) {
+        int slot = GestureRecognizer::HandSlot(hands[i]);
+        if (slot > 1) continue;
+        if (claimed[slot] < 0) claimed[slot] = static_cast<int>(i);
+        else if (duplicate[slot] < 0) duplicate[slot] = static_cast<int>(i);
+    }
+
+    // The tracker occasionally labels both hands the same. If the other side is free,
+    // the pair is split between the slots so that each wrist stays nearest to where
+    // that slot's wrist was last frame, and the moved hand is relabelled so gesture
+    // recognition also keeps its motion history apart. A third hand is still ignored.
+    bool moved[2] = { false, false };  // by slot: the hand was reported for the other side
+    bool collided = false;
+    for (int slot = 0; slot < 2; slot++) {
+        int other = 1 - slot;
+        if (duplicate[slot] < 0) continue;
+        collided = true;
+        if (claimed[other] >= 0) continue;
+
+        int a = claimed[slot];
+        int b = duplicate[slot];
+        float keep = SlotDistance(hands[a], slot) + SlotDistance(hands[b], other);
+        float swap = SlotDistance(hands[b], slot) + SlotDistance(hands[a], other);
+        if (swap < keep) std::swap(a, b);
+        claimed[slot] = a;
+        claimed[other] = b;
+        moved[other] = true;
+    }
+    if (collided) {
+        handednessCollisions++;
+        if (!collidedLastFrame) {
+            VR_LOG_WARN(LogChannel::Hand, "Two hands reported the same handedness; split by wrist position (frames so far: {})",
+                handednessCollisions);
+        }
+    }
+    collidedLastFrame = collided;
+
+    // Only the claimed hands are measured and classified, so an ignored hand never
+    // touches the recognizer's per-hand state
+    HandLandmarks tracked[2];
+    int position[2] = { -1, -1 };  // by slot: index into tracked
+    size_t count = 0;
+    for (int slot = 0; slot < 2; slot++) {
+        if (claimed[slot] < 0) continue;
+        tracked[count] = hands[claimed[slot]];
+        if (moved[slot]) tracked[count].handedness = slot == 0 ? "Left" : "Right";
+        position[slot] = static_cast<int>(count++);
+    }
+
+    HandFeatures features[2];
+    GestureData gestures[2];
+    std::span<const HandLandmarks> trackedHands(tracked, count);
+    ComputeHandFeatures(trackedHands, std::span<HandFeatures>(features, count));
+    recognizer.RecognizeGestures(trackedHands, std::span<const HandFeatures>(features, count),
+        std::span<GestureData>(gestures, count), timestamp);
+
+    int leftIndex = position[0];
+    int rightIndex = position[1];
+
+    static const HandLandmarks lostHand = {};
+    const HandFeatures noFeatures = {};
+    GestureData none = {};
+    none.type = GestureType::NONE;
+
+    leftGesture = leftIndex >= 0 ? gestures[leftIndex] : none;
+    rightGesture = rightIndex >= 0 ? gestures[rightIndex] : none;
+    left.Update(leftIndex >= 0 ? tracked[leftIndex] : lostHand,
+        leftIndex >= 0 ? features[leftIndex] : noFeatures, leftGesture, deltaTime);
+    right.Update(rightIndex >= 0 ? tracked[rightIndex] : lostHand,
+        rightIndex >= 0 ? features[rightIndex] : noFeatures, rightGesture, deltaTime);
+}
+
+void VRHandsController::Draw() {
+    left.Draw();
+    right.Draw();
+}
@@ -3,6 +3,15 @@
 
 #include "raylib.h"
 #include "gesture_recognition.h"
+#include "gesture_templates.h"
+#include <span>
+#include <string>
+
+// What a pointer does with a pinch: click/drag, or scroll by moving the pinched hand
+enum class VRPointerRole {
+    Click,
+    Scroll
+};
 
 struct VRMouse {
     Vector3 position;
@@ -10,9 +19,12 @@ struct VRMouse {
     bool isActive;
     bool isClicking;
     bool isDragging;
+    bool isScrolling;
+    float scrollDelta;      // panel heights scrolled since the last TakeScrollDelta()
     float clickCooldown;
     float dragThreshold;
     Vector2 lastClickUV;
+    Vector2 lastScrollUV;
 
     // Future gesture support
     GestureType activeGesture;
@@ -21,34 +33,85 @@ struct VRMouse {
 
 class VRMouseController {
 public:
-    VRMouseController();
+    explicit VRMouseController(VRPointerRole role = VRPointerRole::Click);
 
     void SetPanelInfo(const Vector3& position, const Vector3& size);
     void Update(const HandLandmarks& rightHand, float deltaTime);
+    // timestamp in seconds, for replaying recorded input deterministically
+    void Update(const HandLandmarks& rightHand, float deltaTime, double timestamp);
+    // For hands already measured and classified by a shared recognizer (see VRHandsController)
+    void Update(const HandLandmarks& hand, const HandFeatures& features, const GestureData& gesture, float deltaTime);
     void Draw();
 
     // Mouse data access
     bool GetMouseData(Vector2& mouseUV, bool& isClicking, bool& isDragging);
     GestureType GetActiveGesture() const { return vrMouse.activeGesture; }
+    bool IsScrolling() const { return vrMouse.isScrolling; }
+    float TakeScrollDelta();
+    VRPointerRole GetRole() const { return role; }
 
     // Configuration
     void SetClickThreshold(float threshold) { clickThreshold = threshold; }
     void SetDragThreshold(float threshold) { vrMouse.dragThreshold = threshold; }
+    // Switches static gesture recognition to the recorded templates in `path`
+    bool LoadGestureTemplates(const std::string& path);
 
 private:
     VRMouse vrMouse;
     GestureRecognizer gestureRecognizer;
+    GestureTemplateClassifier gestureTemplates;
     Vector3 panelPosition;
     Vector3 panelSize;
     float clickThreshold;
+    VRPointerRole role;
 
     Vector2 GetPanelUVFromWorldPos(const Vector3& worldPos);
-    bool IsPointingAtPanel(const HandLandmarks& hand);
+    bool IsPointingAtPanel(const HandFeatures& features);
     void UpdateMousePosition(const HandLandmarks& hand);
-    void UpdateClickState(const HandLandmarks& hand);
+    void UpdateClickState(const HandFeatures& features);
     void UpdateDragState(const HandLandmarks& hand);
+    void UpdateScrollState(const HandFeatures& features);
     void DrawCursor();
     void DrawRayToPanel();
 };
 
+/**
+ * Two independent pointers, one per hand: by default the left hand scrolls and the
+ * right hand clicks. All tracked hands are measured and classified in one batched
+ * recognizer call per frame, so each hand keeps its own motion state.
+ */
+class VRHandsController {
+public:
+    VRHandsController(VRPointerRole leftRole = VRPointerRole::Scroll, VRPointerRole rightRole = VRPointerRole::Click);
+
+    void SetPanelInfo(const Vector3& position, const Vector3& size);
+    // Hands are routed by handedness; hands missing from the span are treated as lost.
+    // Two hands reporting the same side are split between the two slots by wrist position.
+    void Update(std::span<const HandLandmarks> hands, float deltaTime, double timestamp);
+    void Draw();
+
+    VRMouseController& GetLeft() { return left; }
+    VRMouseController& GetRight() { return right; }
+    const GestureData& GetLeftGesture() const { return leftGesture; }
+    const GestureData& GetRightGesture() const { return rightGesture; }
+    GestureRecognizer& GetRecognizer() { return recognizer; }
+    // Frames in which two hands reported the same handedness
+    uint64_t GetHandednessCollisions() const { return handednessCollisions; }
+    // Switches static gesture recognition for both hands to the recorded templates
+    bool LoadGestureTemplates(const std::string& path);
+
+private:
+    GestureRecognizer recognizer;
+    GestureTemplateClassifier gestureTemplates;
+    VRMouseController left;
+    VRMouseController right;
+    GestureData leftGesture;
+    GestureData rightGesture;
+    uint64_t handednessCollisions;
+    bool collidedLastFrame;
+
+    // Distance from a wrist to where the slot's wrist was last seen; 0 without history
+    float SlotDistance(const HandLandmarks& hand, int slot) const;
+};
+
 #endif // VR_MOUSE_H
@@ -1,60 +1,74 @@
 // ONLY include windows.h in this file - NO RAYLIB
 #include <windows.h>
 #include "windows_input.h"
+#include "input_injector.h"
+#include <climits>
+#include <vector>
 
-void SendVRLeftClick(int x, int y) {
-    SetCursorPos(x, y);
+namespace {
 
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
-    SendInput(1, &input, sizeof(INPUT));
+class WindowsInputBackend : public InputBackend {
+public:
+    const char* GetName() const override { return "SendInput"; }
 
-    input.mi.dwFlags = MOUSEEVENTF_LEFTUP;
-    SendInput(1, &input, sizeof(INPUT));
-}
-
-void SendVRRightClick(int x, int y) {
-    SetCursorPos(x, y);
+    bool Inject(const InputEvent* events, size_t count) override {
+        // Absolute coordinates are normalized to 0..65535 across the primary screen
+        int screenWidth = GetSystemMetrics(SM_CXSCREEN);
+        int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+        if (screenWidth <= 1 || screenHeight <= 1) {
+            return false;
+        }
 
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dwFlags = MOUSEEVENTF_RIGHTDOWN;
-    SendInput(1, &input, sizeof(INPUT));
+        inputs.clear();
+        for (size_t i = 0; i < count; i++) {
+            const InputEvent& event = events[i];
+            // Buttons press where they were issued; the pointer only moves when it has to
+            if (event.x != lastX || event.y != lastY) {
+                INPUT input = {};
+                input.type = INPUT_MOUSE;
+                input.mi.dx = MulDiv(event.x, 65535, screenWidth - 1);
+                input.mi.dy = MulDiv(event.y, 65535, screenHeight - 1);
+                input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE;
+                inputs.push_back(input);
+                lastX = event.x;
+                lastY = event.y;
+            }
+            if (event.type == InputEvent::Type::Move || event.button == InputButton::None) {
+                continue;
+            }
 
-    input.mi.dwFlags = MOUSEEVENTF_RIGHTUP;
-    SendInput(1, &input, sizeof(INPUT));
-}
+            bool down = event.type == InputEvent::Type::ButtonDown;
+            INPUT input = {};
+            input.type = INPUT_MOUSE;
+            if (event.button == InputButton::Left) {
+                input.mi.dwFlags = down ? MOUSEEVENTF_LEFTDOWN : MOUSEEVENTF_LEFTUP;
+            }
+            else {
+                input.mi.dwFlags = down ? MOUSEEVENTF_RIGHTDOWN : MOUSEEVENTF_RIGHTUP;
+            }
+            inputs.push_back(input);
+        }
 
-void SendVRMouseMove(int x, int y) {
-    SetCursorPos(x, y);
-
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dx = x;
-    input.mi.dy = y;
-    input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE;
-    SendInput(1, &input, sizeof(INPUT));
-}
+        if (inputs.empty()) {
+            return true;
+        }
+        UINT sent = SendInput(static_cast<UINT>(inputs.size()), inputs.data(), sizeof(INPUT));
+        if (sent != inputs.size()) {
+            // Blocked (e.g. by UIPI); forget the position so the next batch moves again
+            lastX = lastY = INT_MIN;
+            return false;
+        }
+        return true;
+    }
 
-void SendVRMousePosition(int x, int y) {
-    SetCursorPos(x, y);
-}
-
-void SendVRMouseDown(int x, int y) {
-    SetCursorPos(x, y);
-
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
-    SendInput(1, &input, sizeof(INPUT));
-}
+private:
+    std::vector<INPUT> inputs;
+    int lastX = INT_MIN;
+    int lastY = INT_MIN;
+};
 
-void SendVRMouseUp(int x, int y) {
-    SetCursorPos(x, y);
+} // namespace
 
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dwFlags = MOUSEEVENTF_LEFTUP;
-    SendInput(1, &input, sizeof(INPUT));
+std::unique_ptr<InputBackend> CreateWindowsInputBackend() {
+    return std::make_unique<WindowsInputBackend>();
 }
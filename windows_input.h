@@ -1,12 +1,12 @@
 #ifndef WINDOWS_INPUT_H
 #define WINDOWS_INPUT_H
 
-// Forward declarations - no includes here
-void SendVRLeftClick(int x, int y);
-void SendVRRightClick(int x, int y);
-void SendVRMouseMove(int x, int y);
-void SendVRMousePosition(int x, int y);
-void SendVRMouseDown(int x, int y);
-void SendVRMouseUp(int x, int y);
+#include <memory>
+
+// Forward declarations - no windows.h here
+class InputBackend;
+
+// SendInput backend for InputInjector: one SendInput call per batch, no SetCursorPos
+std::unique_ptr<InputBackend> CreateWindowsInputBackend();
 
 #endif // WINDOWS_INPUT_H